@@ -4,6 +4,7 @@
 // Game lib dependencies
 #include <agk.h>
 #include <common\matrix4.h>
+#include <common\commandbuffer.h>
 #include <2d\spritedata2d.h>
 #include <managers\resourcemanager.h>
 #include <managers\spritemanager.h>
@@ -40,6 +41,43 @@ CSprite2D::~CSprite2D()
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Allocate the sprite from the pool.
+/// </summary>
+/// <param name="size"> Size of the object being allocated. </param>
+/// *************************************************************************
+void * CSprite2D::operator new( size_t size )
+{
+    return GetPool().Allocate( size );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Return the sprite's memory to the pool.
+/// </summary>
+/// <param name="ptr"> Memory of the deleted sprite. </param>
+/// <param name="size"> Size of the object being deleted. </param>
+/// *************************************************************************
+void CSprite2D::operator delete( void * ptr, size_t size )
+{
+    GetPool().Free( ptr, size );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the pool the 2D sprites are allocated from.
+/// </summary>
+/// *************************************************************************
+CObjectPool<CSprite2D> & CSprite2D::GetPool()
+{
+    static CObjectPool<CSprite2D> pool;
+    return pool;
+}
+
+
 /// *************************************************************************
 /// <summary>
 /// Get the name of the sprite.
@@ -76,49 +114,69 @@ void CSprite2D::Init( const std::string & name )
     if( pVisual )
     {
         // Create the sprite using the texture map name. No name suggests a solid color.
-        int imageId = CResourceManager::Instance().LoadImage( pVisual->GetTextureMap() );
+        _imageName = pVisual->GetTextureMap();
+        int imageId = CResourceManager::Instance().Acquire( NDefs::ERT_IMAGE, _imageName );
         _id = agk::CreateSprite( imageId );
 
         // Set the sprite color.
         SetColor( pVisual->GetColor() );
 
-        // Handle the sprite size, if its set in the data.
-        if( pVisual->IsSizeSet() )
+        // The first sprite of the name works out its size and records it in the
+        // data. The rest take it from there and only pass it to AGK if it differs
+        // from the image's.
+        if( pVisual->IsSizeResolved() )
         {
             _size = pVisual->GetSize();
 
-            // If the size is different from the file's, set the size in AGK.
-            if( !pVisual->IsSizeSameAsFile() )
+            if( pVisual->IsResizeNeeded() )
+                agk::SetSpriteSize( _id, _size.w, _size.h );
+        }
+        else
+        {
+            bool resize = false;
+
+            // Handle the sprite size, if its set in the data.
+            if( pVisual->IsSizeSet() )
             {
-                // If both width and height are set, set the sprite size.
-                if( _size.w > 0 && _size.h > 0 )
-                    agk::SetSpriteSize( _id, _size.w, _size.h );
-                // If only the width is set, calculate the height.
-                else if( _size.w > 0 )
-                {
-                    float ratio = _size.w / agk::GetSpriteWidth( _id );
-                    _size.h *= ratio;
-                    agk::SetSpriteSize( _id, _size.w, _size.h );
-                }
-                // If only the height is set, calculate the width.
-                else if( _size.h > 0 )
+                _size = pVisual->GetSize();
+
+                // If the size is different from the file's, set the size in AGK.
+                if( !pVisual->IsSizeSameAsFile() )
                 {
-                    float ratio = _size.h / agk::GetSpriteHeight( _id );
-                    _size.w *= ratio;
-                    agk::SetSpriteSize( _id, _size.w, _size.h );
+                    // If both width and height are set, set the sprite size.
+                    if( _size.w > 0 && _size.h > 0 )
+                        resize = true;
+                    // If only the width is set, calculate the height.
+                    else if( _size.w > 0 )
+                    {
+                        float ratio = _size.w / agk::GetSpriteWidth( _id );
+                        _size.h *= ratio;
+                        resize = true;
+                    }
+                    // If only the height is set, calculate the width.
+                    else if( _size.h > 0 )
+                    {
+                        float ratio = _size.h / agk::GetSpriteHeight( _id );
+                        _size.w *= ratio;
+                        resize = true;
+                    }
+
+                    if( resize )
+                        agk::SetSpriteSize( _id, _size.w, _size.h );
                 }
             }
-        }
-        else
-        {
-            // If the data does not have a default size, set it to whatever the created sprite's size is.
-            pVisual->SetSize( GetWorldSize() );
-            _size = pVisual->GetSize();
+            else
+            {
+                // If the data does not have a default size, set it to whatever the created sprite's size is.
+                _size = CVector3<float>( agk::GetSpriteWidth( _id ), agk::GetSpriteHeight( _id ) );
+            }
+
+            pVisual->SetResolvedSize( _size, resize );
         }
     }
 
     if( _pData->GetAnimationList().size() > 0 )
-        _pAnimationComponent = new CAnimationComponent(this, _pData->GetAnimationList() );
+        CreateAnimationComponent( _pData->GetAnimationList() );
 
     _alignment = _pData->GetAlignment();
 }
@@ -147,8 +205,13 @@ void CSprite2D::DeleteObject()
 {
     if( _id > 0 )
     {
+        CCommandBuffer::Instance().Discard( CCommandBuffer::SPRITE, _id );
         agk::DeleteSprite( _id );
 
+        // Let go of the image so it can be evicted once nothing else uses it.
+        CResourceManager::Instance().Release( NDefs::ERT_IMAGE, _imageName );
+        _imageName.clear();
+
         _id = 0;
     }
 }
@@ -194,15 +257,8 @@ const CSpriteData2D * CSprite2D::GetData() const
 /// *************************************************************************
 void CSprite2D::ApplyPosition()
 {
-    if( _pParent )
-    {
-        CVector2<float> newPos = *_pParent->GetMatrix() * _position;
-        agk::SetSpritePosition( _id, newPos.x, newPos.y );
-    }
-    else
-        agk::SetSpritePosition( _id, _position.x, _position.y );
-
-    agk::SetSpriteDepth( _id, (int)(_position.z + 0.5f) );
+    CCommandBuffer::Instance().Add( CCommandBuffer::SPRITE_POSITION, _id, _worldPosition.x, _worldPosition.y );
+    CCommandBuffer::Instance().Add( CCommandBuffer::SPRITE_DEPTH, _id, (int)(_position.z + 0.5f) );
 }
 
 
@@ -213,12 +269,7 @@ void CSprite2D::ApplyPosition()
 /// *************************************************************************
 void CSprite2D::ApplyRotation()
 {
-    _rotation %= 360;
-
-    if( _pParent )
-        agk::SetSpriteAngle( _id, _pParent->GetWorldRot().z + _rotation.z );
-    else
-        agk::SetSpriteAngle( _id, _rotation.z );
+    CCommandBuffer::Instance().Add( CCommandBuffer::SPRITE_ANGLE, _id, _worldRotation.z );
 }
 
 
@@ -229,13 +280,7 @@ void CSprite2D::ApplyRotation()
 /// *************************************************************************
 void CSprite2D::ApplyScale()
 {
-    if( _pParent )
-    {
-        CVector2<float> newScale = _pParent->GetWorldScale() * _scale;
-        agk::SetSpriteScale( _id, newScale.w, newScale.h );
-    }
-    else
-        agk::SetSpriteScale( _id, _scale.w, _scale.h );
+    CCommandBuffer::Instance().Add( CCommandBuffer::SPRITE_SCALE, _id, _worldScale.w, _worldScale.h );
 }
 
 
@@ -246,16 +291,11 @@ void CSprite2D::ApplyScale()
 /// *************************************************************************
 void CSprite2D::ApplyColor()
 {
-    if( _pParent )
-    {
-        CVector2<float> newScale = _pParent->GetWorldScale() * _scale;
-        agk::SetSpriteScale( _id, newScale.w, newScale.h );
-    }
-    else
-        agk::SetSpriteColor( _id, (int)(_color.r * 255 + 0.5f),
-                                  (int)(_color.g * 255 + 0.5f),
-                                  (int)(_color.b * 255 + 0.5f),
-                                  (int)(_color.a * 255 + 0.5f) );
+    CCommandBuffer::Instance().Add( CCommandBuffer::SPRITE_COLOR, _id,
+                                    (int)(_worldColor.r * 255 + 0.5f),
+                                    (int)(_worldColor.g * 255 + 0.5f),
+                                    (int)(_worldColor.b * 255 + 0.5f),
+                                    (int)(_worldColor.a * 255 + 0.5f) );
 }
 
 
@@ -266,46 +306,43 @@ void CSprite2D::ApplyColor()
 /// *************************************************************************
 void CSprite2D::ApplyVisibility()
 {
-    if( _pParent )
-        agk::SetSpriteVisible( _id, _pParent->IsVisible() && _visible );
-    else
-        agk::SetSpriteVisible( _id, _visible );
+    CCommandBuffer::Instance().Add( CCommandBuffer::SPRITE_VISIBLE, _id, _worldVisible );
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Get the current position set in AGK.
+/// Get the world position. The depth isn't affected by the parent.
 /// </summary>
 /// *************************************************************************
 CVector3<float> CSprite2D::GetWorldPos() const
 {
-    return CVector3<float>( agk::GetSpriteX( _id ), 
-                            agk::GetSpriteY( _id ), 
-                            (float)agk::GetSpriteDepth( _id ) );
+    return CVector3<float>( _worldPosition.x, _worldPosition.y, _position.z );
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Get the current rotation set in AGK.
+/// Get the current world rotation.
 /// </summary>
 /// *************************************************************************
 CVector3<float> CSprite2D::GetWorldRot() const
 {
-    return CVector3<float>( 0, 0, agk::GetSpriteAngle( _id ) );
+    return CVector3<float>( 0, 0, _worldRotation.z );
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Get the current size set in AGK.
+/// Get the world size.
 /// </summary>
 /// *************************************************************************
 CVector3<float> CSprite2D::GetWorldSize() const
 {
-    return CVector3<float>( agk::GetSpriteWidth( _id ), 
-                            agk::GetSpriteHeight( _id ) );
+    if( _pParent )
+        return _size * _pParent->GetWorldScale();
+
+    return _size;
 }
 
 
@@ -331,16 +368,6 @@ void CSprite2D::UpdateScale()
 }
 
 
-/// *************************************************************************
-/// <summary>
-/// Get the sprite's visibility.
-/// </summary>
-/// *************************************************************************
-bool CSprite2D::IsVisible() const
-{
-    return agk::GetSpriteVisible( _id );
-}
-
 
 /// *************************************************************************
 /// <summary>
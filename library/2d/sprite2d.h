@@ -6,6 +6,7 @@
 
 // Game lib dependencies
 #include <common\defs.h>
+#include <utilities\objectpool.h>
 #include <common\vector2.h>
 #include <common\vector3.h>
 #include <common\bitmask.h>
@@ -30,6 +31,13 @@ public:
     CSprite2D( const std::string & name );
     ~CSprite2D();
 
+    // Allocate and free the sprite using the pool.
+    static void * operator new( size_t size );
+    static void operator delete( void * ptr, size_t size );
+
+    // Get the pool the sprites are allocated from.
+    static CObjectPool<CSprite2D> & GetPool();
+
     // Get the name of the sprite.
     virtual const std::string & GetName() const;
 
@@ -46,7 +54,7 @@ public:
     // Get the data used to create the sprite.
     const CSpriteData2D * GetData() const;
 
-    // Get the current transformation data set in AGK.
+    // Get the world-space transformation data as of the last transform.
     virtual CVector3<float> GetWorldPos() const;
     virtual CVector3<float> GetWorldRot() const;
     virtual CVector3<float> GetWorldSize() const;
@@ -55,9 +63,6 @@ public:
     virtual void UpdateSize();
     virtual void UpdateScale();
 
-    // Get the sprite's visibility.
-    virtual bool IsVisible() const;
-
     // Access functions for the sprite's alignment.
     virtual void SetAlignment( const CBitmask<uint> & alignment );
     virtual CBitmask<uint> GetAlignment() const;
@@ -82,6 +87,10 @@ protected:
     // Sprite data this sprite is based off of. The sprite does not own this.
     const CSpriteData2D * _pData = nullptr;
 
+    // Name of the image the sprite was created with, kept so it can be released
+    // after the sprite is marked for deletion.
+    std::string _imageName;
+
     // The window alignment of the sprite.
     CBitmask<uint> _alignment = NDefs::EA_CENTER;
 };
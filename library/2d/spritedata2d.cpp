@@ -4,6 +4,7 @@
 // Game lib dependencies
 #include <utilities\deletefuncs.h>
 #include <utilities\exceptionhandling.h>
+#include <utilities\binarydata.h>
 
 using namespace std;
 using namespace nlohmann;
@@ -51,6 +52,50 @@ void CSpriteData2D::LoadFromIter( const string & name, json::const_iterator iter
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Write the sprite data to compiled data, in the order Read() reads it.
+/// </summary>
+/// <param name="writer"> Writer of the compiled data. </param>
+/// *************************************************************************
+void CSpriteData2D::Write( CBinaryWriter & writer ) const
+{
+    writer.Write( _pVisualData != nullptr );
+    if( _pVisualData )
+        _pVisualData->Write( writer );
+
+    writer.Write( (uint)_alignment );
+    writer.Write( _animationList );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Read the sprite data from compiled data.
+/// </summary>
+/// <param name="name"> Name of the data. </param>
+/// <param name="reader"> Reader of the compiled data. </param>
+/// *************************************************************************
+void CSpriteData2D::Read( const std::string & name, CBinaryReader & reader )
+{
+    _name = name;
+
+    bool hasVisual;
+    reader.Read( hasVisual );
+    if( hasVisual )
+    {
+        _pVisualData = new CSpriteVisualData2D();
+        _pVisualData->Read( reader );
+    }
+
+    uint alignment;
+    reader.Read( alignment );
+    _alignment = alignment;
+
+    reader.Read( _animationList );
+}
+
+
 /// *************************************************************************
 /// <summary>
 /// Get the visual data of the sprite.
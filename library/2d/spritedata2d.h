@@ -11,6 +11,8 @@
 #include <vector>
 
 // Forward declarations
+class CBinaryWriter;
+class CBinaryReader;
 class CSpriteVisualData2D;
 
 /// *************************************************************************
@@ -28,6 +30,12 @@ public:
     // Load the sprite data from the passed in iterator.
     void LoadFromIter( const std::string & name, nlohmann::json::const_iterator iter );
 
+    // Write the sprite data to compiled data.
+    void Write( CBinaryWriter & writer ) const;
+
+    // Read the sprite data from compiled data.
+    void Read( const std::string & name, CBinaryReader & reader );
+
     // Access functions for the sprite data.
     CSpriteVisualData2D * GetVisualData() const;
     CSpriteVisualData2D * GetVisualData();
@@ -1,6 +1,9 @@
 // Physical component dependency
 #include "spritevisualdata2d.h"
 
+// Game lib dependencies
+#include <utilities\binarydata.h>
+
 
 /// *************************************************************************
 /// <summary> 
@@ -42,6 +45,38 @@ void CSpriteVisualData2D::LoadFromIter( nlohmann::json::const_iterator iter )
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Write the visual sprite data to compiled data, in the order Read() reads it.
+/// </summary>
+/// <param name="writer"> Writer of the compiled data. </param>
+/// *************************************************************************
+void CSpriteVisualData2D::Write( CBinaryWriter & writer ) const
+{
+    writer.Write( _color );
+    writer.Write( _textureMap );
+    writer.Write( _size );
+    writer.Write( _sizeSet );
+    writer.Write( _sizeSameAsFile );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Read the visual sprite data from compiled data.
+/// </summary>
+/// <param name="reader"> Reader of the compiled data. </param>
+/// *************************************************************************
+void CSpriteVisualData2D::Read( CBinaryReader & reader )
+{
+    reader.Read( _color );
+    reader.Read( _textureMap );
+    reader.Read( _size );
+    reader.Read( _sizeSet );
+    reader.Read( _sizeSameAsFile );
+}
+
+
 /// *************************************************************************
 /// <summary> 
 /// Get the sprite's default color.
@@ -111,4 +146,42 @@ bool CSpriteVisualData2D::IsSizeSet() const
 bool CSpriteVisualData2D::IsSizeSameAsFile() const
 {
     return _sizeSameAsFile;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Record the size the first sprite worked out, so the sprites created after
+/// it don't have to ask AGK for the image's size.
+/// </summary>
+/// <param name="size"> Size of the sprite. </param>
+/// <param name="resize"> Whether the size differs from the image's. </param>
+/// *************************************************************************
+void CSpriteVisualData2D::SetResolvedSize( const CVector2<float> & size, bool resize )
+{
+    _size = size;
+    _sizeResolved = true;
+    _resizeNeeded = resize;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Whether the first sprite has recorded its size.
+/// </summary>
+/// *************************************************************************
+bool CSpriteVisualData2D::IsSizeResolved() const
+{
+    return _sizeResolved;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Whether the recorded size differs from the image's.
+/// </summary>
+/// *************************************************************************
+bool CSpriteVisualData2D::IsResizeNeeded() const
+{
+    return _resizeNeeded;
 }
\ No newline at end of file
@@ -9,6 +9,10 @@
 // Standard lib dependencies
 #include <string>
 
+// Forward declarations
+class CBinaryWriter;
+class CBinaryReader;
+
 /// *************************************************************************
 /// <summary> 
 /// Class containing the default creation data for a 2D sprite's visual
@@ -25,6 +29,12 @@ public:
     // Load the visual sprite data from the passed in iterator.
     void LoadFromIter( nlohmann::json::const_iterator iter );
 
+    // Write the visual sprite data to compiled data.
+    void Write( CBinaryWriter & writer ) const;
+
+    // Read the visual sprite data from compiled data.
+    void Read( CBinaryReader & reader );
+
     // Access functions for the visual sprite data.
     const CVector4<float> & GetColor() const;
     const std::string & GetTextureMap() const;
@@ -39,6 +49,15 @@ public:
     // Whether or not the size is the same as the file.
     bool IsSizeSameAsFile() const;
 
+    // Record the size the first sprite worked out, and whether it had to be passed to AGK.
+    void SetResolvedSize( const CVector2<float> & size, bool resize );
+
+    // Whether the first sprite has recorded its size.
+    bool IsSizeResolved() const;
+
+    // Whether the recorded size differs from the image's, so AGK needs to be told.
+    bool IsResizeNeeded() const;
+
 private:
 
     // Initial color of the sprite.
@@ -55,6 +74,11 @@ private:
 
     // Whether or not the size is the same as the file.
     bool _sizeSameAsFile = false;
+
+    // Whether the first sprite has recorded its size, and whether that size
+    // has to be passed to AGK. Not part of the compiled data.
+    bool _sizeResolved = false;
+    bool _resizeNeeded = false;
 };
 
 #endif  // __sprite_visual_data_2d_h__
@@ -4,6 +4,7 @@
 // Game lib dependencies
 #include <agk.h>
 #include <common\matrix4.h>
+#include <common\commandbuffer.h>
 #include <2d\textspritedata.h>
 #include <managers\resourcemanager.h>
 #include <managers\spritemanager.h>
@@ -39,6 +40,43 @@ CTextSprite::~CTextSprite()
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Allocate the sprite from the pool.
+/// </summary>
+/// <param name="size"> Size of the object being allocated. </param>
+/// *************************************************************************
+void * CTextSprite::operator new( size_t size )
+{
+    return GetPool().Allocate( size );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Return the sprite's memory to the pool.
+/// </summary>
+/// <param name="ptr"> Memory of the deleted sprite. </param>
+/// <param name="size"> Size of the object being deleted. </param>
+/// *************************************************************************
+void CTextSprite::operator delete( void * ptr, size_t size )
+{
+    GetPool().Free( ptr, size );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the pool the text sprites are allocated from.
+/// </summary>
+/// *************************************************************************
+CObjectPool<CTextSprite> & CTextSprite::GetPool()
+{
+    static CObjectPool<CTextSprite> pool;
+    return pool;
+}
+
+
 /// *************************************************************************
 /// <summary>
 /// Get the name of the sprite.
@@ -70,19 +108,35 @@ void CTextSprite::Init( const std::string & name, const string & text )
     Clear();
 
     _pData = pData;
-    _text = text;
-    _id = agk::CreateText( text.c_str() );
+
+    // The text is created empty and only given its string once the font and
+    // spacing are set, since AGK lays the text out again on each of those calls.
+    _id = agk::CreateText( "" );
     
     if( _id > 0 )
     {
-        SetFont( CResourceManager::Instance().LoadFont( _pData->GetFont() ) );
-        SetTextSpacing( _pData->GetTextSpacing() );
-        SetLineSpacing( _pData->GetLineSpacing() );
+        // A new text already has AGK's defaults, so only pass on what differs.
+        _fontName = _pData->GetFont();
+        uint fontId = CResourceManager::Instance().Acquire( NDefs::ERT_FONT, _fontName );
+        if( fontId > 0 )
+            SetFont( fontId );
+
+        if( _pData->GetTextSpacing() != 0 )
+            SetTextSpacing( _pData->GetTextSpacing() );
+
+        if( _pData->GetLineSpacing() != 0 )
+            SetLineSpacing( _pData->GetLineSpacing() );
+
+        if( _pData->GetMaxWidth() != 0 )
+            SetMaxWidth( _pData->GetMaxWidth() );
+
+        if( _pData->GetTextAlignment() != NDefs::ETA_LEFT )
+            SetTextAlignment( _pData->GetTextAlignment() );
+
         SetTextSize( _pData->GetSize() );
-        SetMaxWidth( _pData->GetMaxWidth() );
         SetColor( _pData->GetColor() );
-        SetTextAlignment( _pData->GetTextAlignment() );
         SetAlignment( _pData->GetAlignment() );
+        SetText( text );
     }
 }
 
@@ -125,7 +179,12 @@ void CTextSprite::DeleteObject()
 {
     if( _id > 0 )
     {
+        CCommandBuffer::Instance().Discard( CCommandBuffer::TEXT, _id );
         agk::DeleteText( _id );
+
+        // Let go of the font so it can be evicted once nothing else uses it.
+        CResourceManager::Instance().Release( NDefs::ERT_FONT, _fontName );
+        _fontName.clear();
         _id = 0;
     }
 }
@@ -160,15 +219,8 @@ bool CTextSprite::IsMarkedForDeletion() const
 /// *************************************************************************
 void CTextSprite::ApplyPosition()
 {
-    if( _pParent )
-    {
-        CVector2<float> newPos = *_pParent->GetMatrix() * _position;
-        agk::SetTextPosition( _id, newPos.x, newPos.y );
-    }
-    else
-        agk::SetTextPosition( _id, _position.x, _position.y );
-
-    agk::SetTextDepth( _id, (int)(_position.z + 0.5f) );
+    CCommandBuffer::Instance().Add( CCommandBuffer::TEXT_POSITION, _id, _worldPosition.x, _worldPosition.y );
+    CCommandBuffer::Instance().Add( CCommandBuffer::TEXT_DEPTH, _id, (int)(_position.z + 0.5f) );
 }
 
 
@@ -179,26 +231,20 @@ void CTextSprite::ApplyPosition()
 /// *************************************************************************
 void CTextSprite::ApplyRotation()
 {
-    _rotation %= 360;
-
-    if( _pParent )
-        agk::SetTextAngle( _id, _pParent->GetWorldRot().z + _rotation.z );
-    else
-        agk::SetTextAngle( _id, _rotation.z );
+    CCommandBuffer::Instance().Add( CCommandBuffer::TEXT_ANGLE, _id, _worldRotation.z );
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Update AGK with the sprite's current scale.
+/// Update AGK with the sprite's current scale. The text is measured at this
+/// size, so it's given to AGK now instead of waiting in the command buffer.
 /// </summary>
 /// *************************************************************************
 void CTextSprite::ApplyScale()
 {
-    if( _pParent )
-        agk::SetTextSize( _id, _size.x * _pParent->GetWorldScale().x );
-    else
-        agk::SetTextSize( _id, _size.x );
+    agk::SetTextSize( _id, GetWorldTextSize() );
+    _worldSizeChanged = true;
 }
 
 
@@ -209,10 +255,11 @@ void CTextSprite::ApplyScale()
 /// *************************************************************************
 void CTextSprite::ApplyColor()
 {
-    agk::SetTextColor( _id, (int)(_color.r * 255 + 0.5f),
-                            (int)(_color.g * 255 + 0.5f),
-                            (int)(_color.b * 255 + 0.5f),
-                            (int)(_color.a * 255 + 0.5f) );
+    CCommandBuffer::Instance().Add( CCommandBuffer::TEXT_COLOR, _id,
+                                    (int)(_worldColor.r * 255 + 0.5f),
+                                    (int)(_worldColor.g * 255 + 0.5f),
+                                    (int)(_worldColor.b * 255 + 0.5f),
+                                    (int)(_worldColor.a * 255 + 0.5f) );
 }
 
 
@@ -223,83 +270,92 @@ void CTextSprite::ApplyColor()
 /// *************************************************************************
 void CTextSprite::ApplyVisibility()
 {
-    if( _pParent )
-        agk::SetTextVisible( _id, _pParent->IsVisible() && _visible );
-    else
-        agk::SetTextVisible( _id, _visible );
+    CCommandBuffer::Instance().Add( CCommandBuffer::TEXT_VISIBLE, _id, _worldVisible );
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Get the current position set in AGK.
+/// Get the world position. The depth isn't affected by the parent.
 /// </summary>
 /// *************************************************************************
 CVector3<float> CTextSprite::GetWorldPos() const
 {
-    return CVector3<float>( agk::GetTextX( _id ),
-                            agk::GetTextY( _id ),
-                            (float)agk::GetTextDepth( _id ) );
+    return CVector3<float>( _worldPosition.x, _worldPosition.y, _position.z );
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Get the current rotation set in AGK.
+/// Get the current world rotation.
 /// </summary>
 /// *************************************************************************
 CVector3<float> CTextSprite::GetWorldRot() const
 {
-    return _rotation;
+    return CVector3<float>( 0, 0, _worldRotation.z );
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Get the current size set in AGK.
+/// Get the total width and height of the text and the text size, as of the
+/// last transform. Measured by AGK only when the text or anything affecting
+/// its size has changed.
 /// </summary>
 /// *************************************************************************
 CVector3<float> CTextSprite::GetWorldSize() const
 {
-    return CVector3<float>( agk::GetTextTotalWidth( _id ),
-                            agk::GetTextTotalHeight( _id ),
-                            agk::GetTextSize( _id ) );
+    if( _worldSizeChanged )
+    {
+        _worldSize = CVector3<float>( agk::GetTextTotalWidth( _id ),
+                                      agk::GetTextTotalHeight( _id ),
+                                      agk::GetTextSize( _id ) );
+        _worldSizeChanged = false;
+    }
+
+    return _worldSize;
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Update the sprite's size using the scale.
+/// Get the text size with the parent's scale applied.
 /// </summary>
 /// *************************************************************************
-void CTextSprite::UpdateSize()
+float CTextSprite::GetWorldTextSize() const
 {
-    _size.x = _pData->GetSize() * _scale.x;
+    if( _pParent )
+        return _size.x * _pParent->GetWorldScale().x;
+
+    return _size.x;
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Update the sprite's scale using the size.
+/// Update the sprite's size using the scale.
 /// </summary>
 /// *************************************************************************
-void CTextSprite::UpdateScale()
+void CTextSprite::UpdateSize()
 {
-    _scale.x = _size.x / _pData->GetSize();
+    _size.x = _pData->GetSize() * _scale.x;
+    _worldSizeChanged = true;
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Get the text sprite's visibility.
+/// Update the sprite's scale using the size.
 /// </summary>
 /// *************************************************************************
-bool CTextSprite::IsVisible() const
+void CTextSprite::UpdateScale()
 {
-    return agk::GetTextVisible( _id );
+    _scale.x = _size.x / _pData->GetSize();
+    _worldSizeChanged = true;
 }
 
 
+
 /// *************************************************************************
 /// <summary>
 /// Set the text sprite's font.
@@ -309,6 +365,7 @@ void CTextSprite::SetFont( uint fontId )
 {
     _fontId = fontId;
     agk::SetTextFont( _id, fontId );
+    _worldSizeChanged = true;
 }
 
 
@@ -332,6 +389,7 @@ void CTextSprite::SetText( const string & text )
 {
     _text = text;
     agk::SetTextString( _id, text.c_str() );
+    _worldSizeChanged = true;
 }
 
 
@@ -376,6 +434,7 @@ float CTextSprite::GetTextSize() const
 void CTextSprite::SetTextSpacing( float textSpacing )
 {
     agk::SetTextSpacing( _id, textSpacing );
+    _worldSizeChanged = true;
 }
 
 
@@ -398,6 +457,7 @@ float CTextSprite::GetTextSpacing() const
 void CTextSprite::SetLineSpacing( float lineSpacing )
 {
     agk::SetTextLineSpacing( _id, lineSpacing );
+    _worldSizeChanged = true;
 }
 
 
@@ -421,6 +481,7 @@ void CTextSprite::SetMaxWidth( float maxWidth )
 {
     _maxWidth = maxWidth;
     agk::SetTextMaxWidth( _id, maxWidth );
+    _worldSizeChanged = true;
 }
 
 
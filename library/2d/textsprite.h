@@ -6,6 +6,7 @@
 
 // Game lib dependencies
 #include <common\defs.h>
+#include <utilities\objectpool.h>
 #include <common\vector2.h>
 #include <common\vector3.h>
 #include <common\bitmask.h>
@@ -28,6 +29,13 @@ public:
     CTextSprite( const std::string & name, const std::string & text );
     ~CTextSprite();
 
+    // Allocate and free the sprite using the pool.
+    static void * operator new( size_t size );
+    static void operator delete( void * ptr, size_t size );
+
+    // Get the pool the sprites are allocated from.
+    static CObjectPool<CTextSprite> & GetPool();
+
     // Get the name of the sprite.
     virtual const std::string & GetName() const;
 
@@ -47,7 +55,7 @@ public:
     // Get the data used to create the sprite.
     const CTextSpriteData * GetData() const;
 
-    // Get the current transformation data set in AGK.
+    // Get the world-space transformation data as of the last transform.
     virtual CVector3<float> GetWorldPos() const;
     virtual CVector3<float> GetWorldRot() const;
     virtual CVector3<float> GetWorldSize() const;
@@ -56,9 +64,6 @@ public:
     virtual void UpdateSize();
     virtual void UpdateScale();
 
-    // Access functions for the sprite's visibility.
-    virtual bool IsVisible() const;
-
     // Access functions for the text sprite's font.
     virtual void SetFont( uint fontId );
     virtual uint GetFont() const;
@@ -96,6 +101,9 @@ public:
 
 protected:
 
+    // Get the text size with the parent's scale applied.
+    float GetWorldTextSize() const;
+
     // Apply changes to AGK.
     virtual void ApplyPosition();
     virtual void ApplyRotation();
@@ -110,6 +118,10 @@ protected:
 
     // ID of the font used.
     uint _fontId = 0;
+
+    // Name of the font the sprite was created with, kept so it can be released
+    // after the sprite is marked for deletion.
+    std::string _fontName;
     
     // Text sprite's max width before text begins to wrap.
     float _maxWidth = 0;
@@ -122,6 +134,10 @@ protected:
 
     // Text displayed by the sprite.
     std::string _text;
+
+    // Size of the text measured by AGK, and whether it needs measuring again.
+    mutable CVector3<float> _worldSize;
+    mutable bool _worldSizeChanged = true;
 };
 
 
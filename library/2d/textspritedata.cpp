@@ -3,6 +3,7 @@
 
 // Game lib dependencies
 #include <utilities\deletefuncs.h>
+#include <utilities\binarydata.h>
 
 using namespace std;
 using namespace nlohmann;
@@ -49,6 +50,53 @@ void CTextSpriteData::LoadFromIter( const string & name, json::const_iterator it
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Write the text sprite data to compiled data, in the order Read() reads it.
+/// </summary>
+/// <param name="writer"> Writer of the compiled data. </param>
+/// *************************************************************************
+void CTextSpriteData::Write( CBinaryWriter & writer ) const
+{
+    writer.Write( _font );
+    writer.Write( _size );
+    writer.Write( _textSpacing );
+    writer.Write( _lineSpacing );
+    writer.Write( _maxWidth );
+    writer.Write( _color );
+    writer.Write( _textAlignment );
+    writer.Write( (uint)_alignment );
+    writer.Write( _animationList );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Read the text sprite data from compiled data.
+/// </summary>
+/// <param name="name"> Name of the data. </param>
+/// <param name="reader"> Reader of the compiled data. </param>
+/// *************************************************************************
+void CTextSpriteData::Read( const std::string & name, CBinaryReader & reader )
+{
+    _name = name;
+
+    uint alignment;
+
+    reader.Read( _font );
+    reader.Read( _size );
+    reader.Read( _textSpacing );
+    reader.Read( _lineSpacing );
+    reader.Read( _maxWidth );
+    reader.Read( _color );
+    reader.Read( _textAlignment );
+    reader.Read( alignment );
+    reader.Read( _animationList );
+
+    _alignment = alignment;
+}
+
+
 /// *************************************************************************
 /// <summary> 
 /// Get the name of the text sprite.
@@ -11,6 +11,10 @@
 #include <string>
 #include <vector>
 
+// Forward declarations
+class CBinaryWriter;
+class CBinaryReader;
+
 /// *************************************************************************
 /// <summary>
 /// Class containing the default creation data for a text sprite.
@@ -26,6 +30,12 @@ public:
     // Load the sprite data from the passed in iterator.
     void LoadFromIter( const std::string & name, nlohmann::json::const_iterator iter );
 
+    // Write the text sprite data to compiled data.
+    void Write( CBinaryWriter & writer ) const;
+
+    // Read the text sprite data from compiled data.
+    void Read( const std::string & name, CBinaryReader & reader );
+
     // Access functions for the text sprite data.
     const std::string & GetName() const;
     const std::string & GetFont() const;
@@ -4,6 +4,7 @@
 // Game lib dependencies
 #include <agk.h>
 #include <common\matrix4.h>
+#include <common\commandbuffer.h>
 #include <3d\spritedata3d.h>
 #include <managers\resourcemanager.h>
 #include <managers\spritemanager.h>
@@ -39,6 +40,43 @@ CSprite3D::~CSprite3D()
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Allocate the sprite from the pool.
+/// </summary>
+/// <param name="size"> Size of the object being allocated. </param>
+/// *************************************************************************
+void * CSprite3D::operator new( size_t size )
+{
+    return GetPool().Allocate( size );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Return the sprite's memory to the pool.
+/// </summary>
+/// <param name="ptr"> Memory of the deleted sprite. </param>
+/// <param name="size"> Size of the object being deleted. </param>
+/// *************************************************************************
+void CSprite3D::operator delete( void * ptr, size_t size )
+{
+    GetPool().Free( ptr, size );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the pool the 3D sprites are allocated from.
+/// </summary>
+/// *************************************************************************
+CObjectPool<CSprite3D> & CSprite3D::GetPool()
+{
+    static CObjectPool<CSprite3D> pool;
+    return pool;
+}
+
+
 /// *************************************************************************
 /// <summary>
 /// Get the name of the sprite.
@@ -69,137 +107,163 @@ void CSprite3D::Init( const std::string & name )
     Clear();
 
     _pData = pData;
+    _quaternionMode = _pData->IsQuaternion();
+
     CSpriteVisualData3D * pVisual = _pData->GetVisualData();
 
     if( pVisual )
     {
-        switch( pVisual->GetType() )
+        // The first sprite of the name is built from the data and kept, hidden, as
+        // the prototype. Every sprite is cloned from it, which copies the mesh,
+        // shadow flags and permanent scale in a single AGK call.
+        if( pVisual->GetPrototypeId() == 0 )
+            CreatePrototype( pVisual );
+
+        if( pVisual->GetPrototypeId() > 0 )
+        {
+            _id = agk::CloneObject( pVisual->GetPrototypeId() );
+            agk::SetObjectVisible( _id, 1 );
+            agk::SetObjectCollisionMode( _id, 1 );
+
+            AcquireResources( pVisual );
+
+            _size = pVisual->GetSize();
+
+            // Set the sprite's color.
+            SetColor( pVisual->GetColor() );
+        }
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Build the AGK object the sprites of the data are cloned from. It's hidden
+/// and ignored by collisions. The prototype holds no resources: a mesh is
+/// copied into it and then evicted, and the images are left for each clone
+/// to set, so only sprites that exist keep their images loaded.
+/// </summary>
+/// <param name="pVisual"> Visual data to build the object from. </param>
+/// *************************************************************************
+void CSprite3D::CreatePrototype( CSpriteVisualData3D * pVisual )
+{
+    switch( pVisual->GetType() )
+    {
+        // Boxes must have a width, height, and length.
+    case EMT_BOX:
+        if( pVisual->GetWidth() > 0 && pVisual->GetHeight() > 0 && pVisual->GetDepth() > 0 )
+            _id = agk::CreateObjectBox( pVisual->GetWidth(), pVisual->GetHeight(), pVisual->GetDepth() );
+        break;
+
+        // Cones must have a height, radius, and at least 3 columns.
+    case EMT_CONE:
+        if( pVisual->GetHeight() > 0 && pVisual->GetRadius() > 0 && pVisual->GetColumns() > 2 )
+            _id = agk::CreateObjectCone( pVisual->GetHeight(), pVisual->GetDiameter(), pVisual->GetColumns() );
+        break;
+
+        // Cylinders must have a height, radius, and at least 3 columns.
+    case EMT_CYLINDER:
+        if( pVisual->GetHeight() > 0 && pVisual->GetRadius() > 0 && pVisual->GetColumns() > 2 )
+            _id = agk::CreateObjectCylinder( pVisual->GetHeight(), pVisual->GetDiameter(), pVisual->GetColumns() );
+        break;
+
+        // Capsules must have a radius and height.
+    case EMT_CAPSULE:
+        if( pVisual->GetRadius() > 0 && pVisual->GetHeight() > 0 )
+            _id = agk::CreateObjectCapsule( pVisual->GetDiameter(), pVisual->GetHeight(), Y_AXIS );
+        break;
+
+        // Planes must have a width and height.
+    case EMT_PLANE:
+        if( pVisual->GetWidth() > 0 && pVisual->GetHeight() > 0 )
+            _id = agk::CreateObjectPlane( pVisual->GetWidth(), pVisual->GetHeight() );
+        break;
+
+        // Spheres must have a radius, at least 2 rows, and at least 3 columns.
+    case EMT_SPHERE:
+        if( pVisual->GetRadius() > 0 && pVisual->GetRows() > 1 && pVisual->GetColumns() > 2 )
+            _id = agk::CreateObjectSphere( pVisual->GetDiameter(), pVisual->GetRows(), pVisual->GetColumns() );
+        break;
+
+        // Meshes must have a name. The prototype has its own copy of the mesh,
+        // so the loaded one isn't needed once it's cloned.
+    case EMT_MESH:
+        if( !pVisual->GetMesh().empty() )
         {
-            // Boxes must have a width, height, and length.
-        case EMT_BOX:
-            if( pVisual->GetWidth() > 0 && pVisual->GetHeight() > 0 && pVisual->GetDepth() > 0 )
-                _id = agk::CreateObjectBox( pVisual->GetWidth(), pVisual->GetHeight(), pVisual->GetDepth() );
-            break;
-
-            // Cones must have a height, radius, and at least 3 columns.
-        case EMT_CONE:
-            if( pVisual->GetHeight() > 0 && pVisual->GetRadius() > 0 && pVisual->GetColumns() > 2 )
-                _id = agk::CreateObjectCone( pVisual->GetHeight(), pVisual->GetDiameter(), pVisual->GetColumns() );
-            break;
-
-            // Cylinders must have a height, radius, and at least 3 columns.
-        case EMT_CYLINDER:
-            if( pVisual->GetHeight() > 0 && pVisual->GetRadius() > 0 && pVisual->GetColumns() > 2 )
-                _id = agk::CreateObjectCylinder( pVisual->GetHeight(), pVisual->GetDiameter(), pVisual->GetColumns() );
-            break;
-
-            // Capsules must have a radius and height.
-        case EMT_CAPSULE:
-            if( pVisual->GetRadius() > 0 && pVisual->GetHeight() > 0 )
-                _id = agk::CreateObjectCapsule( pVisual->GetDiameter(), pVisual->GetHeight(), Y_AXIS );
-            break;
-
-            // Planes must have a width and height.
-        case EMT_PLANE:
-            if( pVisual->GetWidth() > 0 && pVisual->GetHeight() > 0 )
-                _id = agk::CreateObjectPlane( pVisual->GetWidth(), pVisual->GetHeight() );
-            break;
-
-            // Spheres must have a radius, at least 2 rows, and at least 3 columns.
-        case EMT_SPHERE:
-            if( pVisual->GetRadius() > 0 && pVisual->GetRows() > 1 && pVisual->GetColumns() > 2 )
-                _id = agk::CreateObjectSphere( pVisual->GetDiameter(), pVisual->GetRows(), pVisual->GetColumns() );
-            break;
-
-            // Meshes must have a name.
-        case EMT_MESH:
-            if( !pVisual->GetMesh().empty() )
-                _id = agk::CloneObject( CResourceManager::Instance().LoadMesh( pVisual->GetMesh() ) );
-            break;
+            _id = agk::CloneObject( CResourceManager::Instance().LoadMesh( pVisual->GetMesh() ) );
+            CResourceManager::Instance().Evict( NDefs::ERT_MESH, pVisual->GetMesh() );
         }
+        break;
+    }
 
-        // If an object was created, apply any textures, shaders, and coloring.
-        if( _id > 0 )
+    // If an object was created, apply any shadows and its size.
+    if( _id > 0 )
+    {
+        // Only apply these if shadows are enabled.
+        if( CSettings::Instance().ShadowsEnabled() )
         {
-            // Set any texture maps the sprite has.
-            if( !pVisual->GetTextureMap().empty() )
-            {
-                int imageId = CResourceManager::Instance().LoadImage( pVisual->GetTextureMap() );
-                agk::SetObjectImage( _id, imageId, ETS_TEXTURE );
-            }
-            if( !pVisual->GetNormalMap().empty() )
-            {
-                int imageId = CResourceManager::Instance().LoadImage( pVisual->GetNormalMap() );
-                agk::SetObjectNormalMap( _id, imageId );
-            }
-            if( !pVisual->GetSpecularMap().empty() )
-            {
-                int imageId = CResourceManager::Instance().LoadImage( pVisual->GetSpecularMap() );
-                agk::SetObjectImage( _id, imageId, ETS_SPECULAR );
-            }
+            agk::SetObjectCastShadow( _id, pVisual->WillCastShadow() );
+            agk::SetObjectReceiveShadow( _id, pVisual->WillReceiveShadow() );
+        }
 
-            // Only apply these if shadows are enabled.
-            if( CSettings::Instance().ShadowsEnabled() )
-            {
-                agk::SetObjectCastShadow( _id, pVisual->WillCastShadow() );
-                agk::SetObjectReceiveShadow( _id, pVisual->WillReceiveShadow() );
-            }
+        // If the size is set in the data, pass the size to AGK.
+        if( pVisual->IsSizeSet() )
+        {
+            _size = pVisual->GetSize();
 
-            // If the size is set in the data, pass the size to AGK.
-            if( pVisual->IsSizeSet() )
+            if( !pVisual->IsSizeSameAsFile() )
             {
-                _size = pVisual->GetSize();
-
-                if( !pVisual->IsSizeSameAsFile() )
+                // If at least two dimensions are set, apply the permanent scale.
+                if( !_size.IsEmptyX() + !_size.IsEmptyY() + !_size.IsEmptyZ() > 1 )
                 {
-                    // If at least two dimensions are set, apply the permanent scale.
-                    if( !_size.IsEmptyX() + !_size.IsEmptyY() + !_size.IsEmptyZ() > 1 )
-                    {
-                        CVector3<float> scale = _size / GetWorldSize();
-                        agk::SetObjectScalePermanent( _id, scale.x, scale.y, scale.z );
-                    }
-                    // If only the width is set, calculate the height and depth.
-                    else if( _size.w > 0 )
-                    {
-                        CVector3<float> size = GetWorldSize();
-                        float scale = _size.w / size.w;
-                        _size.h = scale * size.h;
-                        _size.d = scale * size.d;
-                        agk::SetObjectScalePermanent( _id, scale, scale, scale );
-                    }
-                    // If only the height is set, calculate the width and depth.
-                    else if( _size.h > 0 )
-                    {
-                        CVector3<float> size = GetWorldSize();
-                        float scale = _size.h / size.h;
-                        _size.w = scale * size.w;
-                        _size.d = scale * size.d;
-                        agk::SetObjectScalePermanent( _id, scale, scale, scale );
-                    }
-                    // If only the depth is set, calculate the width and height.
-                    else if( _size.d > 0 )
-                    {
-                        CVector3<float> size = GetWorldSize();
-                        float scale = _size.d / size.d;
-                        _size.w = scale * size.w;
-                        _size.h = scale * size.h;
-                        agk::SetObjectScalePermanent( _id, scale, scale, scale );
-                    }
-
-                    pVisual->SetSize( _size );
+                    CVector3<float> scale = _size / GetObjectSize();
+                    agk::SetObjectScalePermanent( _id, scale.x, scale.y, scale.z );
+                }
+                // If only the width is set, calculate the height and depth.
+                else if( _size.w > 0 )
+                {
+                    CVector3<float> size = GetObjectSize();
+                    float scale = _size.w / size.w;
+                    _size.h = scale * size.h;
+                    _size.d = scale * size.d;
+                    agk::SetObjectScalePermanent( _id, scale, scale, scale );
+                }
+                // If only the height is set, calculate the width and depth.
+                else if( _size.h > 0 )
+                {
+                    CVector3<float> size = GetObjectSize();
+                    float scale = _size.h / size.h;
+                    _size.w = scale * size.w;
+                    _size.d = scale * size.d;
+                    agk::SetObjectScalePermanent( _id, scale, scale, scale );
+                }
+                // If only the depth is set, calculate the width and height.
+                else if( _size.d > 0 )
+                {
+                    CVector3<float> size = GetObjectSize();
+                    float scale = _size.d / size.d;
+                    _size.w = scale * size.w;
+                    _size.h = scale * size.h;
+                    agk::SetObjectScalePermanent( _id, scale, scale, scale );
                 }
-            }
-            else
-            {
-                // If the data does not have a default size, set it to whatever the created sprite's size is.
-                pVisual->SetSize( GetWorldSize() );
-                _size = pVisual->GetSize();
-            }
 
-            // Set the sprite's color.
-            SetColor( pVisual->GetColor() );
+                pVisual->SetSize( _size );
+            }
+        }
+        else
+        {
+            // If the data does not have a default size, set it to whatever the created sprite's size is.
+            pVisual->SetSize( GetObjectSize() );
+            _size = pVisual->GetSize();
         }
+
+        agk::SetObjectVisible( _id, 0 );
+        agk::SetObjectCollisionMode( _id, 0 );
+
+        pVisual->SetPrototypeId( _id );
     }
+
+    _id = 0;
 }
 
 
@@ -213,6 +277,11 @@ void CSprite3D::Clear()
     iObject::Clear();
 
     _pData = nullptr;
+
+    _quaternionMode = false;
+    _orientation.Clear();
+    _worldOrientation.Clear();
+    _orientationRot = 0;
 }
 
 
@@ -236,6 +305,8 @@ void CSprite3D::DeleteObject()
 {
     if( _id > 0 )
     {
+        CCommandBuffer::Instance().Discard( CCommandBuffer::OBJECT, _id );
+
         // If the object has children then delete all of them. Otherwise delete normally.
         if( agk::GetObjectNumChildren( _id ) > 0 )
             agk::DeleteObjectWithChildren( _id );
@@ -243,6 +314,8 @@ void CSprite3D::DeleteObject()
             agk::DeleteObject( _id );
 
         _id = 0;
+
+        ReleaseResources();
     }
 
     _pData = nullptr;
@@ -273,75 +346,289 @@ bool CSprite3D::IsMarkedForDeletion() const
 
 /// *************************************************************************
 /// <summary>
-/// Update AGK with the sprite's current position.
+/// Set whether the sprite keeps its rotation as a quaternion. Quaternions
+/// combine with the parent's rotation without drifting and are sent to AGK
+/// as they are. The euler rotation is kept up to date either way.
 /// </summary>
+/// <param name="value"> Whether to use a quaternion. </param>
 /// *************************************************************************
-void CSprite3D::ApplyPosition()
+void CSprite3D::SetQuaternionMode( bool value )
+{
+    _quaternionMode = value;
+
+    _orientation.SetEuler( _rotation );
+    _orientationRot = _rotation;
+
+    _modified.Add( ETT_ROTATION );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Whether the sprite keeps its rotation as a quaternion.
+/// </summary>
+/// *************************************************************************
+bool CSprite3D::HasOrientation() const
+{
+    return _quaternionMode;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Increment the sprite's rotation. In quaternion mode, the sprite is rotated
+/// about its own axes instead of adding to the euler angles.
+/// </summary>
+/// *************************************************************************
+void CSprite3D::IncRot( float x, float y, float z )
+{
+    if( _quaternionMode )
+        IncOrientation( CQuaternion( CVector3<float>( x, y, z ) ) );
+    else
+        iObject::IncRot( x, y, z );
+}
+
+// Increment the sprite's rotation.
+void CSprite3D::IncRot( const CVector3<float> & rot )
+{
+    if( _quaternionMode )
+        IncOrientation( CQuaternion( rot ) );
+    else
+        iObject::IncRot( rot );
+}
+
+// Increment the sprite's z rotation.
+void CSprite3D::IncRot( float z )
+{
+    if( _quaternionMode )
+        IncOrientation( CQuaternion( CVector3<float>( 0, 0, z ) ) );
+    else
+        iObject::IncRot( z );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Set the sprite's rotation using a quaternion.
+/// </summary>
+/// *************************************************************************
+void CSprite3D::SetOrientation( const CQuaternion & orientation )
 {
-    if( _pParent )
+    if( !_quaternionMode )
     {
-        if( _modified.Contains( ETT_IGNORE ) )
-        {
-            _position = !*_pParent->GetMatrix() * _position;
-        }
-        else
-        {
-            CVector3<float> newPos = *_pParent->GetMatrix() * _position;
-            agk::SetObjectPosition( _id, newPos.x, newPos.y, newPos.z );
-        }
+        iObject::SetOrientation( orientation );
+        return;
     }
-    else
-        agk::SetObjectPosition( _id, _position.x, _position.y, _position.z );
+
+    _orientation = orientation;
+    _orientation.Normalize();
+    UpdateEulerRotation();
+
+    _modified.Add( ETT_ROTATION );
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Update AGK with the sprite's current rotation.
+/// Increment the sprite's rotation by a quaternion, about the sprite's own axes.
 /// </summary>
 /// *************************************************************************
-void CSprite3D::ApplyRotation()
+void CSprite3D::IncOrientation( const CQuaternion & orientation )
 {
-    _rotation %= 360;
+    if( !_quaternionMode )
+    {
+        iObject::IncOrientation( orientation );
+        return;
+    }
+
+    _orientation = GetOrientation() * orientation;
+    _orientation.Normalize();
+    UpdateEulerRotation();
 
-    if( _pParent )
+    _modified.Add( ETT_ROTATION );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the sprite's rotation as a quaternion. Picks up a rotation set
+/// through the euler access functions since the last conversion.
+/// </summary>
+/// *************************************************************************
+CQuaternion CSprite3D::GetOrientation() const
+{
+    if( !_quaternionMode ||
+        (_rotation.x != _orientationRot.x) || (_rotation.y != _orientationRot.y) || (_rotation.z != _orientationRot.z) )
+        return iObject::GetOrientation();
+
+    return _orientation;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the world-space rotation as a quaternion, as of the last transform.
+/// </summary>
+/// *************************************************************************
+CQuaternion CSprite3D::GetWorldOrientation() const
+{
+    if( !_quaternionMode )
+        return iObject::GetWorldOrientation();
+
+    return _worldOrientation;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Update the world-space rotation. In quaternion mode, the rotation is
+/// combined with the parent's as a quaternion and then converted to euler
+/// angles for the getters.
+/// </summary>
+/// *************************************************************************
+void CSprite3D::UpdateWorldRotation()
+{
+    if( !_quaternionMode )
     {
-        if( _modified.Contains( ETT_IGNORE ) )
-        {
-            _rotation -= _pParent->GetWorldRot();
-        }
-        else
-        {
-            CVector3<float> newRot = _pParent->GetWorldRot() + _rotation;
-            agk::SetObjectRotation( _id, newRot.x, newRot.y, newRot.z );
-        }
+        iObject::UpdateWorldRotation();
+        return;
+    }
+
+    _orientation = GetOrientation();
+
+    if( _pParent && _modified.Contains( ETT_IGNORE ) )
+    {
+        _worldOrientation = _orientation;
+        _orientation = _pParent->GetWorldOrientation().GetConjugate() * _orientation;
+        _orientation.Normalize();
+    }
+    else if( _pParent )
+    {
+        _worldOrientation = _pParent->GetWorldOrientation() * _orientation;
+        _worldOrientation.Normalize();
     }
     else
-        agk::SetObjectRotation( _id, _rotation.x, _rotation.y, _rotation.z );
+        _worldOrientation = _orientation;
+
+    UpdateEulerRotation();
+    _worldRotation = _worldOrientation.GetEuler();
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Update AGK with the sprite's current scale.
+/// Delete the prototype the sprites of the data are cloned from, and release
+/// its mesh and images. Only call once none of the sprites are left.
 /// </summary>
+/// <param name="pData"> Data the prototype was built from. </param>
 /// *************************************************************************
-void CSprite3D::ApplyScale()
+void CSprite3D::DeletePrototype( CSpriteData3D * pData )
 {
-    if( _pParent )
+    CSpriteVisualData3D * pVisual = pData->GetVisualData();
+
+    if( pVisual && (pVisual->GetPrototypeId() > 0) )
     {
-        if( _modified.Contains( ETT_IGNORE ) )
-        {
-            _scale *= CVector3<float>( 1 ) / _pParent->GetWorldScale();
-        }
-        else
-        {
-            CVector3<float> newScale = _pParent->GetWorldScale() * _scale;
-            agk::SetObjectScale( _id, newScale.w, newScale.h, newScale.d );
-        }
+        agk::DeleteObject( pVisual->GetPrototypeId() );
+        pVisual->SetPrototypeId( 0 );
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Reference the images the sprite uses, so they aren't evicted while the
+/// sprite exists, and set them on its object. The mesh isn't referenced,
+/// since a clone has its own copy of it.
+/// </summary>
+/// <param name="pVisual"> Visual data the sprite was created from. </param>
+/// *************************************************************************
+void CSprite3D::AcquireResources( const CSpriteVisualData3D * pVisual )
+{
+    CResourceManager & resourceManager = CResourceManager::Instance();
+
+    if( !pVisual->GetTextureMap().empty() )
+    {
+        agk::SetObjectImage( _id, resourceManager.Acquire( NDefs::ERT_IMAGE, pVisual->GetTextureMap() ), ETS_TEXTURE );
+        _imageNameList.push_back( pVisual->GetTextureMap() );
+    }
+
+    if( !pVisual->GetNormalMap().empty() )
+    {
+        agk::SetObjectNormalMap( _id, resourceManager.Acquire( NDefs::ERT_IMAGE, pVisual->GetNormalMap() ) );
+        _imageNameList.push_back( pVisual->GetNormalMap() );
     }
+
+    if( !pVisual->GetSpecularMap().empty() )
+    {
+        agk::SetObjectImage( _id, resourceManager.Acquire( NDefs::ERT_IMAGE, pVisual->GetSpecularMap() ), ETS_SPECULAR );
+        _imageNameList.push_back( pVisual->GetSpecularMap() );
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Release the images the sprite uses, so they can be evicted once nothing
+/// else uses them. Works from the names kept when they were referenced, since
+/// the sprite's data is gone once it's marked for deletion.
+/// </summary>
+/// *************************************************************************
+void CSprite3D::ReleaseResources()
+{
+    for( auto & name : _imageNameList )
+        CResourceManager::Instance().Release( NDefs::ERT_IMAGE, name );
+
+    _imageNameList.clear();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Set the euler rotation from the quaternion, and remember what it was set
+/// to so a change through the euler access functions can be told apart.
+/// </summary>
+/// *************************************************************************
+void CSprite3D::UpdateEulerRotation()
+{
+    _rotation = _orientation.GetEuler();
+    _orientationRot = _rotation;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Update AGK with the sprite's current position.
+/// </summary>
+/// *************************************************************************
+void CSprite3D::ApplyPosition()
+{
+    CCommandBuffer::Instance().Add( CCommandBuffer::OBJECT_POSITION, _id, _worldPosition.x, _worldPosition.y, _worldPosition.z );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Update AGK with the sprite's current rotation.
+/// </summary>
+/// *************************************************************************
+void CSprite3D::ApplyRotation()
+{
+    if( _quaternionMode )
+        CCommandBuffer::Instance().Add( CCommandBuffer::OBJECT_ROTATION_QUAT, _id,
+                                        _worldOrientation.x, _worldOrientation.y, _worldOrientation.z, _worldOrientation.w );
     else
-        agk::SetObjectScale( _id, _scale.w, _scale.h, _scale.d );
+        CCommandBuffer::Instance().Add( CCommandBuffer::OBJECT_ROTATION, _id, _worldRotation.x, _worldRotation.y, _worldRotation.z );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Update AGK with the sprite's current scale.
+/// </summary>
+/// *************************************************************************
+void CSprite3D::ApplyScale()
+{
+    CCommandBuffer::Instance().Add( CCommandBuffer::OBJECT_SCALE, _id, _worldScale.w, _worldScale.h, _worldScale.d );
 }
 
 
@@ -352,10 +639,11 @@ void CSprite3D::ApplyScale()
 /// *************************************************************************
 void CSprite3D::ApplyColor()
 {
-    agk::SetObjectColor( _id, (int)(_color.r * 255 + 0.5f),
-                              (int)(_color.g * 255 + 0.5f),
-                              (int)(_color.b * 255 + 0.5f),
-                              (int)(_color.a * 255 + 0.5f) );
+    CCommandBuffer::Instance().Add( CCommandBuffer::OBJECT_COLOR, _id,
+                                    (int)(_color.r * 255 + 0.5f),
+                                    (int)(_color.g * 255 + 0.5f),
+                                    (int)(_color.b * 255 + 0.5f),
+                                    (int)(_color.a * 255 + 0.5f) );
 }
 
 
@@ -366,10 +654,7 @@ void CSprite3D::ApplyColor()
 /// *************************************************************************
 void CSprite3D::ApplyVisibility()
 {
-    if( _pParent )
-        agk::SetObjectVisible( _id, _pParent->IsVisible() && _visible );
-    else
-        agk::SetObjectVisible( _id, _visible );
+    CCommandBuffer::Instance().Add( CCommandBuffer::OBJECT_VISIBLE, _id, _worldVisible );
 
     const CSpriteVisualData3D * pVisual = _pData->GetVisualData();
 
@@ -377,46 +662,33 @@ void CSprite3D::ApplyVisibility()
     if( CSettings::Instance().ShadowsEnabled() && pVisual )
     {
         if( pVisual->WillCastShadow() )
-            agk::SetObjectCastShadow( _id, IsVisible() );
+            CCommandBuffer::Instance().Add( CCommandBuffer::OBJECT_CAST_SHADOW, _id, _worldVisible );
 
         if( pVisual->WillReceiveShadow() )
-            agk::SetObjectReceiveShadow( _id, IsVisible() );
+            CCommandBuffer::Instance().Add( CCommandBuffer::OBJECT_RECEIVE_SHADOW, _id, _worldVisible );
     }
 }
 
 
-/// *************************************************************************
-/// <summary>
-/// Get the current position set in AGK.
-/// </summary>
-/// *************************************************************************
-CVector3<float> CSprite3D::GetWorldPos() const
-{
-    return CVector3<float>( agk::GetObjectX( _id ),
-                            agk::GetObjectY( _id ),
-                            agk::GetObjectZ( _id ) );
-}
-
 
 /// *************************************************************************
 /// <summary>
-/// Get the current rotation set in AGK.
+/// Get the world size. This is the size of the mesh at a scale of one,
+/// scaled by the object's world scale as of the last transform.
 /// </summary>
 /// *************************************************************************
-CVector3<float> CSprite3D::GetWorldRot() const
+CVector3<float> CSprite3D::GetWorldSize() const
 {
-    return CVector3<float>( agk::GetObjectAngleX( _id ),
-                            agk::GetObjectAngleY( _id ), 
-                            agk::GetObjectAngleZ( _id ) );
+    return _pData->GetSize() * _worldScale;
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Get the current size set in AGK.
+/// Get the size of the object's mesh in AGK.
 /// </summary>
 /// *************************************************************************
-CVector3<float> CSprite3D::GetWorldSize() const
+CVector3<float> CSprite3D::GetObjectSize() const
 {
     return CVector3<float>( abs( agk::GetObjectSizeMaxX( _id ) - agk::GetObjectSizeMinX( _id ) ),
                             abs( agk::GetObjectSizeMaxY( _id ) - agk::GetObjectSizeMinY( _id ) ),
@@ -444,14 +716,3 @@ void CSprite3D::UpdateScale()
 {
     _scale = _size / _pData->GetSize();
 }
-
-
-/// *************************************************************************
-/// <summary>
-/// Get the sprite's visibility.
-/// </summary>
-/// *************************************************************************
-bool CSprite3D::IsVisible() const
-{
-    return agk::GetObjectVisible( _id );
-}
\ No newline at end of file
@@ -6,12 +6,16 @@
 
 // Game lib dependencies
 #include <common\defs.h>
+#include <common\quaternion.h>
+#include <utilities\objectpool.h>
 
 // Standard lib dependencies
 #include <string>
+#include <vector>
 
 // Forward Declarations
 class CSpriteData3D;
+class CSpriteVisualData3D;
 class CCollectionObject;
 
 /// *************************************************************************
@@ -26,12 +30,22 @@ public:
     CSprite3D( const std::string & name );
     ~CSprite3D();
 
+    // Allocate and free the sprite using the pool.
+    static void * operator new( size_t size );
+    static void operator delete( void * ptr, size_t size );
+
+    // Get the pool the sprites are allocated from.
+    static CObjectPool<CSprite3D> & GetPool();
+
     // Get the name of the sprite.
     virtual const std::string & GetName() const;
 
     // Initialize the sprite using its sprite data.
     void Init( const std::string & name );
 
+    // Delete the prototype the sprites of the data are cloned from.
+    static void DeletePrototype( CSpriteData3D * pData );
+
     // Delete the object that belongs to the AGK id.
     virtual void DeleteObject();
 
@@ -42,23 +56,52 @@ public:
     // Get the data used to create the sprite.
     const CSpriteData3D * GetData() const;
 
-    // Get the current transformation data set in AGK.
-    virtual CVector3<float> GetWorldPos() const;
-    virtual CVector3<float> GetWorldRot() const;
+    // Get the world size.
     virtual CVector3<float> GetWorldSize() const;
 
     // Update the size or scale, depending on which has been changed.
     virtual void UpdateSize();
     virtual void UpdateScale();
 
-    // Get the sprite's visibility.
-    virtual bool IsVisible() const;
+    // Access functions for whether the sprite keeps its rotation as a quaternion.
+    void SetQuaternionMode( bool value );
+    virtual bool HasOrientation() const;
+
+    // Increment the sprite's rotation. In quaternion mode, the sprite is
+    // rotated about its own axes.
+    virtual void IncRot( float x, float y, float z );
+    virtual void IncRot( const CVector3<float> & rot );
+    virtual void IncRot( float z );
+
+    // Access functions for the sprite's rotation as a quaternion.
+    virtual void SetOrientation( const CQuaternion & orientation );
+    virtual void IncOrientation( const CQuaternion & orientation );
+    virtual CQuaternion GetOrientation() const;
+    virtual CQuaternion GetWorldOrientation() const;
 
 protected:
 
     // Clears all of the sprite's data that belong to it.
     virtual void Clear();
 
+    // Get the size of the object's mesh in AGK.
+    CVector3<float> GetObjectSize() const;
+
+    // Update the world-space rotation.
+    virtual void UpdateWorldRotation();
+
+    // Set the euler rotation from the quaternion.
+    void UpdateEulerRotation();
+
+    // Build the AGK object the sprites of the data are cloned from.
+    void CreatePrototype( CSpriteVisualData3D * pVisual );
+
+    // Reference the images the sprite uses and set them on its object.
+    void AcquireResources( const CSpriteVisualData3D * pVisual );
+
+    // Release the images the sprite uses.
+    void ReleaseResources();
+
     // Apply changes to AGK.
     virtual void ApplyPosition();
     virtual void ApplyRotation();
@@ -70,6 +113,21 @@ protected:
 
     // Sprite data this sprite is based off of. The sprite does not own this.
     const CSpriteData3D * _pData = nullptr;
+
+    // Whether the sprite keeps its rotation as a quaternion.
+    bool _quaternionMode = false;
+
+    // Local and world-space rotation of the sprite in quaternion mode.
+    CQuaternion _orientation;
+    CQuaternion _worldOrientation;
+
+    // The euler rotation the quaternion was last converted to. If the rotation
+    // no longer matches, it was set through the euler access functions.
+    CVector3<float> _orientationRot;
+
+    // Names of the images the sprite referenced, kept so they can be released
+    // after the sprite is marked for deletion.
+    std::vector<std::string> _imageNameList;
 };
 
 
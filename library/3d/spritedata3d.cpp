@@ -4,6 +4,7 @@
 // Game lib dependencies
 #include <utilities\deletefuncs.h>
 #include <utilities\exceptionhandling.h>
+#include <utilities\binarydata.h>
 
 using namespace std;
 using namespace nlohmann;
@@ -47,6 +48,48 @@ void CSpriteData3D::LoadFromIter( const std::string & name, nlohmann::json::cons
     }
 
     NParseHelper::GetValueList( iter, "animations", _animationList );
+    NParseHelper::GetValue( iter, "quaternion", _quaternion );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Write the sprite data to compiled data, in the order Read() reads it.
+/// </summary>
+/// <param name="writer"> Writer of the compiled data. </param>
+/// *************************************************************************
+void CSpriteData3D::Write( CBinaryWriter & writer ) const
+{
+    writer.Write( _pVisualData != nullptr );
+    if( _pVisualData )
+        _pVisualData->Write( writer );
+
+    writer.Write( _animationList );
+    writer.Write( _quaternion );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Read the sprite data from compiled data.
+/// </summary>
+/// <param name="name"> Name of the data. </param>
+/// <param name="reader"> Reader of the compiled data. </param>
+/// *************************************************************************
+void CSpriteData3D::Read( const std::string & name, CBinaryReader & reader )
+{
+    _name = name;
+
+    bool hasVisual;
+    reader.Read( hasVisual );
+    if( hasVisual )
+    {
+        _pVisualData = new CSpriteVisualData3D();
+        _pVisualData->Read( reader );
+    }
+
+    reader.Read( _animationList );
+    reader.Read( _quaternion );
 }
 
 
@@ -91,6 +134,17 @@ const vector<string> & CSpriteData3D::GetAnimationList() const
 }
 
 
+/// *************************************************************************
+/// <summary> 
+/// Whether the sprite keeps its rotation as a quaternion.
+/// </summary>
+/// *************************************************************************
+bool CSpriteData3D::IsQuaternion() const
+{
+    return _quaternion;
+}
+
+
 /// *************************************************************************
 /// <summary> 
 /// Set the default size of the sprite.
@@ -9,6 +9,10 @@
 #include <string>
 #include <vector>
 
+// Forward declarations
+class CBinaryWriter;
+class CBinaryReader;
+
 /// *************************************************************************
 /// <summary>
 /// Class containing the default creation data for a 3D sprite.
@@ -24,11 +28,18 @@ public:
     // Load the sprite data from the passed in iterator.
     void LoadFromIter( const std::string & name, nlohmann::json::const_iterator iter );
 
+    // Write the sprite data to compiled data.
+    void Write( CBinaryWriter & writer ) const;
+
+    // Read the sprite data from compiled data.
+    void Read( const std::string & name, CBinaryReader & reader );
+
     // Access functions for the sprite data.
     CSpriteVisualData3D * GetVisualData() const;
     CSpriteVisualData3D * GetVisualData();
     const std::string & GetName() const;
     const std::vector<std::string> & GetAnimationList() const;
+    bool IsQuaternion() const;
 
     // Access functions for the default size of the sprite.
     const CVector3<float> & GetSize() const;
@@ -43,6 +54,9 @@ private:
 
     // The list of animations this sprite can perform.
     std::vector<std::string> _animationList;
+
+    // Whether the sprite keeps its rotation as a quaternion.
+    bool _quaternion = false;
 };
 
 #endif  // __sprite_data_3d_h__
@@ -4,6 +4,7 @@
 // Game lib dependencies
 #include <common\defs.h>
 #include <utilities\jsonparsehelper.h>
+#include <utilities\binarydata.h>
 
 using namespace std;
 using namespace NDefs;
@@ -55,6 +56,64 @@ void CSpriteVisualData3D::LoadFromIter( nlohmann::json::const_iterator iter )
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Write the visual sprite data to compiled data, in the order Read() reads it.
+/// </summary>
+/// <param name="writer"> Writer of the compiled data. </param>
+/// *************************************************************************
+void CSpriteVisualData3D::Write( CBinaryWriter & writer ) const
+{
+    writer.Write( _type );
+    writer.Write( _mesh );
+    writer.Write( _shader );
+    writer.Write( _color );
+    writer.Write( _textureMap );
+    writer.Write( _normalMap );
+    writer.Write( _specularMap );
+    writer.Write( _width );
+    writer.Write( _height );
+    writer.Write( _depth );
+    writer.Write( _radius );
+    writer.Write( _rows );
+    writer.Write( _columns );
+    writer.Write( _castShadow );
+    writer.Write( _receiveShadow );
+    writer.Write( _sizeSet );
+    writer.Write( _sizeSameAsFile );
+    writer.Write( _size );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Read the visual sprite data from compiled data.
+/// </summary>
+/// <param name="reader"> Reader of the compiled data. </param>
+/// *************************************************************************
+void CSpriteVisualData3D::Read( CBinaryReader & reader )
+{
+    reader.Read( _type );
+    reader.Read( _mesh );
+    reader.Read( _shader );
+    reader.Read( _color );
+    reader.Read( _textureMap );
+    reader.Read( _normalMap );
+    reader.Read( _specularMap );
+    reader.Read( _width );
+    reader.Read( _height );
+    reader.Read( _depth );
+    reader.Read( _radius );
+    reader.Read( _rows );
+    reader.Read( _columns );
+    reader.Read( _castShadow );
+    reader.Read( _receiveShadow );
+    reader.Read( _sizeSet );
+    reader.Read( _sizeSameAsFile );
+    reader.Read( _size );
+}
+
+
 /// *************************************************************************
 /// <summary> 
 /// Get the sprite's object type.
@@ -278,4 +337,27 @@ bool CSpriteVisualData3D::IsSizeSet() const
 bool CSpriteVisualData3D::IsSizeSameAsFile() const
 {
     return _sizeSameAsFile;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Set the AGK object the sprites are cloned from.
+/// </summary>
+/// *************************************************************************
+void CSpriteVisualData3D::SetPrototypeId( uint id )
+{
+    _prototypeId = id;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Get the AGK object the sprites are cloned from. Zero if it hasn't been
+/// built yet.
+/// </summary>
+/// *************************************************************************
+uint CSpriteVisualData3D::GetPrototypeId() const
+{
+    return _prototypeId;
 }
\ No newline at end of file
@@ -11,6 +11,10 @@
 #include <string>
 
 
+// Forward declarations
+class CBinaryWriter;
+class CBinaryReader;
+
 /// *************************************************************************
 /// <summary> 
 /// Class containing the default creation data for a 3D sprite's visual
@@ -28,6 +32,12 @@ public:
     // Load the visual sprite data from the passed in iterator.
     void LoadFromIter( nlohmann::json::const_iterator iter );
 
+    // Write the visual sprite data to compiled data.
+    void Write( CBinaryWriter & writer ) const;
+
+    // Read the visual sprite data from compiled data.
+    void Read( CBinaryReader & reader );
+
     // Get the sprite's object type.
     NDefs::EMeshType GetType() const;
 
@@ -70,6 +80,10 @@ public:
     // Whether or not the size is the same as the file.
     bool IsSizeSameAsFile() const;
 
+    // Access functions for the AGK object the sprites are cloned from.
+    void SetPrototypeId( uint id );
+    uint GetPrototypeId() const;
+
 private:
 
     // Type of object.
@@ -105,6 +119,10 @@ private:
 
     // Size of the sprite.
     CVector3<float> _size;
+
+    // Hidden AGK object the sprites are cloned from. Built by the first sprite
+    // and deleted by CSprite3D::DeletePrototype(). Not part of the compiled data.
+    uint _prototypeId = 0;
 };
 
 #endif  // __sprite_visual_data_3d_h__
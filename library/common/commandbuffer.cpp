@@ -0,0 +1,199 @@
+// Physical component dependency
+#include "commandbuffer.h"
+
+// Game lib dependencies
+#include <agk.h>
+
+namespace
+{
+    // The kind of id each type of command is given.
+    const CCommandBuffer::ETarget COMMAND_TARGET[CCommandBuffer::COMMAND_COUNT] =
+    {
+        CCommandBuffer::SPRITE, CCommandBuffer::SPRITE, CCommandBuffer::SPRITE,
+        CCommandBuffer::SPRITE, CCommandBuffer::SPRITE, CCommandBuffer::SPRITE,
+        CCommandBuffer::OBJECT, CCommandBuffer::OBJECT, CCommandBuffer::OBJECT, CCommandBuffer::OBJECT,
+        CCommandBuffer::OBJECT, CCommandBuffer::OBJECT, CCommandBuffer::OBJECT, CCommandBuffer::OBJECT,
+        CCommandBuffer::TEXT, CCommandBuffer::TEXT, CCommandBuffer::TEXT,
+        CCommandBuffer::TEXT, CCommandBuffer::TEXT, CCommandBuffer::TEXT
+    };
+
+    // Functions that pass each type of command on to AGK.
+    void SetSpritePosition( const CCommandBuffer::CCommand & c ) { agk::SetSpritePosition( c.id, c.value[0], c.value[1] ); }
+    void SetSpriteDepth( const CCommandBuffer::CCommand & c )    { agk::SetSpriteDepth( c.id, (int)c.value[0] ); }
+    void SetSpriteAngle( const CCommandBuffer::CCommand & c )    { agk::SetSpriteAngle( c.id, c.value[0] ); }
+    void SetSpriteScale( const CCommandBuffer::CCommand & c )    { agk::SetSpriteScale( c.id, c.value[0], c.value[1] ); }
+    void SetSpriteColor( const CCommandBuffer::CCommand & c )    { agk::SetSpriteColor( c.id, (int)c.value[0], (int)c.value[1], (int)c.value[2], (int)c.value[3] ); }
+    void SetSpriteVisible( const CCommandBuffer::CCommand & c )  { agk::SetSpriteVisible( c.id, (int)c.value[0] ); }
+
+    void SetObjectPosition( const CCommandBuffer::CCommand & c )      { agk::SetObjectPosition( c.id, c.value[0], c.value[1], c.value[2] ); }
+    void SetObjectRotation( const CCommandBuffer::CCommand & c )      { agk::SetObjectRotation( c.id, c.value[0], c.value[1], c.value[2] ); }
+    void SetObjectRotationQuat( const CCommandBuffer::CCommand & c )  { agk::SetObjectRotationQuat( c.id, c.value[3], c.value[0], c.value[1], c.value[2] ); }
+    void SetObjectScale( const CCommandBuffer::CCommand & c )         { agk::SetObjectScale( c.id, c.value[0], c.value[1], c.value[2] ); }
+    void SetObjectColor( const CCommandBuffer::CCommand & c )         { agk::SetObjectColor( c.id, (int)c.value[0], (int)c.value[1], (int)c.value[2], (int)c.value[3] ); }
+    void SetObjectVisible( const CCommandBuffer::CCommand & c )       { agk::SetObjectVisible( c.id, (int)c.value[0] ); }
+    void SetObjectCastShadow( const CCommandBuffer::CCommand & c )    { agk::SetObjectCastShadow( c.id, (int)c.value[0] ); }
+    void SetObjectReceiveShadow( const CCommandBuffer::CCommand & c ) { agk::SetObjectReceiveShadow( c.id, (int)c.value[0] ); }
+
+    void SetTextPosition( const CCommandBuffer::CCommand & c ) { agk::SetTextPosition( c.id, c.value[0], c.value[1] ); }
+    void SetTextDepth( const CCommandBuffer::CCommand & c )    { agk::SetTextDepth( c.id, (int)c.value[0] ); }
+    void SetTextAngle( const CCommandBuffer::CCommand & c )    { agk::SetTextAngle( c.id, c.value[0] ); }
+    void SetTextSize( const CCommandBuffer::CCommand & c )     { agk::SetTextSize( c.id, c.value[0] ); }
+    void SetTextColor( const CCommandBuffer::CCommand & c )    { agk::SetTextColor( c.id, (int)c.value[0], (int)c.value[1], (int)c.value[2], (int)c.value[3] ); }
+    void SetTextVisible( const CCommandBuffer::CCommand & c )  { agk::SetTextVisible( c.id, (int)c.value[0] ); }
+
+    // The AGK function for each type of command.
+    const CCommandBuffer::TCommandFunc AGK_HANDLER[CCommandBuffer::COMMAND_COUNT] =
+    {
+        SetSpritePosition, SetSpriteDepth, SetSpriteAngle, SetSpriteScale, SetSpriteColor, SetSpriteVisible,
+        SetObjectPosition, SetObjectRotation, SetObjectRotationQuat, SetObjectScale, SetObjectColor, SetObjectVisible,
+        SetObjectCastShadow, SetObjectReceiveShadow,
+        SetTextPosition, SetTextDepth, SetTextAngle, SetTextSize, SetTextColor, SetTextVisible
+    };
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Constructor
+/// </summary>
+/// *************************************************************************
+CCommandBuffer::CCommandBuffer()
+{
+    for( uint i = 0; i < COMMAND_COUNT; ++i )
+        _handlerList[i] = AGK_HANDLER[i];
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Destructor
+/// </summary>
+/// *************************************************************************
+CCommandBuffer::~CCommandBuffer()
+{
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Record a command. Replaces any command of the same type recorded for the id.
+/// The euler and quaternion object rotations both set the whole rotation, so
+/// recording one drops the other instead of letting the flush order decide.
+/// </summary>
+/// <param name="type"> The type of command. </param>
+/// <param name="id"> The AGK id the command is for. </param>
+/// <param name="x, y, z, w"> Values passed on to AGK. </param>
+/// *************************************************************************
+void CCommandBuffer::Add( ECommand type, uint id, float x, float y, float z, float w )
+{
+    if( type == OBJECT_ROTATION )
+        Remove( OBJECT_ROTATION_QUAT, id );
+    else if( type == OBJECT_ROTATION_QUAT )
+        Remove( OBJECT_ROTATION, id );
+
+    std::vector<CCommand> & commandList = _commandList[type];
+
+    auto result = _indexMap[type].emplace( id, (uint)commandList.size() );
+    if( result.second )
+        commandList.emplace_back();
+
+    CCommand & command = commandList[result.first->second];
+    command.id = id;
+    command.value[0] = x;
+    command.value[1] = y;
+    command.value[2] = z;
+    command.value[3] = w;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Drop all the recorded commands for an id that's being deleted, so they
+/// aren't run on a deleted id or on a new object that reuses it.
+/// </summary>
+/// <param name="target"> The kind of id. </param>
+/// <param name="id"> The AGK id being deleted. </param>
+/// *************************************************************************
+void CCommandBuffer::Discard( ETarget target, uint id )
+{
+    for( uint type = 0; type < COMMAND_COUNT; ++type )
+        if( COMMAND_TARGET[type] == target )
+            Remove( (ECommand)type, id );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Drop the command of a type recorded for the id, if there is one.
+/// </summary>
+/// <param name="type"> The type of command. </param>
+/// <param name="id"> The AGK id the command is for. </param>
+/// *************************************************************************
+void CCommandBuffer::Remove( ECommand type, uint id )
+{
+    auto indexIter = _indexMap[type].find( id );
+    if( indexIter == _indexMap[type].end() )
+        return;
+
+    // Move the last command into the dropped command's place.
+    std::vector<CCommand> & commandList = _commandList[type];
+    uint index = indexIter->second;
+    _indexMap[type].erase( indexIter );
+
+    if( index != commandList.size() - 1 )
+    {
+        commandList[index] = commandList.back();
+        _indexMap[type][commandList[index].id] = index;
+    }
+
+    commandList.pop_back();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Run all of the recorded commands, grouped by type, and clear the buffer.
+/// Call right before agk::Sync().
+/// </summary>
+/// *************************************************************************
+void CCommandBuffer::Flush()
+{
+    for( uint type = 0; type < COMMAND_COUNT; ++type )
+    {
+        TCommandFunc func = _handlerList[type];
+        for( const auto & command : _commandList[type] )
+            func( command );
+
+        _commandList[type].clear();
+        _indexMap[type].clear();
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Set the function that runs a type of command, such as a stub that only
+/// records the calls. Null restores the AGK call.
+/// </summary>
+/// <param name="type"> The type of command. </param>
+/// <param name="func"> Function to run the commands with. </param>
+/// *************************************************************************
+void CCommandBuffer::SetHandler( ECommand type, TCommandFunc func )
+{
+    _handlerList[type] = func ? func : AGK_HANDLER[type];
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the number of commands waiting to be flushed.
+/// </summary>
+/// *************************************************************************
+uint CCommandBuffer::GetCount() const
+{
+    uint count = 0;
+    for( uint type = 0; type < COMMAND_COUNT; ++type )
+        count += (uint)_commandList[type].size();
+
+    return count;
+}
\ No newline at end of file
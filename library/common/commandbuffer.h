@@ -0,0 +1,118 @@
+#ifndef __command_buffer_h__
+#define __command_buffer_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+
+// Standard lib dependencies
+#include <vector>
+#include <unordered_map>
+
+/// *************************************************************************
+/// <summary>
+/// Class to collect the AGK calls made while transforming objects and run
+/// them together before the frame is drawn. Writing the same command to the
+/// same id twice in a frame only keeps the last write, and the commands are
+/// run grouped by type instead of interleaved across objects.
+/// 
+/// Nothing reaches AGK until Flush(), so AGK getters called between the
+/// transform and the flush return the values from before the commands.
+/// </summary>
+/// *************************************************************************
+class CCommandBuffer
+{
+public:
+    // Get the instance of the singleton class
+    static CCommandBuffer & Instance()
+    {
+        static CCommandBuffer commandBuffer;
+        return commandBuffer;
+    }
+
+    // Types of commands, in the order they're flushed.
+    enum ECommand
+    {
+        SPRITE_POSITION,
+        SPRITE_DEPTH,
+        SPRITE_ANGLE,
+        SPRITE_SCALE,
+        SPRITE_COLOR,
+        SPRITE_VISIBLE,
+        OBJECT_POSITION,
+        OBJECT_ROTATION,
+        OBJECT_ROTATION_QUAT,
+        OBJECT_SCALE,
+        OBJECT_COLOR,
+        OBJECT_VISIBLE,
+        OBJECT_CAST_SHADOW,
+        OBJECT_RECEIVE_SHADOW,
+        TEXT_POSITION,
+        TEXT_DEPTH,
+        TEXT_ANGLE,
+        TEXT_SIZE,
+        TEXT_COLOR,
+        TEXT_VISIBLE,
+        COMMAND_COUNT
+    };
+
+    // The kinds of AGK ids the commands are given.
+    enum ETarget
+    {
+        SPRITE,
+        OBJECT,
+        TEXT
+    };
+
+    /// *************************************************************************
+    /// <summary>
+    /// A recorded command and the values to pass on to AGK.
+    /// </summary>
+    /// *************************************************************************
+    class CCommand
+    {
+    public:
+
+        uint id;
+        float value[4];
+    };
+
+    // Function that runs a command.
+    typedef void (*TCommandFunc)( const CCommand & command );
+
+    // Record a command. Replaces any command of the same type recorded for the id,
+    // and either kind of object rotation replaces the other.
+    void Add( ECommand type, uint id, float x, float y = 0, float z = 0, float w = 0 );
+
+    // Drop all the recorded commands for an id that's being deleted.
+    void Discard( ETarget target, uint id );
+
+    // Run all of the recorded commands, grouped by type, and clear the buffer.
+    void Flush();
+
+    // Set the function that runs a type of command. Null restores the AGK call.
+    void SetHandler( ECommand type, TCommandFunc func );
+
+    // Get the number of commands waiting to be flushed.
+    uint GetCount() const;
+
+private:
+
+    CCommandBuffer();
+    virtual ~CCommandBuffer();
+
+    // Drop the command of a type recorded for the id, if there is one.
+    void Remove( ECommand type, uint id );
+
+private:
+
+    // Commands recorded this frame for each type.
+    std::vector<CCommand> _commandList[COMMAND_COUNT];
+
+    // Position of each id's command in the command list, for each type.
+    std::unordered_map<uint, uint> _indexMap[COMMAND_COUNT];
+
+    // Function that runs each type of command.
+    TCommandFunc _handlerList[COMMAND_COUNT];
+};
+
+#endif  // __command_buffer_h__
\ No newline at end of file
@@ -93,6 +93,25 @@ namespace NDefs
         _stopTypeList.emplace( "pause", EST_PAUSE );
         _stopTypeList.emplace( "break", EST_BREAK );
         _stopTypeList.emplace( "finish", EST_FINISH );
+
+        _trackFieldList.emplace( "position", ETF_POSITION );
+        _trackFieldList.emplace( "rotation", ETF_ROTATION );
+        _trackFieldList.emplace( "size", ETF_SIZE );
+        _trackFieldList.emplace( "color", ETF_COLOR );
+        _trackFieldList.emplace( "alpha", ETF_ALPHA );
+        _trackFieldList.emplace( "visible", ETF_VISIBLE );
+
+        _easingList.emplace( "linear", EE_LINEAR );
+        _easingList.emplace( "step", EE_STEP );
+        _easingList.emplace( "in quad", EE_IN_QUAD );
+        _easingList.emplace( "out quad", EE_OUT_QUAD );
+        _easingList.emplace( "in out quad", EE_IN_OUT_QUAD );
+        _easingList.emplace( "in cubic", EE_IN_CUBIC );
+        _easingList.emplace( "out cubic", EE_OUT_CUBIC );
+        _easingList.emplace( "in out cubic", EE_IN_OUT_CUBIC );
+        _easingList.emplace( "in sine", EE_IN_SINE );
+        _easingList.emplace( "out sine", EE_OUT_SINE );
+        _easingList.emplace( "in out sine", EE_IN_OUT_SINE );
     }
 
 
@@ -258,4 +277,26 @@ namespace NDefs
     {
         return NGeneralFuncs::GetMapValue( value, _stopTypeList );
     }
+
+
+    /// *************************************************************************
+    /// <summary> 
+    /// Get the animation track field.
+    /// </summary>
+    /// *************************************************************************
+    ETrackField CDefs::GetTrackField( const std::string & value )
+    {
+        return NGeneralFuncs::GetMapValue( value, _trackFieldList );
+    }
+
+
+    /// *************************************************************************
+    /// <summary> 
+    /// Get the animation easing curve.
+    /// </summary>
+    /// *************************************************************************
+    EEasing CDefs::GetEasing( const std::string & value )
+    {
+        return NGeneralFuncs::GetMapValue( value, _easingList );
+    }
 }
\ No newline at end of file
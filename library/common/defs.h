@@ -96,6 +96,19 @@ namespace NDefs
         ERT_FONT
     };
 
+    // The types of compiled data files.
+    enum EDataType : int
+    {
+        EDT_NULL,
+        EDT_SPRITE_3D,
+        EDT_SPRITE_2D,
+        EDT_TEXT_SPRITE,
+        EDT_COLLECTION,
+        EDT_MENU,
+        EDT_CONTROL,
+        EDT_ANIMATION
+    };
+
     enum EControlType
     {
         ECT_NULL,
@@ -177,6 +190,34 @@ namespace NDefs
         EST_FINISH   // Finish out the current loop and play any animation outside of the loop.
     };
 
+    // The fields an animation track can change.
+    enum ETrackField : int
+    {
+        ETF_NULL,
+        ETF_POSITION,
+        ETF_ROTATION,
+        ETF_SIZE,
+        ETF_COLOR,
+        ETF_ALPHA,
+        ETF_VISIBLE
+    };
+
+    // The curves an animation track can ease into a keyframe with.
+    enum EEasing : int
+    {
+        EE_LINEAR,
+        EE_STEP,              // Hold the previous keyframe until this one is reached.
+        EE_IN_QUAD,
+        EE_OUT_QUAD,
+        EE_IN_OUT_QUAD,
+        EE_IN_CUBIC,
+        EE_OUT_CUBIC,
+        EE_IN_OUT_CUBIC,
+        EE_IN_SINE,
+        EE_OUT_SINE,
+        EE_IN_OUT_SINE
+    };
+
     /// *************************************************************************
     /// <summary> 
     /// Class to load and hold 3d mesh id's.
@@ -207,6 +248,8 @@ namespace NDefs
         EShadowMode GetShadowMode( const std::string & value );
         EEndType GetEndType( const std::string & value );
         EStopType GetStopType( const std::string & value );
+        ETrackField GetTrackField( const std::string & value );
+        EEasing GetEasing( const std::string & value );
 
     private:
 
@@ -254,6 +297,12 @@ namespace NDefs
 
         // Map containing the list of animation end types.
         std::map<const std::string, EStopType> _stopTypeList;
+
+        // Map containing the list of animation track fields.
+        std::map<const std::string, ETrackField> _trackFieldList;
+
+        // Map containing the list of animation easing curves.
+        std::map<const std::string, EEasing> _easingList;
     };
 }
 
@@ -4,11 +4,51 @@
 // Game lib dependencies
 #include <common\collectionobject.h>
 #include <common\matrix4.h>
+#include <common\quaternion.h>
+#include <common\transformstore.h>
 #include <script\animationcomponent.h>
 #include <utilities\deletefuncs.h>
 
 using namespace NDefs;
 
+/// *************************************************************************
+/// <summary>
+/// Constructor. The transformation fields are references into the object's
+/// slot in the transform store.
+/// </summary>
+/// *************************************************************************
+iObject::iObject()
+    : _slot( CTransformStore::Instance().Allocate() ),
+      _position( CTransformStore::Instance().GetPos( _slot ) ),
+      _rotation( CTransformStore::Instance().GetRot( _slot ) ),
+      _size( CTransformStore::Instance().GetSize( _slot ) ),
+      _scale( CTransformStore::Instance().GetScale( _slot ) ),
+      _color( CTransformStore::Instance().GetColor( _slot ) ),
+      _visible( CTransformStore::Instance().GetVisible( _slot ) ),
+      _modified( CTransformStore::Instance().GetModified( _slot ) ),
+      _worldPosition( CTransformStore::Instance().GetWorldPos( _slot ) ),
+      _worldRotation( CTransformStore::Instance().GetWorldRot( _slot ) ),
+      _worldScale( CTransformStore::Instance().GetWorldScale( _slot ) ),
+      _worldColor( CTransformStore::Instance().GetWorldColor( _slot ) ),
+      _worldVisible( CTransformStore::Instance().GetWorldVisible( _slot ) )
+{
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Destructor
+/// </summary>
+/// *************************************************************************
+iObject::~iObject()
+{
+    NDelFunc::Delete( _pAnimationComponent );
+    NDelFunc::Delete( _pMatrix );
+
+    CTransformStore::Instance().Release( _slot );
+}
+
+
 /// *************************************************************************
 /// <summary>
 /// Return the id set by AGK. 
@@ -20,6 +60,39 @@ uint iObject::GetID() const
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Get the object's slot in the transform store. 
+/// </summary>
+/// *************************************************************************
+uint iObject::GetSlot() const
+{
+    return _slot;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Set the handle the sprite manager has given the object. 
+/// </summary>
+/// *************************************************************************
+void iObject::SetHandle( uint handle )
+{
+    _handle = handle;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the handle the sprite manager has given the object. 
+/// </summary>
+/// *************************************************************************
+uint iObject::GetHandle() const
+{
+    return _handle;
+}
+
+
 /// *************************************************************************
 /// <summary>
 /// Get the type of object this is. 
@@ -48,7 +121,29 @@ void iObject::Clear()
     _size = 0;
     _color = 1;
 
+    _worldPosition = 0;
+    _worldRotation = 0;
+    _worldScale = 1;
+    _worldColor = 1;
+    _worldVisible = true;
+
     _pParent = nullptr;
+    _parentHandle = 0;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Initialize the object's animation component.
+/// </summary>
+/// <param name="animationList"> List of animation names to create. </param>
+/// *************************************************************************
+void iObject::CreateAnimationComponent( const std::vector<std::vector<std::string>> & animationList )
+{
+    if( !_pAnimationComponent )
+        _pAnimationComponent = new CAnimationComponent();
+
+    _pAnimationComponent->Init( this, animationList );
 }
 
 
@@ -65,6 +160,39 @@ void iObject::SetVisible( bool visible )
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Get the object's world visibility. 
+/// </summary>
+/// *************************************************************************
+bool iObject::IsVisible() const
+{
+    return _worldVisible;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the object's world position. 
+/// </summary>
+/// *************************************************************************
+CVector3<float> iObject::GetWorldPos() const
+{
+    return _worldPosition;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the object's world rotation. 
+/// </summary>
+/// *************************************************************************
+CVector3<float> iObject::GetWorldRot() const
+{
+    return _worldRotation;
+}
+
+
 /// *************************************************************************
 /// <summary>
 /// Set the object's fields using a collection object. 
@@ -302,6 +430,45 @@ const CVector3<float> & iObject::GetRot() const
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Set the object's rotation using a quaternion. Objects that don't keep
+/// their rotation as a quaternion store it as euler angles.
+/// </summary>
+/// *************************************************************************
+void iObject::SetOrientation( const CQuaternion & orientation )
+{
+    SetRot( orientation.GetEuler() );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Increment the object's rotation by a quaternion, about the object's own
+/// axes. Objects that don't keep their rotation as a quaternion store the
+/// result as euler angles.
+/// </summary>
+/// *************************************************************************
+void iObject::IncOrientation( const CQuaternion & orientation )
+{
+    CQuaternion result = GetOrientation() * orientation;
+    result.Normalize();
+
+    SetRot( result.GetEuler() );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the object's rotation as a quaternion.
+/// </summary>
+/// *************************************************************************
+CQuaternion iObject::GetOrientation() const
+{
+    return CQuaternion( _rotation );
+}
+
+
 /// *************************************************************************
 /// <summary>
 /// Set the object's size. 
@@ -618,10 +785,7 @@ const CVector3<float> & iObject::GetScale() const
 /// *************************************************************************
 CVector3<float> iObject::GetWorldScale() const
 {
-    if( _pParent )
-        return _scale * _pParent->GetWorldScale();
-
-    return _scale;
+    return _worldScale;
 }
 
 
@@ -743,10 +907,13 @@ const CVector4<float> & iObject::GetColor() const
 /// *************************************************************************
 CVector4<float> iObject::GetWorldColor() const
 {
-    if( _pParent )
-        return _color * _pParent->GetWorldColor();
+    return _worldColor;
+}
 
-    return _color;
+// Get the world-space rotation as a quaternion.
+CQuaternion iObject::GetWorldOrientation() const
+{
+    return CQuaternion( _worldRotation );
 }
 
 
@@ -754,12 +921,23 @@ CVector4<float> iObject::GetWorldColor() const
 /// <summary>
 /// Set the object's parent. 
 /// </summary>
-/// <param name="pParent"> The parent to set to. </param>
+/// <param name="pParent"> The parent to set to. Null removes the parent. </param>
 /// *************************************************************************
 void iObject::SetParent( iObject * pParent, bool ignore )
 {
     _pParent = pParent;
-    _pParent->CreateMatrix();
+    _parentHandle = 0;
+
+    if( _pParent )
+    {
+        _pParent->CreateMatrix();
+        _parentHandle = _pParent->GetHandle();
+    }
+
+    // The sprite manager transforms parents before their children, so it needs to
+    // know. Objects it doesn't have yet are placed when they're added.
+    if( _handle )
+        CTransformStore::Instance().AddParentChange( _handle );
 
     if( ignore )
         _modified = ETT_POSITION | ETT_ROTATION | ETT_SCALE | ETT_IGNORE;
@@ -779,6 +957,33 @@ const iObject * iObject::GetParent() const
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Get the handle of the object's parent. 
+/// </summary>
+/// *************************************************************************
+uint iObject::GetParentHandle() const
+{
+    return _parentHandle;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the handle of the object's parent. A parent can be set before the
+/// sprite manager has added it, so if it had no handle then, it's looked
+/// up again.
+/// </summary>
+/// *************************************************************************
+uint iObject::ResolveParentHandle()
+{
+    if( _pParent && !_parentHandle )
+        _parentHandle = _pParent->GetHandle();
+
+    return _parentHandle;
+}
+
+
 /// *************************************************************************
 /// <summary>
 /// Play an animation. 
@@ -884,6 +1089,24 @@ const CMatrix4 * iObject::GetMatrix()
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Set the object's matrix when it has been composed outside of the object,
+/// such as by the sprite manager's transform batch. The object won't
+/// compose its matrix again this frame.
+/// </summary>
+/// <param name="matrix"> The world matrix. </param>
+/// *************************************************************************
+void iObject::SetWorldMatrix( const CMatrix4 & matrix )
+{
+    if( _pMatrix )
+    {
+        *_pMatrix = matrix;
+        _modified.Add( ETT_MATRIX );
+    }
+}
+
+
 /// *************************************************************************
 /// <summary>
 /// Mark the object as deleted if its parent has been deleted. 
@@ -898,53 +1121,135 @@ void iObject::UpdateForDeletion()
 
 /// *************************************************************************
 /// <summary>
-/// Update the object. 
+/// Update the object. The animations are updated by the animation manager,
+/// only while they're playing.
 /// </summary>
 /// *************************************************************************
 void iObject::Update()
 {
-    if( _pAnimationComponent )
-        _pAnimationComponent->Update();
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Function to call the functions that update AGK. 
+/// Add the fields changed by the parent's transformation to the object's
+/// modified bitmask. 
 /// </summary>
+/// <param name="parentModified"> The parent's modified bitmask. </param>
 /// *************************************************************************
-void iObject::Transform()
+void iObject::InheritModified( const CBitmask<uint> & parentModified )
 {
-    // Make sure all parents are updated before updating this object.
-    if( _pParent )
+    if( parentModified.Contains( ETT_APPLIED ) )
     {
-        _pParent->Transform();
+        // If the parent was transformed by anything, the position has changed.
+        if( parentModified.Contains( ETT_POSITION ) )
+            _modified.Add( ETT_POSITION );
 
-        if( _pParent->GetModified().Contains( ETT_APPLIED ) )
-        {
-            // If the parent was transformed by anything, the position has changed.
-            if( _pParent->GetModified().Contains( ETT_POSITION ) )
-                _modified.Add( ETT_POSITION );
+        if( parentModified.Contains( ETT_ROTATION ) )
+            _modified.Add( ETT_POSITION | ETT_ROTATION );
+
+        if( parentModified.Contains( ETT_SCALE ) )
+            _modified.Add( ETT_POSITION | ETT_SCALE );
+
+        if( parentModified.Contains( ETT_COLOR ) )
+            _modified.Add( ETT_COLOR );
+
+        if( parentModified.Contains( ETT_VISIBILITY ) )
+            _modified.Add( ETT_VISIBILITY );
+    }
+}
 
-            if( _pParent->GetModified().Contains( ETT_ROTATION ) )
-                _modified.Add( ETT_POSITION | ETT_ROTATION );
 
-            if( _pParent->GetModified().Contains( ETT_SCALE ) )
-                _modified.Add( ETT_POSITION | ETT_SCALE );
+/// *************************************************************************
+/// <summary>
+/// Update the world-space fields that have been changed, using the parent's
+/// world-space fields. If the object was given its parent with the ignore
+/// flag, its fields are already in world space, so they're kept as the
+/// world values and the local fields are made relative to the parent.
+/// </summary>
+/// *************************************************************************
+void iObject::UpdateWorldTransform()
+{
+    if( _modified.Contains( ETT_ROTATION ) )
+        UpdateWorldRotation();
 
-            if( _pParent->GetModified().Contains( ETT_COLOR ) )
-                _modified.Add( ETT_COLOR );
+    if( _pParent && _modified.Contains( ETT_IGNORE ) )
+    {
+        if( _modified.Contains( ETT_POSITION ) )
+        {
+            _worldPosition = _position;
+            _position = !*_pParent->GetMatrix() * _position;
+        }
 
-            if( _pParent->GetModified().Contains( ETT_VISIBILITY ) )
-                _modified.Add( ETT_VISIBILITY );
+        if( _modified.Contains( ETT_SCALE ) )
+        {
+            _worldScale = _scale;
+            _scale *= CVector3<float>( 1 ) / _pParent->GetWorldScale();
         }
     }
+    else if( _pParent )
+    {
+        if( _modified.Contains( ETT_POSITION ) )
+            _worldPosition = *_pParent->GetMatrix() * _position;
+
+        if( _modified.Contains( ETT_SCALE ) )
+            _worldScale = _pParent->GetWorldScale() * _scale;
+    }
+    else
+    {
+        if( _modified.Contains( ETT_POSITION ) )
+            _worldPosition = _position;
+
+        if( _modified.Contains( ETT_SCALE ) )
+            _worldScale = _scale;
+    }
+
+    if( _modified.Contains( ETT_COLOR ) )
+        _worldColor = _pParent ? _color * _pParent->GetWorldColor() : _color;
 
+    if( _modified.Contains( ETT_VISIBILITY ) )
+        _worldVisible = _pParent ? _pParent->IsVisible() && _visible : _visible;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Update the world-space rotation using the parent's. If the object was
+/// given its parent with the ignore flag, its rotation is kept as the world
+/// rotation and the local rotation is made relative to the parent.
+/// </summary>
+/// *************************************************************************
+void iObject::UpdateWorldRotation()
+{
+    _rotation %= 360;
+
+    if( _pParent && _modified.Contains( ETT_IGNORE ) )
+    {
+        _worldRotation = _rotation;
+        _rotation -= _pParent->GetWorldRot();
+    }
+    else if( _pParent )
+        _worldRotation = _pParent->GetWorldRot() + _rotation;
+    else
+        _worldRotation = _rotation;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Function to call the functions that update AGK. The parent must have
+/// been transformed and its changes inherited before this is called.
+/// </summary>
+/// *************************************************************************
+void iObject::Transform()
+{
     // Apply changes if there were changes and they haven't already been applied.
     if( _modified.ContainsOne( ETT_POSITION | ETT_ROTATION | ETT_SCALE | ETT_COLOR | ETT_VISIBILITY ) )
     {
         if( !_modified.Contains( ETT_APPLIED ) )
         {
+            UpdateWorldTransform();
+
             if( _modified.Contains( ETT_POSITION ) )
                 ApplyPosition();
 
@@ -965,7 +1270,12 @@ void iObject::Transform()
         if( _pMatrix && !_modified.Contains( ETT_MATRIX ) )
         {
             _pMatrix->Clear();
-            _pMatrix->SetRotation( _rotation );
+
+            if( HasOrientation() )
+                _pMatrix->SetRotation( GetOrientation() );
+            else
+                _pMatrix->SetRotation( _rotation );
+
             _pMatrix->Scale( _scale );
             _pMatrix->SetTranslation( _position );
 
@@ -10,15 +10,22 @@
 
 // Standard lib dependencies
 #include <string>
+#include <vector>
 
 // Forward declarations
 class CAnimationComponent;
 class CCollectionObject;
 class CMatrix4;
+class CQuaternion;
 
 /// *************************************************************************
 /// <summary>
 /// Interface class for the various sprite classes.
+/// 
+/// The setters only change the object's own values. They're passed on to
+/// AGK when the sprite manager transforms the objects, and AGK only sees
+/// them once the command buffer is flushed before agk::Sync(), so AGK's own
+/// getters return the previous frame's values until then.
 /// </summary>
 /// *************************************************************************
 class iObject
@@ -26,7 +33,7 @@ class iObject
 public:
 
     // Destructor.
-    virtual ~iObject() {}
+    virtual ~iObject();
 
     // Delete the object that belongs to the AGK id.
     virtual void DeleteObject() = 0;
@@ -34,6 +41,13 @@ public:
     // Return the id set by AGK.
     uint GetID() const;
 
+    // Get the object's slot in the transform store.
+    uint GetSlot() const;
+
+    // Access functions for the handle the sprite manager has given the object.
+    void SetHandle( uint handle );
+    uint GetHandle() const;
+
     // Get the name of the object.
     virtual const std::string & GetName() const = 0;
 
@@ -46,14 +60,15 @@ public:
 
     // Access functions for the object's visibility.
     virtual void SetVisible( bool visible );
-    virtual bool IsVisible() const = 0;
+    virtual bool IsVisible() const;
 
-    // Get the current transformation data set in AGK.
-    virtual CVector3<float> GetWorldPos() const = 0;
-    virtual CVector3<float> GetWorldRot() const = 0;
+    // Get the world-space transformation data as of the last transform.
+    virtual CVector3<float> GetWorldPos() const;
+    virtual CVector3<float> GetWorldRot() const;
     virtual CVector3<float> GetWorldSize() const = 0;
     virtual CVector3<float> GetWorldScale() const;
     virtual CVector4<float> GetWorldColor() const;
+    virtual CQuaternion GetWorldOrientation() const;
 
     // Update the size or scale, depending on which has been changed.
     virtual void UpdateSize() = 0;
@@ -62,7 +77,8 @@ public:
     // Set the object's fields using a collection object.
     virtual void Set( const CCollectionObject & collectionObject );
 
-    // Access functions for the object's position.
+    // Access functions for the object's position. Like all of the setters,
+    // the change reaches AGK when the command buffer is flushed.
     virtual void SetPos( float x, float y );
     virtual void SetPos( float x, float y, float z );
     virtual void SetPos( const CVector2<float> & pos );
@@ -87,6 +103,14 @@ public:
     virtual void IncRot( float z );
     virtual const CVector3<float> & GetRot() const;
 
+    // Access functions for the object's rotation as a quaternion.
+    virtual void SetOrientation( const CQuaternion & orientation );
+    virtual void IncOrientation( const CQuaternion & orientation );
+    virtual CQuaternion GetOrientation() const;
+
+    // Whether the object keeps its rotation as a quaternion.
+    virtual bool HasOrientation() const { return false; }
+
     // Access functions for the object's size.
     virtual void SetSize( float w, float h, float d );
     virtual void SetSize( float w, float h );
@@ -155,6 +179,10 @@ public:
     // Access functions for the object's parent.
     virtual void SetParent( iObject * pParent, bool ignore = false );
     virtual const iObject * GetParent() const;
+    uint GetParentHandle() const;
+
+    // Get the handle of the object's parent, looking it up again if the parent had none when it was set.
+    uint ResolveParentHandle();
 
     // Reset the object's position using its previous position.
     virtual void Reposition() {}
@@ -179,10 +207,16 @@ public:
     // Get the object's matrix
     const CMatrix4 * GetMatrix();
 
+    // Set the object's matrix when it has been composed outside of the object.
+    void SetWorldMatrix( const CMatrix4 & matrix );
+
     // Update the object.
     virtual void UpdateForDeletion();
     virtual void Update();
 
+    // Add the fields changed by the parent's transformation to the modified bitmask.
+    void InheritModified( const CBitmask<uint> & parentModified );
+
     // Function to call the functions that update AGK.
     virtual void Transform();
 
@@ -192,11 +226,24 @@ public:
 protected:
 
     // Abstract Constructor.
-    iObject() {}
+    iObject();
+
+    // Objects own their slot in the transform store, so they can't be copied.
+    iObject( const iObject & ) = delete;
+    iObject & operator=( const iObject & ) = delete;
 
     // Clear the object and reset its id.
     virtual void Clear();
 
+    // Initialize the object's animation component.
+    void CreateAnimationComponent( const std::vector<std::vector<std::string>> & animationList );
+
+    // Update the world-space fields that have been changed.
+    void UpdateWorldTransform();
+
+    // Update the world-space rotation.
+    virtual void UpdateWorldRotation();
+
     // Apply changes to AGK.
     virtual void ApplyPosition() = 0;
     virtual void ApplyRotation() = 0;
@@ -209,38 +256,57 @@ protected:
     // The id AGK has given the object.
     uint _id = 0;
 
+    // The handle the sprite manager has given the object. Zero if it isn't managed.
+    uint _handle = 0;
+
     // The type of object.
     NDefs::EObjectType _type;
 
+    // Slot in the transform store holding the object's transformation data.
+    const uint _slot;
+
     // Translation of the object.
-    CVector3<float> _position = 0;
+    CVector3<float> & _position;
 
     // Rotation of the object.
-    CVector3<float> _rotation = 0;
+    CVector3<float> & _rotation;
 
     // Size of the object.
-    CVector3<float> _size = 0;
+    CVector3<float> & _size;
 
     // Scale of the object. 
-    CVector3<float> _scale = 1;
+    CVector3<float> & _scale;
 
     // Color of the object.
-    CVector4<float> _color = 1;
+    CVector4<float> & _color;
 
     // Whether or not the object is visible.
-    bool _visible = true;
+    bool & _visible;
 
     // A bit mask of all the fields that have been changed.
-    CBitmask<uint> _modified = NDefs::ETT_NULL;
-
-    // Component to handle playing any animations.
+    CBitmask<uint> & _modified;
+
+    // World-space transformation of the object, combined with its parent's.
+    // Updated when the object is transformed.
+    CVector3<float> & _worldPosition;
+    CVector3<float> & _worldRotation;
+    CVector3<float> & _worldScale;
+    CVector4<float> & _worldColor;
+    bool & _worldVisible;
+
+    // Component to handle playing any animations. Only allocated for objects
+    // that have animations.
     CAnimationComponent * _pAnimationComponent = nullptr;
 
-    // The object's transformation matrix.
+    // The object's transformation matrix. Only allocated once it's needed,
+    // which is when the object is a parent or has a child.
     CMatrix4 * _pMatrix = nullptr;
 
     // The parent object. This pointer does not belong to this object.
     iObject * _pParent = nullptr;
+
+    // Handle of the parent object, used to check the parent still exists.
+    uint _parentHandle = 0;
 };
 
 #endif  // __i_object_h__
\ No newline at end of file
@@ -11,6 +11,7 @@ template <class T>
 class CVector3;
 template <class T>
 class CVector4;
+class CQuaternion;
 
 /// *************************************************************************
 /// <summary> 
@@ -36,6 +37,9 @@ public:
     CVector4<float> operator * ( const CVector4<float> & v ) const;
     void operator *= ( const CMatrix4 & n );
 
+    // Transform a list of points by the matrix.
+    void Transform( const CVector3<float> * pSrc, CVector3<float> * pDest, uint count ) const;
+
     // Get inverted 4x4 matrix.
     CMatrix4 operator ! () const;
 
@@ -51,7 +55,9 @@ public:
 
     // Set the rotation portion of the matrix.
     void SetRotation( const CVector3<float> & value );
+    void SetRotation( const CVector3<float> & value, const CVector3<float> & sinValue, const CVector3<float> & cosValue );
     void SetRotation( float value );
+    void SetRotation( const CQuaternion & value );
 
     // Set the scale portion of the matrix.
     void SetScale( const CVector3<float> & value );
@@ -73,10 +79,10 @@ public:
 
 private:
 
-    // Set the x, y, or z rotation portion of the matrix.
-    void SetRotationX( float value, int flags = 0 );
-    void SetRotationY( float value, int flags = 0 );
-    void SetRotationZ( float value );
+    // Set the x, y, or z rotation portion of the matrix from the sine and cosine of the angle.
+    void SetRotationX( float sinX, float cosX, int flags = 0 );
+    void SetRotationY( float sinY, float cosY, int flags = 0 );
+    void SetRotationZ( float sinZ, float cosZ );
 
 public:
 
@@ -0,0 +1,233 @@
+// Physical component dependency
+#include "quaternion.h"
+
+// Game lib dependencies
+#include <common\defs.h>
+#include <common\vector3.h>
+#include <utilities\fasttrig.h>
+
+// Standard lib dependencies
+#include <cmath>
+
+namespace
+{
+    // How close the quaternions must be before slerp falls back to a linear blend.
+    const float SLERP_THRESHOLD = 0.9995f;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Constructor
+/// </summary>
+/// *************************************************************************
+CQuaternion::CQuaternion()
+    : x(0), y(0), z(0), w(1)
+{
+}
+
+CQuaternion::CQuaternion( float _x, float _y, float _z, float _w )
+    : x(_x), y(_y), z(_z), w(_w)
+{
+}
+
+CQuaternion::CQuaternion( const CVector3<float> & rotation )
+{
+    SetEuler( rotation );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Quaternion multiplication. The result applies q first and then this
+/// rotation, the same as multiplying their matrices.
+/// </summary>
+/// *************************************************************************
+CQuaternion CQuaternion::operator * ( const CQuaternion & q ) const
+{
+    return CQuaternion( w * q.x + x * q.w + y * q.z - z * q.y,
+                        w * q.y - x * q.z + y * q.w + z * q.x,
+                        w * q.z + x * q.y - y * q.x + z * q.w,
+                        w * q.w - x * q.x - y * q.y - z * q.z );
+}
+
+/// <summary>
+/// Quaternion multiplication.
+/// </summary>
+void CQuaternion::operator *= ( const CQuaternion & q )
+{
+    *this = *this * q;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Rotate a vector by the quaternion.
+/// </summary>
+/// *************************************************************************
+CVector3<float> CQuaternion::operator * ( const CVector3<float> & v ) const
+{
+    // t = 2 * (u x v), v' = v + w * t + u x t
+    float tx = 2 * (y * v.z - z * v.y);
+    float ty = 2 * (z * v.x - x * v.z);
+    float tz = 2 * (x * v.y - y * v.x);
+
+    return CVector3<float>( v.x + w * tx + (y * tz - z * ty),
+                            v.y + w * ty + (z * tx - x * tz),
+                            v.z + w * tz + (x * ty - y * tx) );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Reset the quaternion to no rotation.
+/// </summary>
+/// *************************************************************************
+void CQuaternion::Clear()
+{
+    x = y = z = 0;
+    w = 1;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Set the quaternion from euler angles. The angles are applied z, then y,
+/// then x, the same as CMatrix4::SetRotation().
+/// </summary>
+/// <param name="rotation"> Rotation in degrees. </param>
+/// *************************************************************************
+void CQuaternion::SetEuler( const CVector3<float> & rotation )
+{
+    float sinX, cosX, sinY, cosY, sinZ, cosZ;
+    NFastTrig::SinCosDeg( rotation.x * 0.5f, sinX, cosX );
+    NFastTrig::SinCosDeg( rotation.y * 0.5f, sinY, cosY );
+    NFastTrig::SinCosDeg( rotation.z * 0.5f, sinZ, cosZ );
+
+    x = sinX * cosY * cosZ + cosX * sinY * sinZ;
+    y = cosX * sinY * cosZ - sinX * cosY * sinZ;
+    z = cosX * cosY * sinZ + sinX * sinY * cosZ;
+    w = cosX * cosY * cosZ - sinX * sinY * sinZ;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the rotation as euler angles, in the order used by SetEuler(). Each
+/// angle is between -180 and 180 degrees. The z rotation is solved from the
+/// matrix with the x rotation taken out, so it makes up whatever x got wrong
+/// and there's no gimbal lock case: near +/- 90 degrees of y, where x and z
+/// can't be told apart, z takes the rotation x doesn't.
+/// </summary>
+/// *************************************************************************
+CVector3<float> CQuaternion::GetEuler() const
+{
+    // The rotation matrix entries the angles are read from.
+    float m11 = 1 - 2 * (y * y + z * z);
+    float m12 = 2 * (x * y - z * w);
+    float m13 = 2 * (x * z + y * w);
+    float m21 = 2 * (x * y + z * w);
+    float m22 = 1 - 2 * (x * x + z * z);
+    float m23 = 2 * (y * z - x * w);
+    float m31 = 2 * (x * z - y * w);
+    float m32 = 2 * (y * z + x * w);
+    float m33 = 1 - 2 * (x * x + y * y);
+
+    CVector3<float> rotation;
+
+    rotation.x = atan2( -m23, m33 );
+    rotation.y = atan2( m13, sqrt( m11 * m11 + m12 * m12 ) );
+
+    // Undoing the x rotation leaves the z rotation in the second row.
+    float sinX = sin( rotation.x );
+    float cosX = cos( rotation.x );
+    rotation.z = atan2( cosX * m21 + sinX * m31, cosX * m22 + sinX * m32 );
+
+    return rotation * (float)defs_RAD_TO_DEG;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Scale the quaternion back to unit length.
+/// </summary>
+/// *************************************************************************
+void CQuaternion::Normalize()
+{
+    float length = sqrt( x * x + y * y + z * z + w * w );
+
+    if( length > 0 )
+    {
+        float inv = 1 / length;
+        x *= inv;
+        y *= inv;
+        z *= inv;
+        w *= inv;
+    }
+    else
+        Clear();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the quaternion that undoes this rotation.
+/// </summary>
+/// *************************************************************************
+CQuaternion CQuaternion::GetConjugate() const
+{
+    return CQuaternion( -x, -y, -z, w );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the dot product of two quaternions.
+/// </summary>
+/// *************************************************************************
+float CQuaternion::Dot( const CQuaternion & q ) const
+{
+    return x * q.x + y * q.y + z * q.z + w * q.w;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Spherically interpolate from this rotation to another, taking the
+/// shortest way around.
+/// </summary>
+/// <param name="q"> Rotation to interpolate to. </param>
+/// <param name="t"> How far to interpolate, from 0 to 1. </param>
+/// *************************************************************************
+CQuaternion CQuaternion::Slerp( const CQuaternion & q, float t ) const
+{
+    CQuaternion to( q );
+    float cosTheta = Dot( q );
+
+    if( cosTheta < 0 )
+    {
+        to = CQuaternion( -q.x, -q.y, -q.z, -q.w );
+        cosTheta = -cosTheta;
+    }
+
+    float fromWeight = 1 - t;
+    float toWeight = t;
+
+    // Fall back to a linear blend when the rotations are too close to divide by the sine.
+    if( cosTheta < SLERP_THRESHOLD )
+    {
+        float theta = acos( cosTheta );
+        float invSinTheta = 1 / sin( theta );
+
+        fromWeight = sin( fromWeight * theta ) * invSinTheta;
+        toWeight = sin( toWeight * theta ) * invSinTheta;
+    }
+
+    CQuaternion result( x * fromWeight + to.x * toWeight,
+                        y * fromWeight + to.y * toWeight,
+                        z * fromWeight + to.z * toWeight,
+                        w * fromWeight + to.w * toWeight );
+    result.Normalize();
+
+    return result;
+}
\ No newline at end of file
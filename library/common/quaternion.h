@@ -0,0 +1,54 @@
+#ifndef __quaternion_h__
+#define __quaternion_h__
+
+// Forward declarations
+template <class T>
+class CVector3;
+
+/// *************************************************************************
+/// <summary>
+/// Class to hold a rotation as a unit quaternion. Rotations are combined
+/// the same way as matrices, so a * b applies b first and then a.
+/// </summary>
+/// *************************************************************************
+class CQuaternion
+{
+public:
+
+    // Constructor
+    CQuaternion();
+    CQuaternion( float _x, float _y, float _z, float _w );
+    CQuaternion( const CVector3<float> & rotation );
+
+    // Quaternion multiplication.
+    CQuaternion operator * ( const CQuaternion & q ) const;
+    void operator *= ( const CQuaternion & q );
+
+    // Rotate a vector by the quaternion.
+    CVector3<float> operator * ( const CVector3<float> & v ) const;
+
+    // Reset the quaternion to no rotation.
+    void Clear();
+
+    // Access functions for the rotation as euler angles, in degrees.
+    void SetEuler( const CVector3<float> & rotation );
+    CVector3<float> GetEuler() const;
+
+    // Scale the quaternion back to unit length.
+    void Normalize();
+
+    // Get the quaternion that undoes this rotation.
+    CQuaternion GetConjugate() const;
+
+    // Get the dot product of two quaternions.
+    float Dot( const CQuaternion & q ) const;
+
+    // Spherically interpolate from this rotation to another.
+    CQuaternion Slerp( const CQuaternion & q, float t ) const;
+
+public:
+
+    float x, y, z, w;
+};
+
+#endif  // __quaternion_h__
\ No newline at end of file
@@ -23,9 +23,24 @@ public:
     // The id of the loaded data. If this id is zero, it means the data isn't loaded.
     uint id = UNLOADED_ID;
 
-    // The file path to the data.
+    // The file path to the data. For sub images, the name of the parent image.
     std::string path;
 
+    // Number of users holding the resource. Only unreferenced resources are evicted.
+    uint refCount = 0;
+
+    // Estimated number of bytes the loaded data uses.
+    size_t size = 0;
+
+    // When the resource was last used, for evicting the least recently used first.
+    uint lastUsed = 0;
+
+    // Whether the data was evicted, so loading it again counts as a reload.
+    bool evicted = false;
+
+    // Whether the resource is a sub image of another image.
+    bool subImage = false;
+
     /// *************************************************************************
     /// <summary> 
     /// Constructor
@@ -47,5 +62,28 @@ public:
     {}
 };
 
+/// *************************************************************************
+/// <summary> 
+/// Class to hold the memory stats of a type of resource.
+/// </summary>
+/// *************************************************************************
+class CResourceStats
+{
+public:
+    // Number of resources loaded.
+    uint residentCount = 0;
+
+    // Estimated number of bytes the loaded resources use.
+    size_t residentBytes = 0;
+
+    // Number of times a resource was loaded.
+    uint loadCount = 0;
+
+    // Number of times a resource was evicted to stay in the budget.
+    uint evictCount = 0;
+
+    // Number of times an evicted resource had to be loaded again.
+    uint reloadCount = 0;
+};
 
 #endif  // __resource_file_h__
\ No newline at end of file
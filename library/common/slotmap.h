@@ -0,0 +1,227 @@
+#ifndef __slot_map_h__
+#define __slot_map_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+#include <utilities\exceptionhandling.h>
+
+// Standard lib dependencies
+#include <vector>
+
+
+/// *************************************************************************
+/// <summary>
+/// Class to hold values in a dense array and hand out 32-bit generational
+/// handles to them. The low bits of a handle index a slot and the high bits
+/// hold the slot's generation, which changes every time the slot is reused,
+/// so a handle to a removed value never finds the value that replaced it.
+/// A slot is retired once its generation has run out instead of wrapping
+/// around to a generation an old handle may still hold. Adding, finding and
+/// removing are all constant time.
+/// </summary>
+/// *************************************************************************
+template <typename type>
+class CSlotMap
+{
+public:
+
+    // Number of bits in a handle used for the slot index.
+    static const uint INDEX_BITS = 20;
+    static const uint INDEX_MASK = (1 << INDEX_BITS) - 1;
+    static const uint GENERATION_MASK = (uint)-1 >> INDEX_BITS;
+
+    // Handle that never refers to a value.
+    static const uint NULL_HANDLE = 0;
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Add a value and return its handle.
+    /// </summary>
+    /// *************************************************************************
+    uint Add( const type & value )
+    {
+        uint index;
+        if( _freeList.empty() )
+        {
+            if( _slotList.size() > INDEX_MASK )
+                throw NExcept::CCriticalException( "Slot Map Error!",
+                                                   "CSlotMap::Add()",
+                                                   "Ran out of slots for the handles." );
+
+            index = (uint)_slotList.size();
+            _slotList.push_back( 0 );
+            _generationList.push_back( 1 );
+        }
+        else
+        {
+            index = _freeList.back();
+            _freeList.pop_back();
+        }
+
+        uint handle = (_generationList[index] << INDEX_BITS) | index;
+
+        _slotList[index] = (uint)_denseList.size();
+        _denseList.push_back( value );
+        _denseHandleList.push_back( handle );
+
+        return handle;
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Remove the value the handle refers to. The last value is moved into
+    /// its place, so the order of the values isn't kept.
+    /// </summary>
+    /// *************************************************************************
+    bool Remove( uint handle )
+    {
+        if( !IsValid( handle ) )
+            return false;
+
+        uint index = handle & INDEX_MASK;
+        uint densePos = _slotList[index];
+        uint lastPos = (uint)_denseList.size() - 1;
+
+        if( densePos != lastPos )
+        {
+            _denseList[densePos] = _denseList[lastPos];
+            _denseHandleList[densePos] = _denseHandleList[lastPos];
+            _slotList[_denseHandleList[densePos] & INDEX_MASK] = densePos;
+        }
+
+        _denseList.pop_back();
+        _denseHandleList.pop_back();
+
+        // Retire the slot once its generation runs out. Generation zero is never
+        // handed out, so no handle refers to a retired slot.
+        if( _generationList[index] == GENERATION_MASK )
+        {
+            _generationList[index] = 0;
+        }
+        else
+        {
+            ++_generationList[index];
+            _freeList.push_back( index );
+        }
+
+        return true;
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Whether the handle refers to a value that hasn't been removed.
+    /// </summary>
+    /// *************************************************************************
+    bool IsValid( uint handle ) const
+    {
+        uint index = handle & INDEX_MASK;
+
+        return ((handle >> INDEX_BITS) != 0) &&
+               (index < _generationList.size()) &&
+               (_generationList[index] == (handle >> INDEX_BITS));
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get the value the handle refers to. Returns null if the handle is stale.
+    /// </summary>
+    /// *************************************************************************
+    type * Get( uint handle )
+    {
+        if( !IsValid( handle ) )
+            return nullptr;
+
+        return &_denseList[_slotList[handle & INDEX_MASK]];
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Access the values by their position in the dense array.
+    /// </summary>
+    /// *************************************************************************
+    type & GetAt( size_t pos )
+    {
+        return _denseList[pos];
+    }
+
+    // Get the handle of the value at the position in the dense array.
+    uint GetHandleAt( size_t pos ) const
+    {
+        return _denseHandleList[pos];
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get the number of values.
+    /// </summary>
+    /// *************************************************************************
+    size_t GetSize() const
+    {
+        return _denseList.size();
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Whether there are no values.
+    /// </summary>
+    /// *************************************************************************
+    bool IsEmpty() const
+    {
+        return _denseList.empty();
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Remove all of the values. Handles given out before are invalidated.
+    /// </summary>
+    /// *************************************************************************
+    void Clear()
+    {
+        while( !_denseHandleList.empty() )
+            Remove( _denseHandleList.back() );
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Iterators over the dense array of values.
+    /// </summary>
+    /// *************************************************************************
+    typename std::vector<type>::iterator begin()
+    {
+        return _denseList.begin();
+    }
+
+    typename std::vector<type>::iterator end()
+    {
+        return _denseList.end();
+    }
+
+private:
+
+    // Values packed together for iteration.
+    std::vector<type> _denseList;
+
+    // Handle of each value in the dense array.
+    std::vector<uint> _denseHandleList;
+
+    // Position in the dense array of each slot's value.
+    std::vector<uint> _slotList;
+
+    // Current generation of each slot.
+    std::vector<uint> _generationList;
+
+    // Slots waiting to be reused.
+    std::vector<uint> _freeList;
+
+};
+
+#endif  // __slot_map_h__
\ No newline at end of file
@@ -0,0 +1,374 @@
+// Physical component dependency
+#include "transformbatch.h"
+
+// Game lib dependencies
+#include <utilities\fasttrig.h>
+
+namespace
+{
+    /// *************************************************************************
+    /// <summary>
+    /// Put the values of a list in the given order and drop the values that
+    /// aren't in it. When every value stays in place or moves down, the list
+    /// is compacted where it is, without allocating.
+    /// </summary>
+    /// *************************************************************************
+    template <typename type>
+    void ReorderList( std::vector<type> & list, const std::vector<uint> & orderList, bool inPlace )
+    {
+        if( inPlace )
+        {
+            for( size_t i = 0; i < orderList.size(); ++i )
+                if( orderList[i] != i )
+                    list[i] = list[orderList[i]];
+
+            list.erase( list.begin() + orderList.size(), list.end() );
+        }
+        else
+        {
+            std::vector<type> oldList;
+            oldList.swap( list );
+            list.reserve( orderList.size() );
+
+            for( auto index : orderList )
+                list.push_back( oldList[index] );
+        }
+    }
+}
+
+/// *************************************************************************
+/// <summary>
+/// Constructor
+/// </summary>
+/// *************************************************************************
+CTransformBatch::CTransformBatch()
+{
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Destructor
+/// </summary>
+/// *************************************************************************
+CTransformBatch::~CTransformBatch()
+{
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Add a node to the end, without a parent. It isn't composed until its
+/// transformation is set.
+/// </summary>
+/// *************************************************************************
+void CTransformBatch::Add()
+{
+    _parentList.push_back( (int)NO_PARENT );
+    _positionList.push_back( CVector3<float>( 0 ) );
+    _rotationList.push_back( CVector3<float>( 0 ) );
+    _scaleList.push_back( CVector3<float>( 1 ) );
+    _orientationList.push_back( CQuaternion() );
+    _rotationMatrixList.push_back( CMatrix4() );
+    _worldList.push_back( CMatrix4() );
+    _stateList.push_back( CBitmask<uint>( 0 ) );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Keep the listed nodes in the listed order and drop the rest. The nodes
+/// keep their transformation and world matrix, and their parent index
+/// follows the parent. A node whose parent was dropped is left without one.
+/// </summary>
+/// <param name="orderList"> Old index of each node, in the new order.
+/// Parents must still come before their children. </param>
+/// *************************************************************************
+void CTransformBatch::Reorder( const std::vector<uint> & orderList )
+{
+    // Dropping nodes only moves the rest down, which can be done in place.
+    bool inPlace = true;
+    _newIndexList.assign( _parentList.size(), (int)NO_PARENT );
+
+    for( size_t i = 0; i < orderList.size(); ++i )
+    {
+        _newIndexList[orderList[i]] = (int)i;
+        inPlace = inPlace && ((i == 0) || (orderList[i] > orderList[i - 1]));
+    }
+
+    ReorderList( _parentList, orderList, inPlace );
+    ReorderList( _positionList, orderList, inPlace );
+    ReorderList( _rotationList, orderList, inPlace );
+    ReorderList( _scaleList, orderList, inPlace );
+    ReorderList( _orientationList, orderList, inPlace );
+    ReorderList( _rotationMatrixList, orderList, inPlace );
+    ReorderList( _worldList, orderList, inPlace );
+    ReorderList( _stateList, orderList, inPlace );
+
+    for( size_t i = 0; i < _parentList.size(); ++i )
+    {
+        if( _parentList[i] != NO_PARENT )
+        {
+            _parentList[i] = _newIndexList[_parentList[i]];
+
+            if( _parentList[i] == NO_PARENT )
+                _stateList[i].Add( NODE_CHANGED );
+        }
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Set the parent of a node. The parent must come before the node.
+/// </summary>
+/// <param name="index"> The node. </param>
+/// <param name="parent"> Index of the parent, or NO_PARENT. </param>
+/// *************************************************************************
+void CTransformBatch::SetParent( uint index, int parent )
+{
+    _parentList[index] = parent;
+    _stateList[index].Add( NODE_CHANGED );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the index of the parent of a node, or NO_PARENT.
+/// </summary>
+/// *************************************************************************
+int CTransformBatch::GetParent( uint index ) const
+{
+    return _parentList[index];
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Whether the node's transformation has been set since it was added.
+/// </summary>
+/// *************************************************************************
+bool CTransformBatch::IsSet( uint index ) const
+{
+    return _stateList[index].Contains( NODE_SET );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Set the local transformation of a node.
+/// </summary>
+/// <param name="index"> The node. </param>
+/// <param name="position, rotation, scale"> The local transformation. </param>
+/// <param name="worldSpace"> Whether the transformation is already in world
+/// space and shouldn't be combined with the parent's. </param>
+/// *************************************************************************
+void CTransformBatch::Set( uint index,
+                           const CVector3<float> & position,
+                           const CVector3<float> & rotation,
+                           const CVector3<float> & scale,
+                           bool worldSpace )
+{
+    CBitmask<uint> & state = _stateList[index];
+
+    const CVector3<float> & oldRotation = _rotationList[index];
+    if( !state.Contains( NODE_SET ) || state.Contains( NODE_QUATERNION ) ||
+        (oldRotation.x != rotation.x) || (oldRotation.y != rotation.y) || (oldRotation.z != rotation.z) )
+    {
+        _rotationList[index] = rotation;
+        state.Add( NODE_ROTATION_CHANGED );
+        state.Remove( NODE_QUATERNION );
+    }
+
+    SetTransform( index, position, scale, worldSpace );
+}
+
+// Set the local transformation of a node, with its rotation as a quaternion.
+void CTransformBatch::Set( uint index,
+                           const CVector3<float> & position,
+                           const CQuaternion & orientation,
+                           const CVector3<float> & scale,
+                           bool worldSpace )
+{
+    CBitmask<uint> & state = _stateList[index];
+
+    const CQuaternion & oldOrientation = _orientationList[index];
+    if( !state.Contains( NODE_QUATERNION ) ||
+        (oldOrientation.x != orientation.x) || (oldOrientation.y != orientation.y) ||
+        (oldOrientation.z != orientation.z) || (oldOrientation.w != orientation.w) )
+    {
+        _orientationList[index] = orientation;
+        state.Add( NODE_ROTATION_CHANGED | NODE_QUATERNION );
+    }
+
+    SetTransform( index, position, scale, worldSpace );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Set the translation and scale of a node and mark it as changed.
+/// </summary>
+/// <param name="index"> The node. </param>
+/// <param name="position, scale"> The local translation and scale. </param>
+/// <param name="worldSpace"> Whether the transformation is already in world
+/// space and shouldn't be combined with the parent's. </param>
+/// *************************************************************************
+void CTransformBatch::SetTransform( uint index, const CVector3<float> & position, const CVector3<float> & scale, bool worldSpace )
+{
+    CBitmask<uint> & state = _stateList[index];
+
+    _positionList[index] = position;
+    _scaleList[index] = scale;
+
+    state.Add( NODE_SET | NODE_CHANGED );
+
+    if( worldSpace )
+        state.Add( NODE_WORLD_SPACE );
+    else
+        state.Remove( NODE_WORLD_SPACE );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Compose the world matrix of every node that has changed or whose parent's
+/// world matrix has been composed again. Each local matrix is the rotation
+/// scaled by the scale with the position as its translation, the same as
+/// an object composing its own matrix.
+/// </summary>
+/// *************************************************************************
+void CTransformBatch::Compose()
+{
+    UpdateRotations();
+
+    for( size_t i = 0; i < _stateList.size(); ++i )
+    {
+        CBitmask<uint> & state = _stateList[i];
+        state.Remove( NODE_UPDATED );
+
+        if( !state.Contains( NODE_SET ) )
+            continue;
+
+        int parent = _parentList[i];
+        bool parentUpdated = (parent != NO_PARENT) && _stateList[parent].Contains( NODE_UPDATED );
+
+        if( !state.Contains( NODE_CHANGED ) && !parentUpdated )
+            continue;
+
+        CMatrix4 local( _rotationMatrixList[i] );
+        local.Scale( _scaleList[i] );
+        local.SetTranslation( _positionList[i] );
+
+        if( (parent != NO_PARENT) && !state.Contains( NODE_WORLD_SPACE ) )
+            _worldList[i] = _worldList[parent] * local;
+        else
+            _worldList[i] = local;
+
+        state.Remove( NODE_CHANGED | NODE_ROTATION_CHANGED | NODE_WORLD_SPACE );
+        state.Add( NODE_UPDATED );
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Rebuild the rotation portion of every node whose rotation has changed.
+/// The sines and cosines of all the euler angles are worked out together
+/// in one vectorized pass before the matrices are built.
+/// </summary>
+/// *************************************************************************
+void CTransformBatch::UpdateRotations()
+{
+    _rotatedList.clear();
+    _angleList.clear();
+
+    for( size_t i = 0; i < _stateList.size(); ++i )
+    {
+        const CBitmask<uint> & state = _stateList[i];
+
+        if( !state.Contains( NODE_SET ) || !state.Contains( NODE_ROTATION_CHANGED ) )
+            continue;
+
+        _rotationMatrixList[i].Clear();
+
+        // Quaternions don't need any sines or cosines.
+        if( state.Contains( NODE_QUATERNION ) )
+        {
+            _rotationMatrixList[i].SetRotation( _orientationList[i] );
+            continue;
+        }
+
+        // Most rotations only turn about z, so only the z angle is added for them.
+        const CVector3<float> & rotation = _rotationList[i];
+        _rotatedList.push_back( (uint)i );
+
+        if( (rotation.x != 0) || (rotation.y != 0) )
+        {
+            _angleList.push_back( rotation.x );
+            _angleList.push_back( rotation.y );
+        }
+
+        _angleList.push_back( rotation.z );
+    }
+
+    _sinList.resize( _angleList.size() );
+    _cosList.resize( _angleList.size() );
+    NFastTrig::SinCosDeg( _angleList.data(), _sinList.data(), _cosList.data(), (uint)_angleList.size() );
+
+    // Hand the sines and cosines back out in the order the angles were added.
+    size_t angle = 0;
+    for( uint index : _rotatedList )
+    {
+        const CVector3<float> & rotation = _rotationList[index];
+        CVector3<float> sinValue, cosValue( 1 );
+
+        if( (rotation.x != 0) || (rotation.y != 0) )
+        {
+            sinValue.x = _sinList[angle];
+            cosValue.x = _cosList[angle++];
+            sinValue.y = _sinList[angle];
+            cosValue.y = _cosList[angle++];
+        }
+
+        sinValue.z = _sinList[angle];
+        cosValue.z = _cosList[angle++];
+
+        _rotationMatrixList[index].SetRotation( rotation, sinValue, cosValue );
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Whether the node's world matrix was composed by the last call to Compose().
+/// </summary>
+/// <param name="index"> The node. </param>
+/// *************************************************************************
+bool CTransformBatch::IsUpdated( uint index ) const
+{
+    return _stateList[index].Contains( NODE_UPDATED );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the world matrix of a node.
+/// </summary>
+/// <param name="index"> The node. </param>
+/// *************************************************************************
+const CMatrix4 & CTransformBatch::GetWorld( uint index ) const
+{
+    return _worldList[index];
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the number of nodes.
+/// </summary>
+/// *************************************************************************
+uint CTransformBatch::GetSize() const
+{
+    return (uint)_stateList.size();
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#ifndef __transform_batch_h__
+#define __transform_batch_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+#include <common\vector3.h>
+#include <common\matrix4.h>
+#include <common\quaternion.h>
+#include <common\bitmask.h>
+
+// Standard lib dependencies
+#include <vector>
+
+/// *************************************************************************
+/// <summary>
+/// Class to compose the world matrices of a hierarchy in one pass. The
+/// local translation, rotation and scale of each node are held in flat
+/// arrays, along with the index of the node's parent. Nodes are ordered so
+/// every parent comes before its children. Nodes are added at the end and
+/// the list is reordered as a whole, so it can follow the owner's list. Only nodes that have changed, or
+/// whose parent has changed, are composed again, and the rotation portion
+/// of a node is only rebuilt when its rotation has changed. A node's
+/// rotation can be given as euler angles or as a quaternion.
+/// </summary>
+/// *************************************************************************
+class CTransformBatch
+{
+public:
+
+    // Index of the parent of a node without one.
+    static const int NO_PARENT = -1;
+
+    // Constructor
+    CTransformBatch();
+
+    // Destructor
+    ~CTransformBatch();
+
+    // Add a node to the end, without a parent.
+    void Add();
+
+    // Keep the listed nodes in the listed order and drop the rest.
+    void Reorder( const std::vector<uint> & orderList );
+
+    // Access functions for the parent of a node. The parent must come before the node.
+    void SetParent( uint index, int parent );
+    int GetParent( uint index ) const;
+
+    // Whether the node's transformation has been set since it was added.
+    bool IsSet( uint index ) const;
+
+    // Set the local transformation of a node.
+    void Set( uint index,
+              const CVector3<float> & position,
+              const CVector3<float> & rotation,
+              const CVector3<float> & scale,
+              bool worldSpace = false );
+
+    void Set( uint index,
+              const CVector3<float> & position,
+              const CQuaternion & orientation,
+              const CVector3<float> & scale,
+              bool worldSpace = false );
+
+    // Compose the world matrix of every node that has changed.
+    void Compose();
+
+    // Whether the node's world matrix was composed by the last call to Compose().
+    bool IsUpdated( uint index ) const;
+
+    // Get the world matrix of a node.
+    const CMatrix4 & GetWorld( uint index ) const;
+
+    // Get the number of nodes.
+    uint GetSize() const;
+
+private:
+
+    // Set the translation and scale of a node and mark it as changed.
+    void SetTransform( uint index, const CVector3<float> & position, const CVector3<float> & scale, bool worldSpace );
+
+    // Rebuild the rotation portion of every node whose rotation has changed.
+    void UpdateRotations();
+
+private:
+
+    // State of each node.
+    enum
+    {
+        NODE_SET = 1,
+        NODE_CHANGED = 1 << 1,
+        NODE_ROTATION_CHANGED = 1 << 2,
+        NODE_WORLD_SPACE = 1 << 3,
+        NODE_UPDATED = 1 << 4,
+        NODE_QUATERNION = 1 << 5
+    };
+
+    // Index of the parent of each node.
+    std::vector<int> _parentList;
+
+    // Local transformation of each node.
+    std::vector<CVector3<float>> _positionList;
+    std::vector<CVector3<float>> _rotationList;
+    std::vector<CVector3<float>> _scaleList;
+
+    // Rotation of each node that keeps its rotation as a quaternion.
+    std::vector<CQuaternion> _orientationList;
+
+    // Rotation portion of each node's matrix, kept until the rotation changes.
+    std::vector<CMatrix4> _rotationMatrixList;
+
+    // Nodes whose euler rotation is being rebuilt, with their angles and the
+    // sines and cosines of them. Kept between calls to save allocating them.
+    std::vector<uint> _rotatedList;
+    std::vector<float> _angleList;
+    std::vector<float> _sinList;
+    std::vector<float> _cosList;
+
+    // World matrix of each node.
+    std::vector<CMatrix4> _worldList;
+
+    // State flags of each node.
+    std::vector<CBitmask<uint>> _stateList;
+
+    // New index of each node while reordering. Kept to save allocating it.
+    std::vector<int> _newIndexList;
+};
+
+#endif  // __transform_batch_h__
\ No newline at end of file
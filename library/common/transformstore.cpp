@@ -0,0 +1,226 @@
+// Physical component dependency
+#include "transformstore.h"
+
+// Game lib dependencies
+#include <utilities\deletefuncs.h>
+
+using namespace NDefs;
+
+/// *************************************************************************
+/// <summary>
+/// Constructor
+/// </summary>
+/// *************************************************************************
+CTransformStore::CTransformStore()
+{
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Destructor
+/// </summary>
+/// *************************************************************************
+CTransformStore::~CTransformStore()
+{
+    NDelFunc::DeleteVectorPointers( _pPageList );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Add a page of slots to the store.
+/// </summary>
+/// *************************************************************************
+void CTransformStore::AddPage()
+{
+    uint first = (uint)_pPageList.size() * PAGE_SIZE;
+    _pPageList.push_back( new CPage() );
+
+    // Push the new slots in reverse so the lowest slot is handed out first.
+    for( uint i = PAGE_SIZE; i > 0; --i )
+        _freeList.push_back( first + i - 1 );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Allocate a slot and reset its fields to their default values.
+/// </summary>
+/// <returns> The allocated slot. </returns>
+/// *************************************************************************
+uint CTransformStore::Allocate()
+{
+    if( _freeList.empty() )
+        AddPage();
+
+    uint slot = _freeList.back();
+    _freeList.pop_back();
+    ++_count;
+
+    CPage * pPage = _pPageList[slot / PAGE_SIZE];
+    uint index = slot % PAGE_SIZE;
+
+    pPage->position[index] = 0;
+    pPage->rotation[index] = 0;
+    pPage->size[index] = 0;
+    pPage->scale[index] = 1;
+    pPage->color[index] = 1;
+    pPage->visible[index] = true;
+    pPage->modified[index] = ETT_NULL;
+    pPage->worldPosition[index] = 0;
+    pPage->worldRotation[index] = 0;
+    pPage->worldScale[index] = 1;
+    pPage->worldColor[index] = 1;
+    pPage->worldVisible[index] = true;
+
+    return slot;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Return a slot to the store so it can be reused.
+/// </summary>
+/// <param name="slot"> The slot to release. </param>
+/// *************************************************************************
+void CTransformStore::Release( uint slot )
+{
+    _freeList.push_back( slot );
+    --_count;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Access functions for the fields of a slot.
+/// </summary>
+/// <param name="slot"> The slot of the object. </param>
+/// *************************************************************************
+CVector3<float> & CTransformStore::GetPos( uint slot )
+{
+    return _pPageList[slot / PAGE_SIZE]->position[slot % PAGE_SIZE];
+}
+
+// Get the rotation of the slot.
+CVector3<float> & CTransformStore::GetRot( uint slot )
+{
+    return _pPageList[slot / PAGE_SIZE]->rotation[slot % PAGE_SIZE];
+}
+
+// Get the size of the slot.
+CVector3<float> & CTransformStore::GetSize( uint slot )
+{
+    return _pPageList[slot / PAGE_SIZE]->size[slot % PAGE_SIZE];
+}
+
+// Get the scale of the slot.
+CVector3<float> & CTransformStore::GetScale( uint slot )
+{
+    return _pPageList[slot / PAGE_SIZE]->scale[slot % PAGE_SIZE];
+}
+
+// Get the color of the slot.
+CVector4<float> & CTransformStore::GetColor( uint slot )
+{
+    return _pPageList[slot / PAGE_SIZE]->color[slot % PAGE_SIZE];
+}
+
+// Get the visibility of the slot.
+bool & CTransformStore::GetVisible( uint slot )
+{
+    return _pPageList[slot / PAGE_SIZE]->visible[slot % PAGE_SIZE];
+}
+
+// Get the modified bitmask of the slot.
+CBitmask<uint> & CTransformStore::GetModified( uint slot )
+{
+    return _pPageList[slot / PAGE_SIZE]->modified[slot % PAGE_SIZE];
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Access functions for the world-space fields of a slot. These are only
+/// written when the object is transformed.
+/// </summary>
+/// <param name="slot"> The slot of the object. </param>
+/// *************************************************************************
+CVector3<float> & CTransformStore::GetWorldPos( uint slot )
+{
+    return _pPageList[slot / PAGE_SIZE]->worldPosition[slot % PAGE_SIZE];
+}
+
+// Get the world rotation of the slot.
+CVector3<float> & CTransformStore::GetWorldRot( uint slot )
+{
+    return _pPageList[slot / PAGE_SIZE]->worldRotation[slot % PAGE_SIZE];
+}
+
+// Get the world scale of the slot.
+CVector3<float> & CTransformStore::GetWorldScale( uint slot )
+{
+    return _pPageList[slot / PAGE_SIZE]->worldScale[slot % PAGE_SIZE];
+}
+
+// Get the world color of the slot.
+CVector4<float> & CTransformStore::GetWorldColor( uint slot )
+{
+    return _pPageList[slot / PAGE_SIZE]->worldColor[slot % PAGE_SIZE];
+}
+
+// Get the world visibility of the slot.
+bool & CTransformStore::GetWorldVisible( uint slot )
+{
+    return _pPageList[slot / PAGE_SIZE]->worldVisible[slot % PAGE_SIZE];
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Record that the parent of the object with the handle has changed. The
+/// sprite manager takes the handles to keep its parents before their
+/// children, so objects don't need to know which manager owns them.
+/// </summary>
+/// <param name="handle"> Handle the sprite manager has given the object. </param>
+/// *************************************************************************
+void CTransformStore::AddParentChange( uint handle )
+{
+    _parentChangeList.push_back( handle );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Move the handles of the objects whose parent has changed onto the end
+/// of the list, and clear them from the store.
+/// </summary>
+/// <param name="handleList"> List to add the handles to. </param>
+/// *************************************************************************
+void CTransformStore::TakeParentChanges( std::vector<uint> & handleList )
+{
+    handleList.insert( handleList.end(), _parentChangeList.begin(), _parentChangeList.end() );
+    _parentChangeList.clear();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the number of slots in use.
+/// </summary>
+/// *************************************************************************
+uint CTransformStore::GetCount() const
+{
+    return _count;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the number of slots allocated.
+/// </summary>
+/// *************************************************************************
+uint CTransformStore::GetCapacity() const
+{
+    return (uint)_pPageList.size() * PAGE_SIZE;
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#ifndef __transform_store_h__
+#define __transform_store_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+#include <common\vector3.h>
+#include <common\vector4.h>
+#include <common\bitmask.h>
+
+// Standard lib dependencies
+#include <vector>
+
+/// *************************************************************************
+/// <summary>
+/// Class to hold the transformation data of every object in contiguous
+/// per-field arrays. Objects are given a slot in the store and read and
+/// write their fields through it, so passes over all of the objects can
+/// walk each field linearly instead of jumping between heap objects.
+/// </summary>
+/// *************************************************************************
+class CTransformStore
+{
+public:
+    // Get the instance of the singleton class
+    static CTransformStore & Instance()
+    {
+        static CTransformStore transformStore;
+        return transformStore;
+    }
+
+    // Number of slots held by each page of the store.
+    static const uint PAGE_SIZE = 1024;
+
+    // Allocate a slot and reset its fields to their default values.
+    uint Allocate();
+
+    // Return a slot to the store so it can be reused.
+    void Release( uint slot );
+
+    // Access functions for the fields of a slot.
+    CVector3<float> & GetPos( uint slot );
+    CVector3<float> & GetRot( uint slot );
+    CVector3<float> & GetSize( uint slot );
+    CVector3<float> & GetScale( uint slot );
+    CVector4<float> & GetColor( uint slot );
+    bool & GetVisible( uint slot );
+    CBitmask<uint> & GetModified( uint slot );
+
+    // Access functions for the world-space fields of a slot, as of the last transform.
+    CVector3<float> & GetWorldPos( uint slot );
+    CVector3<float> & GetWorldRot( uint slot );
+    CVector3<float> & GetWorldScale( uint slot );
+    CVector4<float> & GetWorldColor( uint slot );
+    bool & GetWorldVisible( uint slot );
+
+    // Record that the parent of the object with the handle has changed.
+    void AddParentChange( uint handle );
+
+    // Move the handles of the objects whose parent has changed onto the list.
+    void TakeParentChanges( std::vector<uint> & handleList );
+
+    // Get the number of slots in use and the number of slots allocated.
+    uint GetCount() const;
+    uint GetCapacity() const;
+
+private:
+
+    CTransformStore();
+    virtual ~CTransformStore();
+
+    // Add a page of slots to the store.
+    void AddPage();
+
+private:
+
+    /// *************************************************************************
+    /// <summary>
+    /// Block of slots. Each field is stored in its own array so the page
+    /// holds the fields of PAGE_SIZE objects back to back. Pages are never
+    /// moved once allocated, so references into them stay valid.
+    /// </summary>
+    /// *************************************************************************
+    class CPage
+    {
+    public:
+
+        CVector3<float> position[PAGE_SIZE];
+        CVector3<float> rotation[PAGE_SIZE];
+        CVector3<float> size[PAGE_SIZE];
+        CVector3<float> scale[PAGE_SIZE];
+        CVector4<float> color[PAGE_SIZE];
+        bool visible[PAGE_SIZE];
+        CBitmask<uint> modified[PAGE_SIZE];
+
+        // World-space values, combined with the parents' when transformed.
+        CVector3<float> worldPosition[PAGE_SIZE];
+        CVector3<float> worldRotation[PAGE_SIZE];
+        CVector3<float> worldScale[PAGE_SIZE];
+        CVector4<float> worldColor[PAGE_SIZE];
+        bool worldVisible[PAGE_SIZE];
+    };
+
+    // List of allocated pages.
+    std::vector<CPage *> _pPageList;
+
+    // List of released slots waiting to be reused.
+    std::vector<uint> _freeList;
+
+    // Number of slots in use.
+    uint _count = 0;
+
+    // Handles of the objects whose parent has changed since they were last taken.
+    std::vector<uint> _parentChangeList;
+};
+
+#endif  // __transform_store_h__
\ No newline at end of file
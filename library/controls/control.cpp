@@ -4,6 +4,7 @@
 // Game lib dependencies
 #include <agk.h>
 #include <common\matrix4.h>
+#include <common\commandbuffer.h>
 #include <controls\controldata.h>
 #include <utilities\mathfunc.h>
 #include <utilities\exceptionhandling.h>
@@ -68,6 +69,7 @@ void iControl::DeleteObject()
 {
     if( _id > 0 )
     {
+        CCommandBuffer::Instance().Discard( CCommandBuffer::SPRITE, _id );
         agk::DeleteSprite( _id );
 
         _id = 0;
@@ -115,15 +117,8 @@ const CControlData * iControl::GetData() const
 /// *************************************************************************
 void iControl::ApplyPosition()
 {
-    if( _pParent )
-    {
-        CVector2<float> newPos = *_pParent->GetMatrix() * _position;
-        agk::SetSpritePosition( _id, newPos.x, newPos.y );
-    }
-    else
-        agk::SetSpritePosition( _id, _position.x, _position.y );
-
-    agk::SetSpriteDepth( _id, (int)(_position.z + 0.5f) );
+    CCommandBuffer::Instance().Add( CCommandBuffer::SPRITE_POSITION, _id, _worldPosition.x, _worldPosition.y );
+    CCommandBuffer::Instance().Add( CCommandBuffer::SPRITE_DEPTH, _id, (int)(_position.z + 0.5f) );
 }
 
 
@@ -134,12 +129,7 @@ void iControl::ApplyPosition()
 /// *************************************************************************
 void iControl::ApplyRotation()
 {
-    _rotation %= 360;
-
-    if( _pParent )
-        agk::SetSpriteAngle( _id, _pParent->GetWorldRot().z + _rotation.z );
-    else
-        agk::SetSpriteAngle( _id, _rotation.z );
+    CCommandBuffer::Instance().Add( CCommandBuffer::SPRITE_ANGLE, _id, _worldRotation.z );
 }
 
 
@@ -150,13 +140,7 @@ void iControl::ApplyRotation()
 /// *************************************************************************
 void iControl::ApplyScale()
 {
-    if( _pParent )
-    {
-        CVector2<float> newScale = _pParent->GetWorldScale() * _scale;
-        agk::SetSpriteScale( _id, newScale.w, newScale.h );
-    }
-    else
-        agk::SetSpriteScale( _id, _scale.w, _scale.h );
+    CCommandBuffer::Instance().Add( CCommandBuffer::SPRITE_SCALE, _id, _worldScale.w, _worldScale.h );
 }
 
 
@@ -184,37 +168,37 @@ void iControl::ApplyVisibility()
 
 /// *************************************************************************
 /// <summary>
-/// Get the current position set in AGK.
+/// Get the world position. The depth isn't affected by the parent.
 /// </summary>
 /// *************************************************************************
 CVector3<float> iControl::GetWorldPos() const
 {
-    return CVector3<float>( agk::GetSpriteX( _id ),
-                            agk::GetSpriteY( _id ),
-                            (float)agk::GetSpriteDepth( _id ) );
+    return CVector3<float>( _worldPosition.x, _worldPosition.y, _position.z );
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Get the current rotation set in AGK.
+/// Get the current world rotation.
 /// </summary>
 /// *************************************************************************
 CVector3<float> iControl::GetWorldRot() const
 {
-    return CVector3<float>( 0, 0, agk::GetSpriteAngle( _id ) );
+    return CVector3<float>( 0, 0, _worldRotation.z );
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Get the current size set in AGK.
+/// Get the world size.
 /// </summary>
 /// *************************************************************************
 CVector3<float> iControl::GetWorldSize() const
 {
-    return CVector3<float>( agk::GetSpriteWidth( _id ),
-                            agk::GetSpriteHeight( _id ) );
+    if( _pParent )
+        return _size * _pParent->GetWorldScale();
+
+    return _size;
 }
 
 
@@ -240,19 +224,6 @@ void iControl::UpdateScale()
 }
 
 
-/// *************************************************************************
-/// <summary>
-/// Get the control's visibility.
-/// </summary>
-/// *************************************************************************
-bool iControl::IsVisible() const
-{
-    if( _pParent )
-        return _pParent->IsVisible() && _visible;
-
-    return _visible;
-}
-
 
 /// *************************************************************************
 /// <summary>
@@ -43,7 +43,7 @@ public:
     // Get the data used to create the control.
     const CControlData * GetData() const;
 
-    // Get the current transformation data set in AGK.
+    // Get the world-space transformation data as of the last transform.
     virtual CVector3<float> GetWorldPos() const;
     virtual CVector3<float> GetWorldRot() const;
     virtual CVector3<float> GetWorldSize() const;
@@ -52,9 +52,6 @@ public:
     virtual void UpdateSize();
     virtual void UpdateScale();
 
-    // Get the control's visibility.
-    virtual bool IsVisible() const;
-
     // Access functions for the control's alignment.
     virtual void SetAlignment( const CBitmask<uint> & alignment );
     virtual CBitmask<uint> GetAlignment() const;
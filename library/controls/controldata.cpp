@@ -3,6 +3,7 @@
 
 // Game lib dependencies
 #include <common\collectionobject.h>
+#include <utilities\binarydata.h>
 
 using namespace std;
 using namespace nlohmann;
@@ -60,6 +61,51 @@ void CControlData::LoadFromIter( const string & name, json::const_iterator iter
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Write the control data to compiled data, in the order Read() reads it.
+/// </summary>
+/// <param name="writer"> Writer of the compiled data. </param>
+/// *************************************************************************
+void CControlData::Write( CBinaryWriter & writer ) const
+{
+    writer.Write( _type );
+    writer.Write( _size );
+    writer.Write( _sizeSet );
+    writer.Write( _sizeSameAsFile );
+    writer.Write( _state );
+    writer.Write( (uint)_alignment );
+    writer.Write( _animationList );
+    writer.Write( _spriteList );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Read the control data from compiled data.
+/// </summary>
+/// <param name="name"> Name of the data. </param>
+/// <param name="reader"> Reader of the compiled data. </param>
+/// *************************************************************************
+void CControlData::Read( const std::string & name, CBinaryReader & reader )
+{
+    _name = name;
+
+    uint alignment;
+
+    reader.Read( _type );
+    reader.Read( _size );
+    reader.Read( _sizeSet );
+    reader.Read( _sizeSameAsFile );
+    reader.Read( _state );
+    reader.Read( alignment );
+    reader.Read( _animationList );
+    reader.Read( _spriteList );
+
+    _alignment = alignment;
+}
+
+
 /// *************************************************************************
 /// <summary>
 /// Get the control's name.
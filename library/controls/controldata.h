@@ -12,6 +12,8 @@
 #include <vector>
 
 // Forward declarations
+class CBinaryWriter;
+class CBinaryReader;
 class CCollectionObject;
 
 /// *************************************************************************
@@ -29,6 +31,12 @@ public:
     // Load the sprite data from the passed in iterator.
     void LoadFromIter( const std::string & name, nlohmann::json::const_iterator iter );
 
+    // Write the control data to compiled data.
+    void Write( CBinaryWriter & writer ) const;
+
+    // Read the control data from compiled data.
+    void Read( const std::string & name, CBinaryReader & reader );
+
     // Access functions for the text sprite data.
     const std::string & GetName() const;
     const CBitmask<uint> & GetAlignment() const;
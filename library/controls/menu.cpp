@@ -4,6 +4,7 @@
 // Game lib dependencies
 #include <agk.h>
 #include <common\matrix4.h>
+#include <common\commandbuffer.h>
 #include <controls\menudata.h>
 #include <controls\control.h>
 #include <utilities\mathfunc.h>
@@ -71,6 +72,7 @@ void CMenu::DeleteObject()
 {
     if( _id > 0 )
     {
+        CCommandBuffer::Instance().Discard( CCommandBuffer::SPRITE, _id );
         agk::DeleteSprite( _id );
 
         _id = 0;
@@ -118,15 +120,8 @@ const CMenuData * CMenu::GetData() const
 /// *************************************************************************
 void CMenu::ApplyPosition()
 {
-    if( _pParent )
-    {
-        CVector2<float> newPos = *_pParent->GetMatrix() * _position;
-        agk::SetSpritePosition( _id, newPos.x, newPos.y );
-    }
-    else
-        agk::SetSpritePosition( _id, _position.x, _position.y );
-
-    agk::SetSpriteDepth( _id, (int)(_position.z + 0.5f) );
+    CCommandBuffer::Instance().Add( CCommandBuffer::SPRITE_POSITION, _id, _worldPosition.x, _worldPosition.y );
+    CCommandBuffer::Instance().Add( CCommandBuffer::SPRITE_DEPTH, _id, (int)(_position.z + 0.5f) );
 }
 
 
@@ -137,12 +132,7 @@ void CMenu::ApplyPosition()
 /// *************************************************************************
 void CMenu::ApplyRotation()
 {
-    _rotation %= 360;
-
-    if( _pParent )
-        agk::SetSpriteAngle( _id, _pParent->GetWorldRot().z + _rotation.z );
-    else
-        agk::SetSpriteAngle( _id, _rotation.z );
+    CCommandBuffer::Instance().Add( CCommandBuffer::SPRITE_ANGLE, _id, _worldRotation.z );
 }
 
 
@@ -153,13 +143,7 @@ void CMenu::ApplyRotation()
 /// *************************************************************************
 void CMenu::ApplyScale()
 {
-    if( _pParent )
-    {
-        CVector2<float> newScale = _pParent->GetWorldScale() * _scale;
-        agk::SetSpriteScale( _id, newScale.w, newScale.h );
-    }
-    else
-        agk::SetSpriteScale( _id, _scale.w, _scale.h );
+    CCommandBuffer::Instance().Add( CCommandBuffer::SPRITE_SCALE, _id, _worldScale.w, _worldScale.h );
 }
 
 
@@ -187,37 +171,37 @@ void CMenu::ApplyVisibility()
 
 /// *************************************************************************
 /// <summary>
-/// Get the current position set in AGK.
+/// Get the world position. The depth isn't affected by the parent.
 /// </summary>
 /// *************************************************************************
 CVector3<float> CMenu::GetWorldPos() const
 {
-    return CVector3<float>( agk::GetSpriteX( _id ),
-                            agk::GetSpriteY( _id ),
-                            (float)agk::GetSpriteDepth( _id ) );
+    return CVector3<float>( _worldPosition.x, _worldPosition.y, _position.z );
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Get the current rotation set in AGK.
+/// Get the current world rotation.
 /// </summary>
 /// *************************************************************************
 CVector3<float> CMenu::GetWorldRot() const
 {
-    return CVector3<float>( 0, 0, agk::GetSpriteAngle( _id ) );
+    return CVector3<float>( 0, 0, _worldRotation.z );
 }
 
 
 /// *************************************************************************
 /// <summary>
-/// Get the current size set in AGK.
+/// Get the world size.
 /// </summary>
 /// *************************************************************************
 CVector3<float> CMenu::GetWorldSize() const
 {
-    return CVector3<float>( agk::GetSpriteWidth( _id ),
-                            agk::GetSpriteHeight( _id ) );
+    if( _pParent )
+        return _size * _pParent->GetWorldScale();
+
+    return _size;
 }
 
 
@@ -243,19 +227,6 @@ void CMenu::UpdateScale()
 }
 
 
-/// *************************************************************************
-/// <summary>
-/// Get the menu's visibility.
-/// </summary>
-/// *************************************************************************
-bool CMenu::IsVisible() const
-{
-    if( _pParent )
-        return _pParent->IsVisible() && _visible;
-
-    return _visible;
-}
-
 
 /// *************************************************************************
 /// <summary>
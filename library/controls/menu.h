@@ -46,7 +46,7 @@ public:
     // Get the data used to create the menu.
     const CMenuData * GetData() const;
 
-    // Get the current transformation data set in AGK.
+    // Get the world-space transformation data as of the last transform.
     virtual CVector3<float> GetWorldPos() const;
     virtual CVector3<float> GetWorldRot() const;
     virtual CVector3<float> GetWorldSize() const;
@@ -55,9 +55,6 @@ public:
     virtual void UpdateSize();
     virtual void UpdateScale();
 
-    // Get the menu's visibility.
-    virtual bool IsVisible() const;
-
     // Access functions for the menu's alignment.
     virtual void SetAlignment( const CBitmask<uint> & alignment );
     virtual CBitmask<uint> GetAlignment() const;
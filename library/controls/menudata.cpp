@@ -3,6 +3,7 @@
 
 // Game lib dependencies
 #include <common\collectionobject.h>
+#include <utilities\binarydata.h>
 
 using namespace std;
 using namespace nlohmann;
@@ -59,6 +60,51 @@ void CMenuData::LoadFromIter( const string & name, json::const_iterator iter )
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Write the menu data to compiled data, in the order Read() reads it.
+/// </summary>
+/// <param name="writer"> Writer of the compiled data. </param>
+/// *************************************************************************
+void CMenuData::Write( CBinaryWriter & writer ) const
+{
+    writer.Write( _size );
+    writer.Write( _sizeSet );
+    writer.Write( _sizeSameAsFile );
+    writer.Write( _enabled );
+    writer.Write( (uint)_alignment );
+    writer.Write( _animationList );
+    writer.Write( _spriteList );
+    writer.Write( _controlList );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Read the menu data from compiled data.
+/// </summary>
+/// <param name="name"> Name of the data. </param>
+/// <param name="reader"> Reader of the compiled data. </param>
+/// *************************************************************************
+void CMenuData::Read( const std::string & name, CBinaryReader & reader )
+{
+    _name = name;
+
+    uint alignment;
+
+    reader.Read( _size );
+    reader.Read( _sizeSet );
+    reader.Read( _sizeSameAsFile );
+    reader.Read( _enabled );
+    reader.Read( alignment );
+    reader.Read( _animationList );
+    reader.Read( _spriteList );
+    reader.Read( _controlList );
+
+    _alignment = alignment;
+}
+
+
 /// *************************************************************************
 /// <summary>
 /// Get the menu's name.
@@ -0,0 +1,117 @@
+// Physical component dependency
+#include "animationmanager.h"
+
+// Game lib dependencies
+#include <script\animationcomponent.h>
+
+using namespace std;
+
+/// *************************************************************************
+/// <summary>
+/// Constructor
+/// </summary>
+/// *************************************************************************
+CAnimationManager::CAnimationManager()
+{
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Destructor. The components are let go of, so any destroyed after the
+/// manager don't try to remove themselves.
+/// </summary>
+/// *************************************************************************
+CAnimationManager::~CAnimationManager()
+{
+    for( auto pComponent : _pActiveList )
+        if( pComponent )
+            pComponent->_activeIndex = -1;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Add the component to the list to update. Does nothing if it's already
+/// on it.
+/// </summary>
+/// <param name="pComponent"> The component to add. </param>
+/// *************************************************************************
+void CAnimationManager::Add( CAnimationComponent * pComponent )
+{
+    if( pComponent->_activeIndex >= 0 )
+        return;
+
+    pComponent->_activeIndex = (int)_pActiveList.size();
+    _pActiveList.push_back( pComponent );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Take the component off the list to update. Its place is left empty
+/// until the list is compacted after the next update.
+/// </summary>
+/// <param name="pComponent"> The component to remove. </param>
+/// *************************************************************************
+void CAnimationManager::Remove( CAnimationComponent * pComponent )
+{
+    if( pComponent->_activeIndex < 0 )
+        return;
+
+    _pActiveList[pComponent->_activeIndex] = nullptr;
+    pComponent->_activeIndex = -1;
+    ++_removedCount;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Update the active animation components. Components added while updating
+/// are updated this frame too.
+/// </summary>
+/// *************************************************************************
+void CAnimationManager::Update()
+{
+    for( size_t i = 0; i < _pActiveList.size(); ++i )
+        if( _pActiveList[i] )
+            _pActiveList[i]->Update();
+
+    Compact();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the number of active animation components.
+/// </summary>
+/// *************************************************************************
+uint CAnimationManager::GetActiveCount() const
+{
+    return (uint)_pActiveList.size() - _removedCount;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Close the gaps left by removed components, keeping the rest in order.
+/// </summary>
+/// *************************************************************************
+void CAnimationManager::Compact()
+{
+    if( _removedCount == 0 )
+        return;
+
+    size_t count = 0;
+    for( auto pComponent : _pActiveList )
+    {
+        if( pComponent )
+        {
+            pComponent->_activeIndex = (int)count;
+            _pActiveList[count++] = pComponent;
+        }
+    }
+
+    _pActiveList.resize( count );
+    _removedCount = 0;
+}
\ No newline at end of file
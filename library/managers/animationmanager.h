@@ -0,0 +1,66 @@
+#ifndef __animation_manager_h__
+#define __animation_manager_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+
+// Standard lib dependencies
+#include <vector>
+
+// Forward declaration(s)
+class CAnimationComponent;
+
+/// *************************************************************************
+/// <summary>
+/// Class to update the animation components that have something playing.
+/// Components add themselves when an animation is queued, stopped or woken
+/// up, and are dropped once nothing they play is awake, so a frame only
+/// costs as much as the animations that are running, no matter how many
+/// objects there are or how many scripts are asleep.
+/// </summary>
+/// *************************************************************************
+class CAnimationManager
+{
+public:
+
+    // Get the instance of the singleton class.
+    static CAnimationManager & Instance()
+    {
+        static CAnimationManager animationManager;
+        return animationManager;
+    }
+
+    // Add the component to the list to update.
+    void Add( CAnimationComponent * pComponent );
+
+    // Take the component off the list to update.
+    void Remove( CAnimationComponent * pComponent );
+
+    // Update the active animation components.
+    void Update();
+
+    // Get the number of active animation components.
+    uint GetActiveCount() const;
+
+private:
+
+    // Constructor
+    CAnimationManager();
+
+    // Destructor
+    virtual ~CAnimationManager();
+
+    // Close the gaps left by removed components.
+    void Compact();
+
+private:
+
+    // Components with animations queued or awake. Removed ones leave a null
+    // until the list is compacted, so the list can change while it's updated.
+    std::vector<CAnimationComponent *> _pActiveList;
+
+    // Number of null entries in the active list.
+    uint _removedCount = 0;
+};
+
+#endif  // __animation_manager_h__
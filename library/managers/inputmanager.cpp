@@ -5,9 +5,8 @@
 #include <agk.h>
 #include <utilities\jsonparsehelper.h>
 #include <utilities\exceptionhandling.h>
-
-// Standard lib dependencies
-#include <fstream>
+#include <utilities\arena.h>
+#include <utilities\datafile.h>
 
 using namespace std;
 using namespace nlohmann;
@@ -134,12 +133,13 @@ void CInputManager::LoadInputMap()
 {
     try
     {
-        // Load the settings file.
-        ifstream ifile( _path );
+        // Parse the input file into a json object, built in an arena and
+        // freed with it in one go. The file is read out of the archive if
+        // it's packed.
+        CArenaScope arenaScope;
 
-        // Parse the content into a json object.
         json j;
-        ifile >> j;
+        CDataFile( _path ).GetJson( j );
 
         auto inputStateListIter = j.find( "inputStateList" );
         if( inputStateListIter != j.end() )
@@ -6,7 +6,11 @@
 #include <controls\menudata.h>
 #include <controls\control.h>
 #include <controls\controldata.h>
+#include <common\transformstore.h>
+#include <common\commandbuffer.h>
 #include <utilities\jsonparsehelper.h>
+#include <utilities\datafile.h>
+#include <utilities\preloader.h>
 #include <utilities\generalfuncs.h>
 #include <utilities\deletefuncs.h>
 
@@ -24,6 +28,10 @@ using namespace NDefs;
 /// *************************************************************************
 CMenuManager::CMenuManager()
 {
+    // The objects release their slots and pending commands when deleted,
+    // so the store and the command buffer have to outlive the manager.
+    CTransformStore::Instance();
+    CCommandBuffer::Instance();
 }
 
 
@@ -113,23 +121,12 @@ CMenuData * CMenuManager::GetMenuData( const std::string & name )
         // If not, load the sprite data.
         const string & filepath = NGeneralFuncs::GetMapValue( name, _menuDataFileList );
 
-        // Load the sprite data file.
-        ifstream ifile( filepath );
-
-        // Parse the content into a json object.
-        json j;
-        ifile >> j;
-
-        auto menuIter = j.find( "menu" );
-        if( menuIter != j.end() )
-        {
-            CMenuData * pData = new CMenuData();
+        // Load the data file, compiled or json.
+        CMenuData * pData = CDataFile( filepath ).Load<CMenuData>( name, EDT_MENU, "menu" );
+        if( pData )
             _pMenuDataList.emplace( name, pData );
 
-            pData->LoadFromIter( name, menuIter );
-
-            return pData;
-        }
+        return pData;
     }
     catch( exception e )
     {
@@ -159,23 +156,12 @@ CControlData * CMenuManager::GetControlData( const std::string & name )
         // If not, load the sprite data.
         const string & filepath = NGeneralFuncs::GetMapValue( name, _controlDataFileList );
 
-        // Load the sprite data file.
-        ifstream ifile( filepath );
-
-        // Parse the content into a json object.
-        json j;
-        ifile >> j;
-
-        auto controlIter = j.find( "menu" );
-        if( controlIter != j.end() )
-        {
-            CControlData * pData = new CControlData();
+        // Load the data file, compiled or json.
+        CControlData * pData = CDataFile( filepath ).Load<CControlData>( name, EDT_CONTROL, "menu" );
+        if( pData )
             _pControlDataList.emplace( name, pData );
 
-            pData->LoadFromIter( name, controlIter );
-
-            return pData;
-        }
+        return pData;
     }
     catch( exception e )
     {
@@ -188,6 +174,27 @@ CControlData * CMenuManager::GetControlData( const std::string & name )
 }
 
 
+/// *************************************************************************
+/// <summary> 
+/// Add jobs to load the menu/control data that isn't loaded yet.
+/// </summary>
+/// <param name="preloader"> Preloader to add the jobs to. </param>
+/// *************************************************************************
+void CMenuManager::Preload( CPreloader & preloader )
+{
+    function<CMenuData *( const string &, const string & )> loadMenu =
+        []( const string & name, const string & filePath )
+        { return CDataFile( filePath ).Load<CMenuData>( name, EDT_MENU, "menu" ); };
+
+    function<CControlData *( const string &, const string & )> loadControl =
+        []( const string & name, const string & filePath )
+        { return CDataFile( filePath ).Load<CControlData>( name, EDT_CONTROL, "menu" ); };
+
+    preloader.Add( "menu", _menuDataFileList, _pMenuDataList, loadMenu );
+    preloader.Add( "control", _controlDataFileList, _pControlDataList, loadControl );
+}
+
+
 /// *************************************************************************
 /// <summary> 
 /// Create the menu.
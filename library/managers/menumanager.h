@@ -15,6 +15,7 @@ class CMenuData;
 class iObject;
 class iControl;
 class CMenu;
+class CPreloader;
 
 /// *************************************************************************
 /// <summary> 
@@ -42,6 +43,9 @@ public:
     CMenuData * GetMenuData( const std::string & name );
     CControlData * GetControlData( const std::string & name );
 
+    // Add jobs to load the menu/control data that isn't loaded yet.
+    void Preload( CPreloader & preloader );
+
     // Create the menu/control.
     CMenu * CreateMenu( const std::string & name, const std::string & key = "" );
     iControl * CreateControl( const std::string & name, const std::string & key = "" );
@@ -5,12 +5,56 @@
 #include <agk.h>
 #include <utilities\generalfuncs.h>
 #include <utilities\exceptionhandling.h>
+#include <utilities\deletefuncs.h>
+#include <utilities\threadpool.h>
 
 // Standard lib dependencies
 #include <fstream>
+#include <vector>
+#include <chrono>
+#include <algorithm>
 
 using namespace std;
 
+namespace
+{
+    // Size of the chunks the workers read the files in.
+    const size_t READ_BUFFER_SIZE = 64 * 1024;
+
+    /// *************************************************************************
+    /// <summary>
+    /// Read through a file on a worker thread. AGK can only load resources on
+    /// the main thread and only from a path, so the data isn't kept. Reading
+    /// it brings the file into the system's cache, so the main thread doesn't
+    /// wait on the disk when it loads it.
+    /// </summary>
+    /// <param name="path"> Path to the file. </param>
+    /// *************************************************************************
+    void ReadFile( const string & path )
+    {
+        ifstream file( path, ios::binary );
+        vector<char> buffer( READ_BUFFER_SIZE );
+
+        while( file.read( buffer.data(), buffer.size() ) )
+        {
+        }
+    }
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get the size of a file, as an estimate of the memory its data uses.
+    /// </summary>
+    /// <param name="path"> Path to the file. </param>
+    /// *************************************************************************
+    size_t GetFileSize( const string & path )
+    {
+        ifstream file( path, ios::binary | ios::ate );
+        streamoff size = file.tellg();
+
+        return (size > 0) ? (size_t)size : 0;
+    }
+}
+
 /// *************************************************************************
 /// <summary> 
 /// Constructor
@@ -28,6 +72,9 @@ CResourceManager::CResourceManager()
 /// *************************************************************************
 CResourceManager::~CResourceManager()
 {
+    // Stop the workers before the loads they're reading for are freed.
+    NDelFunc::Delete( _pThreadPool );
+
     Clear();
 }
 
@@ -66,7 +113,9 @@ void CResourceManager::LoadImageList( const std::string & path )
     // Add an extra resource for a solid image.
     CResourceFile solidImage;
     solidImage.id = agk::CreateImageColor( 255, 255, 255, 255 );
-    _imageList.emplace( "", solidImage );
+    auto result = _imageList.emplace( "", solidImage );
+    if( result.second )
+        AddResident( NDefs::ERT_IMAGE, result.first->second );
 }
 
 
@@ -94,7 +143,12 @@ uint CResourceManager::LoadMesh( const std::string & name )
 
     // If the mesh hasn't been loaded yet, load it.
     if( resource.id == 0 )
+    {
         resource.id = agk::LoadObject( resource.path.c_str() );
+        AddResident( NDefs::ERT_MESH, resource );
+    }
+
+    resource.lastUsed = ++_useCount;
 
     return resource.id;
 }
@@ -113,7 +167,12 @@ uint CResourceManager::LoadAnimatedMesh( const std::string & name )
 
     // If the animated mesh hasn't been loaded yet, load it.
     if( resource.id == 0 )
+    {
         resource.id = agk::LoadObjectWithChildren( resource.path.c_str() );
+        AddResident( NDefs::ERT_ANIMATED_MESH, resource );
+    }
+
+    resource.lastUsed = ++_useCount;
 
     return resource.id;
 }
@@ -132,13 +191,19 @@ uint CResourceManager::LoadImage( const std::string & name )
 
     // If the image hasn't been loaded yet, load it.
     if( resource.id == UNLOADED_ID )
+    {
         resource.id = agk::LoadImage( resource.path.c_str() );
+        AddResident( NDefs::ERT_IMAGE, resource );
+    }
     else if( resource.id == UNLOADED_SUBIMAGE_ID )
     {
         uint parentId = LoadImage( resource.path );
         resource.id = agk::LoadSubImage( parentId, name.c_str() );
+        AddResident( NDefs::ERT_IMAGE, resource );
     }
 
+    resource.lastUsed = ++_useCount;
+
     return resource.id;
 }
 
@@ -154,14 +219,548 @@ uint CResourceManager::LoadFont( const std::string & name )
 {
     auto & resource = NGeneralFuncs::GetMapValue( name, _fontList );
 
-    // If the animated mesh hasn't been loaded yet, load it.
+    // If the font hasn't been loaded yet, load it.
     if( resource.id == 0 )
+    {
         resource.id = agk::LoadFont( resource.path.c_str() );
+        AddResident( NDefs::ERT_FONT, resource );
+    }
+
+    resource.lastUsed = ++_useCount;
 
     return resource.id;
 }
 
 
+/// *************************************************************************
+/// <summary> 
+/// Load the resource if not loaded and add a reference to it. Referenced
+/// resources are never evicted. Acquiring a sub image also references its
+/// parent image.
+/// </summary>
+/// <param name="type"> Type of resource. </param>
+/// <param name="name"> Name of the resource. </param>
+/// <returns> Loaded resource id. </returns>
+/// *************************************************************************
+uint CResourceManager::Acquire( NDefs::EResourceType type, const std::string & name )
+{
+    uint id = Load( type, name );
+
+    CResourceFile & resource = GetResource( type, name );
+    ++resource.refCount;
+
+    if( resource.subImage )
+        ++GetResource( NDefs::ERT_IMAGE, resource.path ).refCount;
+
+    return id;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Remove a reference to the resource. The resource stays loaded so it can
+/// be used again without a reload, until it's evicted to stay within the
+/// budget or cleared.
+/// </summary>
+/// <param name="type"> Type of resource. </param>
+/// <param name="name"> Name of the resource. </param>
+/// *************************************************************************
+void CResourceManager::Release( NDefs::EResourceType type, const std::string & name )
+{
+    CResourceFile & resource = GetResource( type, name );
+
+    if( resource.refCount > 0 )
+    {
+        --resource.refCount;
+
+        if( resource.subImage )
+        {
+            CResourceFile & parent = GetResource( NDefs::ERT_IMAGE, resource.path );
+            if( parent.refCount > 0 )
+                --parent.refCount;
+        }
+    }
+
+    resource.lastUsed = ++_useCount;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Set the number of bytes the type's resources may use. Once they use more,
+/// Trim() evicts the unreferenced ones. Referenced resources are kept even
+/// if they alone are over the budget.
+/// </summary>
+/// <param name="type"> Type of resource. </param>
+/// <param name="bytes"> The budget. Zero is no limit. </param>
+/// *************************************************************************
+void CResourceManager::SetBudget( NDefs::EResourceType type, size_t bytes )
+{
+    _budgetList[type] = bytes;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Evict unreferenced resources, least recently used first, until the type
+/// is within its budget. Sub images share their parent's memory, so they're
+/// evicted along with the parent. Resources without a file, like the solid
+/// image, can't be loaded again and are never evicted.
+/// </summary>
+/// <param name="type"> Type of resource to trim. Null trims all of them. </param>
+/// *************************************************************************
+void CResourceManager::Trim( NDefs::EResourceType type )
+{
+    if( type == NDefs::ERT_NULL )
+    {
+        for( int i = NDefs::ERT_NULL + 1; i < RESOURCE_TYPE_COUNT; ++i )
+            Trim( NDefs::EResourceType( i ) );
+
+        return;
+    }
+
+    CResourceStats & stats = _statsList[type];
+    size_t budget = _budgetList[type];
+
+    if( (budget == 0) || (stats.residentBytes <= budget) )
+        return;
+
+    // Gather the resources that can be evicted, oldest first.
+    vector<map<const string, CResourceFile>::iterator> evictList;
+
+    auto & resourceList = GetResourceList( type );
+    for( auto iter = resourceList.begin(); iter != resourceList.end(); ++iter )
+    {
+        CResourceFile & resource = iter->second;
+
+        if( IsLoaded( type, resource ) && (resource.refCount == 0) && !resource.subImage && !resource.path.empty() )
+            evictList.push_back( iter );
+    }
+
+    sort( evictList.begin(), evictList.end(),
+        []( const map<const string, CResourceFile>::iterator & a, const map<const string, CResourceFile>::iterator & b )
+        { return a->second.lastUsed < b->second.lastUsed; } );
+
+    for( auto & iter : evictList )
+    {
+        if( stats.residentBytes <= budget )
+            break;
+
+        Unload( type, iter->first, iter->second );
+        iter->second.evicted = true;
+        ++stats.evictCount;
+    }
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Evict the resource now if nothing references it, for resources that are
+/// only needed to build something else, instead of waiting for Trim() to
+/// get to them. Sub images go with their parent image.
+/// </summary>
+/// <param name="type"> Type of resource. </param>
+/// <param name="name"> Name of the resource. </param>
+/// *************************************************************************
+void CResourceManager::Evict( NDefs::EResourceType type, const std::string & name )
+{
+    CResourceFile & resource = GetResource( type, name );
+
+    if( IsLoaded( type, resource ) && (resource.refCount == 0) && !resource.subImage && !resource.path.empty() )
+    {
+        Unload( type, name, resource );
+        resource.evicted = true;
+        ++_statsList[type].evictCount;
+    }
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Get the memory stats of the type of resource.
+/// </summary>
+/// <param name="type"> Type of resource. </param>
+/// *************************************************************************
+const CResourceStats & CResourceManager::GetStats( NDefs::EResourceType type ) const
+{
+    return _statsList[type];
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Read the mesh's file on a worker and load it in a later Update().
+/// </summary>
+/// <param name="name"> Name of the mesh. </param>
+/// <param name="callback"> Called with the mesh id once it's loaded. </param>
+/// <returns> Handle to the pending load, or zero if already loaded. </returns>
+/// *************************************************************************
+uint CResourceManager::PrefetchMesh( const std::string & name, TLoadCallback callback )
+{
+    return Prefetch( NDefs::ERT_MESH, name, callback );
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Read the animated mesh's file on a worker and load it in a later Update().
+/// </summary>
+/// <param name="name"> Name of the animated mesh. </param>
+/// <param name="callback"> Called with the animated mesh id once it's loaded. </param>
+/// <returns> Handle to the pending load, or zero if already loaded. </returns>
+/// *************************************************************************
+uint CResourceManager::PrefetchAnimatedMesh( const std::string & name, TLoadCallback callback )
+{
+    return Prefetch( NDefs::ERT_ANIMATED_MESH, name, callback );
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Read the image's file on a worker and load it in a later Update().
+/// </summary>
+/// <param name="name"> Name of the image. </param>
+/// <param name="callback"> Called with the image id once it's loaded. </param>
+/// <returns> Handle to the pending load, or zero if already loaded. </returns>
+/// *************************************************************************
+uint CResourceManager::PrefetchImage( const std::string & name, TLoadCallback callback )
+{
+    return Prefetch( NDefs::ERT_IMAGE, name, callback );
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Read the font's file on a worker and load it in a later Update().
+/// </summary>
+/// <param name="name"> Name of the font. </param>
+/// <param name="callback"> Called with the font id once it's loaded. </param>
+/// <returns> Handle to the pending load, or zero if already loaded. </returns>
+/// *************************************************************************
+uint CResourceManager::PrefetchFont( const std::string & name, TLoadCallback callback )
+{
+    return Prefetch( NDefs::ERT_FONT, name, callback );
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Whether the load with the passed in handle is still pending.
+/// </summary>
+/// <param name="handle"> Handle returned when the load was started. </param>
+/// *************************************************************************
+bool CResourceManager::IsLoading( uint handle ) const
+{
+    for( auto & load : _pendingList )
+        if( load.handle == handle )
+            return true;
+
+    return false;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Get the number of loads still pending.
+/// </summary>
+/// *************************************************************************
+uint CResourceManager::GetLoadingCount() const
+{
+    return (uint)_pendingList.size();
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Finish the loads whose files have been read, oldest first, until the
+/// frame's time budget is spent. At least one load is finished each frame
+/// so a load that takes longer than the budget can't stall the rest. Then
+/// evict what's over the memory budgets.
+/// </summary>
+/// *************************************************************************
+void CResourceManager::Update()
+{
+    auto start = chrono::steady_clock::now();
+
+    while( FinishNextLoad() )
+    {
+        chrono::duration<float> elapsed = chrono::steady_clock::now() - start;
+        if( elapsed.count() >= _loadBudget )
+            break;
+    }
+
+    Trim();
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Finish all of the pending loads, blocking until they're done. Meant for
+/// loading screens. Loads started by the callbacks are finished as well.
+/// </summary>
+/// *************************************************************************
+void CResourceManager::WaitAll()
+{
+    while( !_pendingList.empty() )
+    {
+        _pThreadPool->WaitAll();
+
+        while( FinishNextLoad() )
+        {
+        }
+    }
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Set the time Update() may spend finishing loads each frame.
+/// </summary>
+/// <param name="seconds"> The time budget. </param>
+/// *************************************************************************
+void CResourceManager::SetLoadBudget( float seconds )
+{
+    _loadBudget = seconds;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Get the map of resource files of the type.
+/// </summary>
+/// <param name="type"> Type of resource. </param>
+/// *************************************************************************
+map<const string, CResourceFile> & CResourceManager::GetResourceList( NDefs::EResourceType type )
+{
+    switch( type )
+    {
+    case NDefs::ERT_MESH:          return _meshList;
+    case NDefs::ERT_ANIMATED_MESH: return _animatedMeshList;
+    case NDefs::ERT_IMAGE:         return _imageList;
+    case NDefs::ERT_FONT:          return _fontList;
+    default:
+        throw NExcept::CCriticalException( "Error",
+                                           "CResourceManager::GetResourceList()",
+                                           "Invalid resource type." );
+    }
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Get the file entry of a resource.
+/// </summary>
+/// <param name="type"> Type of resource. </param>
+/// <param name="name"> Name of the resource. </param>
+/// *************************************************************************
+CResourceFile & CResourceManager::GetResource( NDefs::EResourceType type, const std::string & name )
+{
+    return NGeneralFuncs::GetMapValue( name, GetResourceList( type ) );
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Whether the resource's data is loaded. Images have a second id for an
+/// unloaded sub image.
+/// </summary>
+/// <param name="type"> Type of resource. </param>
+/// <param name="resource"> The resource file. </param>
+/// *************************************************************************
+bool CResourceManager::IsLoaded( NDefs::EResourceType type, const CResourceFile & resource ) const
+{
+    if( type == NDefs::ERT_IMAGE )
+        return (resource.id != UNLOADED_ID) && (resource.id != UNLOADED_SUBIMAGE_ID);
+
+    return resource.id != UNLOADED_ID;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Record a newly loaded resource in the stats. Images are estimated as 32
+/// bit textures and sub images use none of their own. Everything else is
+/// estimated by its file size.
+/// </summary>
+/// <param name="type"> Type of resource. </param>
+/// <param name="resource"> The loaded resource file. </param>
+/// *************************************************************************
+void CResourceManager::AddResident( NDefs::EResourceType type, CResourceFile & resource )
+{
+    if( type == NDefs::ERT_IMAGE )
+        resource.size = resource.subImage ? 0 :
+            (size_t)agk::GetImageWidth( resource.id ) * agk::GetImageHeight( resource.id ) * 4;
+    else
+        resource.size = GetFileSize( resource.path );
+
+    CResourceStats & stats = _statsList[type];
+    ++stats.residentCount;
+    stats.residentBytes += resource.size;
+    ++stats.loadCount;
+
+    if( resource.evicted )
+    {
+        ++stats.reloadCount;
+        resource.evicted = false;
+    }
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Free the resource's data and remove it from the stats. Freeing an image
+/// frees its loaded sub images too, since they use its texture.
+/// </summary>
+/// <param name="type"> Type of resource. </param>
+/// <param name="name"> Name of the resource. </param>
+/// <param name="resource"> The loaded resource file. </param>
+/// *************************************************************************
+void CResourceManager::Unload( NDefs::EResourceType type, const std::string & name, CResourceFile & resource )
+{
+    switch( type )
+    {
+    case NDefs::ERT_MESH:
+        agk::DeleteObject( resource.id );
+        break;
+
+    case NDefs::ERT_ANIMATED_MESH:
+        agk::DeleteObjectWithChildren( resource.id );
+        break;
+
+    case NDefs::ERT_IMAGE:
+        if( !resource.subImage )
+            for( auto & kv : _imageList )
+                if( kv.second.subImage && (kv.second.path == name) && IsLoaded( type, kv.second ) )
+                    Unload( type, kv.first, kv.second );
+
+        agk::DeleteImage( resource.id );
+        break;
+
+    case NDefs::ERT_FONT:
+        agk::DeleteFont( resource.id );
+        break;
+
+    default:
+        break;
+    }
+
+    resource.id = resource.subImage ? UNLOADED_SUBIMAGE_ID : UNLOADED_ID;
+
+    CResourceStats & stats = _statsList[type];
+    --stats.residentCount;
+    stats.residentBytes -= resource.size;
+    resource.size = 0;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Load the resource if not loaded and return its id.
+/// </summary>
+/// <param name="type"> Type of resource. </param>
+/// <param name="name"> Name of the resource. </param>
+/// *************************************************************************
+uint CResourceManager::Load( NDefs::EResourceType type, const std::string & name )
+{
+    switch( type )
+    {
+    case NDefs::ERT_MESH:          return LoadMesh( name );
+    case NDefs::ERT_ANIMATED_MESH: return LoadAnimatedMesh( name );
+    case NDefs::ERT_IMAGE:         return LoadImage( name );
+    case NDefs::ERT_FONT:          return LoadFont( name );
+    default:                       return 0;
+    }
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Read the resource's file on a worker, so it's in the system's cache, and
+/// load it in a later Update() or WaitAll(). AGK only decodes and uploads
+/// resources on the main thread, so that part still happens there, spread
+/// over frames by the load budget. If the resource is already loaded, the
+/// callback is called right away.
+/// </summary>
+/// <param name="type"> Type of resource. </param>
+/// <param name="name"> Name of the resource. </param>
+/// <param name="callback"> Called with the resource id once it's loaded. </param>
+/// <returns> Handle to the pending load, or zero if already loaded. </returns>
+/// *************************************************************************
+uint CResourceManager::Prefetch( NDefs::EResourceType type, const std::string & name, TLoadCallback callback )
+{
+    CResourceFile & resource = GetResource( type, name );
+
+    if( IsLoaded( type, resource ) )
+    {
+        if( callback )
+            callback( resource.id );
+
+        return 0;
+    }
+
+    if( !_pThreadPool )
+        _pThreadPool = new CThreadPool();
+
+    _pendingList.emplace_back();
+    CPendingLoad & load = _pendingList.back();
+    load.handle = _nextHandle++;
+    load.type = type;
+    load.name = name;
+    load.path = resource.path;
+    load.callback = callback;
+
+    // Sub images are read from their parent image's file.
+    if( (type == NDefs::ERT_IMAGE) && (resource.id == UNLOADED_SUBIMAGE_ID) )
+        load.path = GetResource( NDefs::ERT_IMAGE, resource.path ).path;
+
+    // The load stays in the list until it's marked as read, so the pointer
+    // stays valid for as long as the worker uses it.
+    CPendingLoad * pLoad = &load;
+    _pThreadPool->Add( [this, pLoad]()
+    {
+        ReadFile( pLoad->path );
+
+        lock_guard<mutex> lock( _pendingMutex );
+        pLoad->read = true;
+    } );
+
+    return load.handle;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Finish the oldest load whose file has been read. The load is taken off
+/// the list before the callback is called, so the callback can start new
+/// loads.
+/// </summary>
+/// <returns> False if no loads were ready. </returns>
+/// *************************************************************************
+bool CResourceManager::FinishNextLoad()
+{
+    auto iter = _pendingList.begin();
+
+    {
+        lock_guard<mutex> lock( _pendingMutex );
+        while( (iter != _pendingList.end()) && !iter->read )
+            ++iter;
+    }
+
+    if( iter == _pendingList.end() )
+        return false;
+
+    CPendingLoad load = move( *iter );
+    _pendingList.erase( iter );
+
+    uint id = Load( load.type, load.name );
+
+    if( load.callback )
+        load.callback( id );
+
+    return true;
+}
+
+
 /// *************************************************************************
 /// <summary> 
 /// Free the resources of the passed in type.
@@ -170,39 +769,16 @@ uint CResourceManager::LoadFont( const std::string & name )
 /// *************************************************************************
 void CResourceManager::Clear( NDefs::EResourceType type )
 {
-    // Free up any loaded meshes.
-    if( type == NDefs::ERT_MESH || type == NDefs::ERT_NULL )
-        for( auto & kv : _meshList )
-            if( kv.second.id > 0 )
-            {
-                agk::DeleteObject( kv.second.id );
-                kv.second.id = 0;
-            }
-
-    // Free up any loaded animated meshes.
-    if( type == NDefs::ERT_ANIMATED_MESH || type == NDefs::ERT_NULL )
-        for( auto & kv : _animatedMeshList )
-            if( kv.second.id > 0 )
-            {
-                agk::DeleteObjectWithChildren( kv.second.id );
-                kv.second.id = 0;
-            }
-
-    // Free up any loaded images.
-    if( type == NDefs::ERT_IMAGE || type == NDefs::ERT_NULL )
-        for( auto & kv : _imageList )
-            if( kv.second.id != UNLOADED_ID && kv.second.id != UNLOADED_SUBIMAGE_ID )
-            {
-                agk::DeleteImage( kv.second.id );
-                kv.second.id = 0;
-            }
-
-    // Free up any loaded images.
-    if( type == NDefs::ERT_FONT || type == NDefs::ERT_NULL )
-        for( auto & kv : _fontList )
-            if( kv.second.id > 0 )
-            {
-                agk::DeleteFont( kv.second.id );
-                kv.second.id = 0;
-            }
+    if( type == NDefs::ERT_NULL )
+    {
+        for( int i = NDefs::ERT_NULL + 1; i < RESOURCE_TYPE_COUNT; ++i )
+            Clear( NDefs::EResourceType( i ) );
+
+        return;
+    }
+
+    // Free up any loaded resources of the type.
+    for( auto & kv : GetResourceList( type ) )
+        if( IsLoaded( type, kv.second ) )
+            Unload( type, kv.first, kv.second );
 }
\ No newline at end of file
@@ -8,6 +8,12 @@
 // Standard lib dependencies
 #include <string>
 #include <map>
+#include <list>
+#include <mutex>
+#include <functional>
+
+// Forward declarations
+class CThreadPool;
 
 /// *************************************************************************
 /// <summary> 
@@ -36,9 +42,76 @@ public:
     uint LoadImage( const std::string & name );
     uint LoadFont( const std::string & name );
 
+    // Load the resource if not loaded, add a reference to it and return its id.
+    uint Acquire( NDefs::EResourceType type, const std::string & name );
+
+    // Remove a reference to the resource. It stays loaded until it's evicted or cleared.
+    void Release( NDefs::EResourceType type, const std::string & name );
+
+    // Set the bytes the type's resources may use before unreferenced ones are evicted. Zero is no limit.
+    void SetBudget( NDefs::EResourceType type, size_t bytes );
+
+    // Evict unreferenced resources, least recently used first, until the types are within their budgets.
+    void Trim( NDefs::EResourceType type = NDefs::ERT_NULL );
+
+    // Evict the resource now if nothing references it.
+    void Evict( NDefs::EResourceType type, const std::string & name );
+
+    // Get the memory stats of the type of resource.
+    const CResourceStats & GetStats( NDefs::EResourceType type ) const;
+
+    // Function called with the id of a resource once it has loaded.
+    typedef std::function<void( uint id )> TLoadCallback;
+
+    // Read the resource's file on a worker, load it in a later Update() and return a handle to the pending load.
+    uint PrefetchMesh( const std::string & name, TLoadCallback callback = nullptr );
+    uint PrefetchAnimatedMesh( const std::string & name, TLoadCallback callback = nullptr );
+    uint PrefetchImage( const std::string & name, TLoadCallback callback = nullptr );
+    uint PrefetchFont( const std::string & name, TLoadCallback callback = nullptr );
+
+    // Whether the load with the passed in handle is still pending.
+    bool IsLoading( uint handle ) const;
+
+    // Get the number of loads still pending.
+    uint GetLoadingCount() const;
+
+    // Finish the loads that have been read, within the time budget, and trim the resources. Call once a frame.
+    void Update();
+
+    // Finish all of the pending loads, blocking until they're done.
+    void WaitAll();
+
+    // Set the time in seconds Update() may spend finishing loads each frame.
+    void SetLoadBudget( float seconds );
+
     // Free the resources of the passed in type.
     void Clear( NDefs::EResourceType type = NDefs::ERT_NULL );
 
+private:
+
+    // Number of resource types, for the lists indexed by type.
+    static const int RESOURCE_TYPE_COUNT = NDefs::ERT_FONT + 1;
+
+    /// *************************************************************************
+    /// <summary>
+    /// A load waiting for its file to be read by a worker, or for the main
+    /// thread to hand the file to AGK.
+    /// </summary>
+    /// *************************************************************************
+    class CPendingLoad
+    {
+    public:
+
+        uint handle = 0;
+        NDefs::EResourceType type = NDefs::ERT_NULL;
+        std::string name;
+        std::string path;
+        TLoadCallback callback;
+
+        // Set by the worker once the file has been read. Guarded by the pending mutex.
+        bool read = false;
+    };
+
 private:
 
     // Constructor
@@ -47,6 +120,30 @@ private:
     // Destructor
     virtual ~CResourceManager();
 
+    // Get the map of resource files of the type.
+    std::map<const std::string, CResourceFile> & GetResourceList( NDefs::EResourceType type );
+
+    // Get the file entry of a resource.
+    CResourceFile & GetResource( NDefs::EResourceType type, const std::string & name );
+
+    // Whether the resource's data is loaded.
+    bool IsLoaded( NDefs::EResourceType type, const CResourceFile & resource ) const;
+
+    // Record a newly loaded resource in the stats.
+    void AddResident( NDefs::EResourceType type, CResourceFile & resource );
+
+    // Free the resource's data and remove it from the stats.
+    void Unload( NDefs::EResourceType type, const std::string & name, CResourceFile & resource );
+
+    // Load the resource if not loaded and return its id.
+    uint Load( NDefs::EResourceType type, const std::string & name );
+
+    // Read the resource's file on a worker and load it in a later Update().
+    uint Prefetch( NDefs::EResourceType type, const std::string & name, TLoadCallback callback );
+
+    // Finish the oldest load whose file has been read. Returns false if none are ready.
+    bool FinishNextLoad();
+
     // Map containing the list of meshes.
     std::map<const std::string, CResourceFile> _meshList;
 
@@ -58,6 +155,30 @@ private:
 
     // Map containing the list of fonts.
     std::map<const std::string, CResourceFile> _fontList;
+
+    // Memory stats of each type of resource.
+    CResourceStats _statsList[RESOURCE_TYPE_COUNT];
+
+    // Bytes each type of resource may use. Zero is no limit.
+    size_t _budgetList[RESOURCE_TYPE_COUNT] = {};
+
+    // Count of resource uses, to order them by when they were last used.
+    uint _useCount = 0;
+
+    // Loads that have been started and not finished, oldest first.
+    std::list<CPendingLoad> _pendingList;
+
+    // Guards the read flags of the pending loads.
+    mutable std::mutex _pendingMutex;
+
+    // Handle to give the next load.
+    uint _nextHandle = 1;
+
+    // Time in seconds Update() may spend finishing loads each frame.
+    float _loadBudget = 0.004f;
+
+    // Workers that read the files. Created with the first prefetch.
+    CThreadPool * _pThreadPool = nullptr;
 };
 
 #endif  // __resource_manager_h__
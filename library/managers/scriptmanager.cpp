@@ -6,11 +6,17 @@
 #include <utilities\exceptionhandling.h>
 #include <utilities\generalfuncs.h>
 #include <utilities\jsonparsehelper.h>
+#include <utilities\datafile.h>
+#include <utilities\preloader.h>
+#include <utilities\archive.h>
+#include <utilities\arena.h>
 #include <script\scriptglobals.h>
 #include <script\animationdata.h>
+#include <script\bytecodecache.h>
 
 // Standard lib dependencies
 #include <fstream>
+#include <memory>
 
 // AngelScript lib dependencies
 #include <angelscript.h>
@@ -84,6 +90,10 @@ void CScriptManager::Clear()
     for( auto & iter : _scriptFileList )
         iter.second.id = UNLOADED_ID;
 
+    // Nothing should wake up in a module that's gone. Done before the contexts
+    // are released, since the scheduler clears their user data.
+    _scheduler.Clear();
+
     // Release the context pool
     for( auto iter : _pInactiveContextList )
         iter->Release();
@@ -91,6 +101,9 @@ void CScriptManager::Clear()
     // Discard the module and free its memory.
     _pScriptModule->Discard();
     _pScriptModule = nullptr;
+    _scriptSectionList.clear();
+    _scriptNameList.clear();
+    ++_moduleGeneration;
 
     // Clear the functions from the list.
     _pScriptFunctionList.clear();
@@ -138,21 +151,10 @@ const CAnimationData * CScriptManager::GetAnimationData( const string & name )
         auto unloadedIter = _animationDataFileList.find( name );
         if( unloadedIter != _animationDataFileList.end() )
         {
-            // Load the sprite data file.
-            ifstream ifile( unloadedIter->second );
-
-            // Parse the content into a json object.
-            json j;
-            ifile >> j;
-
-            auto animationIter = j.find( "animation" );
-            if( animationIter != j.end() )
+            CAnimationData * pData = LoadAnimationData( unloadedIter->second );
+            if( pData )
             {
-                CAnimationData * pData = new CAnimationData();
                 _animationDataList.emplace( unloadedIter->first, pData );
-
-                pData->LoadFromIter( animationIter );
-
                 return pData;
             }
         }
@@ -172,6 +174,62 @@ const CAnimationData * CScriptManager::GetAnimationData( const string & name )
 }
 
 
+/// *************************************************************************
+/// <summary> 
+/// Add jobs to load the animation data that isn't loaded yet.
+/// </summary>
+/// <param name="preloader"> Preloader to add the jobs to. </param>
+/// *************************************************************************
+void CScriptManager::Preload( CPreloader & preloader )
+{
+    function<CAnimationData *( const string &, const string & )> load =
+        []( const string &, const string & filePath )
+        { return LoadAnimationData( filePath ); };
+
+    preloader.Add( "animation", _animationDataFileList, _animationDataList, load );
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Load the animation data file into a new object. Only reads the file, so
+/// it's safe to call from a worker thread.
+/// </summary>
+/// <param name="filePath"> Path to the animation data file. </param>
+/// <returns> The new object, which belongs to the caller. Null if the file
+/// doesn't hold animation data. </returns>
+/// *************************************************************************
+CAnimationData * CScriptManager::LoadAnimationData( const string & filePath )
+{
+    unique_ptr<CAnimationData> pData( new CAnimationData() );
+
+    // Compiled data is read straight into the data object.
+    CDataFile file( filePath );
+    if( file.IsCompiled() )
+    {
+        CBinaryReader reader = file.GetReader( NDefs::EDT_ANIMATION );
+        pData->Read( reader );
+
+        return pData.release();
+    }
+
+    // Otherwise parse the content into a json object, built in an arena
+    // and freed with it in one go.
+    CArenaScope arenaScope;
+
+    json j;
+    file.GetJson( j );
+
+    auto animationIter = j.find( "animation" );
+    if( animationIter == j.end() )
+        return nullptr;
+
+    pData->LoadFromIter( animationIter );
+
+    return pData.release();
+}
+
+
 /// *************************************************************************
 /// <summary> 
 /// Load all of the scripts of a specific group
@@ -202,6 +260,7 @@ void CScriptManager::LoadScript( const string & name )
         if( iter->second.id == 0 )
         {
             AddScript( iter->second.path );
+            _scriptNameList.push_back( name );
             iter->second.id = 1;
         }
     }
@@ -216,7 +275,9 @@ void CScriptManager::LoadScript( const string & name )
 
 /// *************************************************************************
 /// <summary> 
-/// Add the script to the module.
+/// Read the script to be added to the module when it's built. The sections
+/// aren't added until then, since they aren't needed at all if the
+/// bytecode cache is used.
 /// </summary>
 /// *************************************************************************
 void CScriptManager::AddScript( const string & filepath )
@@ -226,15 +287,20 @@ void CScriptManager::AddScript( const string & filepath )
 
     try
     {
-        // Load the script file into a charater array
-        fileId = agk::OpenToRead( filepath.c_str() );
-        pScript = agk::ReadString( fileId );
+        // Use the script straight out of the archive if it's packed.
+        CArchiveSlice slice;
+        if( CArchive::Instance().Find( filepath, slice ) )
+        {
+            _scriptSectionList.emplace_back( filepath, string( slice.pData, slice.size ) );
+        }
+        else
+        {
+            // Load the script file into a charater array
+            fileId = agk::OpenToRead( filepath.c_str() );
+            pScript = agk::ReadString( fileId );
 
-        // Load script into module section - the file path is it's ID
-        if( _pScriptModule->AddScriptSection( filepath.c_str(), pScript ) < 0 )
-            throw NExcept::CCriticalException( "Error",
-                                               "CScriptManager::AddScript()",
-                                               "File '" + filepath + "' could not be added." );
+            _scriptSectionList.emplace_back( filepath, string( pScript ? pScript : "" ) );
+        }
 
         if( pScript )
             agk::DeleteString( pScript );
@@ -253,16 +319,79 @@ void CScriptManager::AddScript( const string & filepath )
 
 /// *************************************************************************
 /// <summary> 
-/// Build all the scripts added to the module.
+/// Build all the scripts added to the module. Each build is cached in its
+/// own file, named after the scripts loaded for it, so builds of different
+/// scripts don't overwrite each other's cache. If the file was saved from
+/// the same scripts and the same registered interface, the module is loaded
+/// from it and the compiler is skipped. Otherwise the scripts are compiled
+/// and the cache is saved again.
 /// </summary>
 /// *************************************************************************
 void CScriptManager::BuildScript()
 {
-    // Build the script
+    string cachePath = _byteCodeCachePath;
+    for( auto & name : _scriptNameList )
+        cachePath += "-" + name;
+
+    _scriptNameList.clear();
+
+    CByteCodeCache cache( cachePath + ".cache" );
+
+    if( !_byteCodeCachePath.empty() )
+    {
+        cache.AddInterface( _pScriptEngine );
+
+        for( auto & section : _scriptSectionList )
+            cache.AddSection( section.first, section.second );
+
+        if( cache.Load( _pScriptModule ) )
+        {
+            _scriptSectionList.clear();
+            _pScriptFunctionList.clear();
+            ++_moduleGeneration;
+            return;
+        }
+    }
+
+    // Load script into module section - the file path is it's ID
+    for( auto & section : _scriptSectionList )
+    {
+        // A length of zero means a null terminated string, so give empty scripts one.
+        const char * pCode = section.second.empty() ? "" : section.second.c_str();
+
+        if( _pScriptModule->AddScriptSection( section.first.c_str(), pCode, section.second.size() ) < 0 )
+            throw NExcept::CCriticalException( "Error",
+                                               "CScriptManager::BuildScript()",
+                                               "File '" + section.first + "' could not be added." );
+    }
+
+    _scriptSectionList.clear();
+
+    // Build the script. This replaces any functions built before.
+    _pScriptFunctionList.clear();
+    ++_moduleGeneration;
+
     if( _pScriptModule->Build() < 0 )
         throw NExcept::CCriticalException( "Error",
                                            "CScriptManager::BuildScript()",
                                            "Failed to build the scripts from the module." );
+
+    if( !_byteCodeCachePath.empty() )
+        cache.Save( _pScriptModule );
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Set the start of the names of the files the built bytecode is cached in.
+/// Each build adds the names of its scripts and the extension, so a path of
+/// "scripts" caches a build of "defs" and "general" in "scripts-defs-general.cache".
+/// </summary>
+/// <param name="path"> Start of the cache file paths. Empty turns the cache off. </param>
+/// *************************************************************************
+void CScriptManager::SetByteCodeCachePath( const string & path )
+{
+    _byteCodeCachePath = path;
 }
 
 
@@ -295,10 +424,47 @@ asIScriptContext * CScriptManager::GetContext()
 /// *************************************************************************
 void CScriptManager::RecycleContext( asIScriptContext * pContext )
 {
+    _scheduler.Cancel( pContext );
+
     _pInactiveContextList.push_back( pContext );
 }
 
 
+/// *************************************************************************
+/// <summary> 
+/// Wake the waiting scripts that are due this frame. Call once a frame,
+/// before the scripts are executed.
+/// </summary>
+/// *************************************************************************
+void CScriptManager::Update()
+{
+    _scheduler.Update( agk::GetFrameTime() );
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Get the scheduler that keeps waiting scripts asleep.
+/// </summary>
+/// *************************************************************************
+CScriptScheduler & CScriptManager::GetScheduler()
+{
+    return _scheduler;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Get the count of times the module has been built or discarded. Function
+/// pointers kept from an older generation have been freed.
+/// </summary>
+/// *************************************************************************
+uint CScriptManager::GetModuleGeneration() const
+{
+    return _moduleGeneration;
+}
+
+
 /// *************************************************************************
 /// <summary> 
 /// Get pointer to function name.
@@ -368,19 +534,7 @@ asIScriptEngine * CScriptManager::GetEnginePtr()
 /// *************************************************************************
 asIScriptContext * CScriptManager::Prepare( const string & function, const vector<CScriptParam> & paramList )
 {
-    // Get a context from the script manager pool
-    asIScriptContext * pContext = GetContext();
-
-    // Get the function pointer
-    asIScriptFunction * pScriptFunc = GetPtrToFunc( function );
-
-    // Prepare the function to run
-    if( pContext->Prepare( pScriptFunc ) < 0 )
-    {
-        throw NExcept::CCriticalException( "Error",
-                                           "CScriptManager::Prepare()",
-                                           "Error preparing the script function '" + function + "'." );
-    }
+    asIScriptContext * pContext = PrepareContext( GetPtrToFunc( function ) );
 
     // Pass the parameters to the script function
     for( size_t i = 0; i < paramList.size(); ++i )
@@ -418,3 +572,78 @@ asIScriptContext * CScriptManager::Prepare( const string & function, const vecto
 
     return pContext;
 }
+
+
+/// *************************************************************************
+/// <summary> 
+/// Get a context from the pool with the script function prepared on it.
+/// </summary>
+/// <param name="pFunction"> Function to prepare. </param>
+/// *************************************************************************
+asIScriptContext * CScriptManager::PrepareContext( asIScriptFunction * pFunction )
+{
+    asIScriptContext * pContext = GetContext();
+
+    if( pContext->Prepare( pFunction ) < 0 )
+    {
+        throw NExcept::CCriticalException( "Error",
+                                           "CScriptManager::Prepare()",
+                                           boost::str( boost::format( "Error preparing the script function '%s'." )
+                                                       % (pFunction ? pFunction->GetName() : "") ) );
+    }
+
+    return pContext;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Set an argument of the prepared function.
+/// </summary>
+/// <param name="pContext"> Context the function is prepared on. </param>
+/// <param name="index"> Index of the argument. </param>
+/// <param name="value"> Value of the argument. </param>
+/// <returns> Negative if the argument couldn't be set. </returns>
+/// *************************************************************************
+int CScriptManager::SetArg( asIScriptContext * pContext, uint index, bool value )
+{
+    return pContext->SetArgByte( index, value );
+}
+
+int CScriptManager::SetArg( asIScriptContext * pContext, uint index, int value )
+{
+    return pContext->SetArgDWord( index, value );
+}
+
+int CScriptManager::SetArg( asIScriptContext * pContext, uint index, uint value )
+{
+    return pContext->SetArgDWord( index, value );
+}
+
+int CScriptManager::SetArg( asIScriptContext * pContext, uint index, float value )
+{
+    return pContext->SetArgFloat( index, value );
+}
+
+/// <summary> 
+/// Set a registered object argument of the prepared function.
+/// </summary>
+int CScriptManager::SetArg( asIScriptContext * pContext, uint index, void * pValue )
+{
+    return pContext->SetArgObject( index, pValue );
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Throw the error for an argument that couldn't be set.
+/// </summary>
+/// <param name="pFunction"> Function the argument was for. </param>
+/// *************************************************************************
+void CScriptManager::ThrowArgError( asIScriptFunction * pFunction )
+{
+    throw NExcept::CCriticalException( "Error",
+                                       "CScriptManager::Prepare()",
+                                       boost::str( boost::format( "Error setting the parameter for script function '%s'." )
+                                                   % pFunction->GetName() ) );
+}
\ No newline at end of file
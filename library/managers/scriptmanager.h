@@ -5,6 +5,7 @@
 //#include <utilities\smartpointers.h>
 #include <script\scriptparam.h>
 #include <common\resourcefile.h>
+#include <script\scriptscheduler.h>
 
 // Standard lib dependencies
 #include <string>
@@ -19,6 +20,7 @@ class asIScriptModule;
 class asIScriptContext;
 class asIScriptFunction;
 struct asSMessageInfo;
+class CPreloader;
 
 /// *************************************************************************
 /// <summary> 
@@ -48,6 +50,9 @@ public:
     // Load the animation data.
     const CAnimationData * GetAnimationData( const std::string & name );
 
+    // Add jobs to load the animation data that isn't loaded yet.
+    void Preload( CPreloader & preloader );
+
     // Load a script.
     void LoadScript( const std::string & name );
 
@@ -60,17 +65,34 @@ public:
     // Add the script context back to the managed pool.
     void RecycleContext( asIScriptContext * pContext );
 
+    // Wake the waiting scripts that are due this frame.
+    void Update();
+
+    // Get the scheduler that keeps waiting scripts asleep.
+    CScriptScheduler & GetScheduler();
+
     // Get pointer to function.
     asIScriptFunction * GetPtrToFunc( const std::string & name );
 
+    // Get the count of times the module has been built or discarded.
+    uint GetModuleGeneration() const;
+
     // Prepare the script function to run.
     asIScriptContext * Prepare(
         const std::string & function,
         const std::vector<CScriptParam> & paramList = std::vector<CScriptParam>() );
 
+    // Prepare the script function to run with the arguments.
+    template <class... TArgs>
+    asIScriptContext * Prepare( asIScriptFunction * pFunction, TArgs... args );
+
     // Build all the scripts added to the module.
     void BuildScript();
 
+    // Set the start of the names of the files the built bytecode is cached in.
+    // Empty turns the cache off.
+    void SetByteCodeCachePath( const std::string & path );
+
 private:
 
     // Constructor
@@ -79,9 +101,25 @@ private:
     // Destructor
     virtual ~CScriptManager();
 
-    // Add the script to the module.
+    // Read the script to be added to the module when it's built.
     void AddScript( const std::string & filePath );
 
+    // Get a context from the pool with the script function prepared on it.
+    asIScriptContext * PrepareContext( asIScriptFunction * pFunction );
+
+    // Set an argument of the prepared function.
+    static int SetArg( asIScriptContext * pContext, uint index, bool value );
+    static int SetArg( asIScriptContext * pContext, uint index, int value );
+    static int SetArg( asIScriptContext * pContext, uint index, uint value );
+    static int SetArg( asIScriptContext * pContext, uint index, float value );
+    static int SetArg( asIScriptContext * pContext, uint index, void * pValue );
+
+    // Throw the error for an argument that couldn't be set.
+    static void ThrowArgError( asIScriptFunction * pFunction );
+
+    // Load the animation data file into a new object.
+    static CAnimationData * LoadAnimationData( const std::string & filePath );
+
     // Call back to display AngelScript messages.
     void MessageCallback( const asSMessageInfo & msg );
 
@@ -107,8 +145,52 @@ private:
 
     // AngelScript module.
     asIScriptModule * _pScriptModule = nullptr;
+
+    // Scripts read since the last build, by file path.
+    std::vector<std::pair<std::string, std::string>> _scriptSectionList;
+
+    // Names of the scripts read since the last build, which name its cache file.
+    std::vector<std::string> _scriptNameList;
+
+    // Start of the names of the files the built bytecode is cached in.
+    std::string _byteCodeCachePath;
+
+    // Goes up each time the module is built or discarded, which frees the
+    // function pointers handed out before.
+    uint _moduleGeneration = 0;
+
+    // Keeps the waiting scripts asleep until they're due.
+    CScriptScheduler _scheduler;
 };
 
+
+
+/// *************************************************************************
+/// <summary> 
+/// Prepare the script function to run with the arguments. The arguments are
+/// matched to their setters when this is compiled, so nothing is looked up
+/// or allocated.
+/// </summary>
+/// <param name="pFunction"> Function from GetPtrToFunc. </param>
+/// <param name="args"> Bools, ints, uints, floats or pointers to registered
+/// objects, in the order the function takes them. </param>
+/// *************************************************************************
+template <class... TArgs>
+asIScriptContext * CScriptManager::Prepare( asIScriptFunction * pFunction, TArgs... args )
+{
+    asIScriptContext * pContext = PrepareContext( pFunction );
+
+    // The list is only there to set the arguments in order.
+    uint index = 0;
+    int resultList[] = { 0, SetArg( pContext, index++, args )... };
+
+    for( int result : resultList )
+        if( result < 0 )
+            ThrowArgError( pFunction );
+
+    return pContext;
+}
+
 #endif  // __script_manager_h__
 
 
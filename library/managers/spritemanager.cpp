@@ -4,6 +4,8 @@
 // Game lib dependencies
 #include <agk.h>
 #include <utilities\jsonparsehelper.h>
+#include <utilities\datafile.h>
+#include <utilities\preloader.h>
 #include <utilities\exceptionhandling.h>
 #include <utilities\deletefuncs.h>
 #include <utilities\generalfuncs.h>
@@ -11,6 +13,8 @@
 #include <common\vector3.h>
 #include <common\iobject.h>
 #include <common\collectionobject.h>
+#include <common\transformstore.h>
+#include <common\commandbuffer.h>
 #include <3d\spritedata3d.h>
 #include <3d\sprite3d.h>
 #include <2d\spritedata2d.h>
@@ -20,11 +24,35 @@
 
 // Standard lib dependencies
 #include <fstream>
+#include <memory>
+#include <algorithm>
 
 using namespace std;
 using namespace nlohmann;
 using namespace NDefs;
 
+namespace
+{
+    // Collection files bigger than this, like levels, aren't kept after
+    // they're read. They're streamed straight into the objects instead.
+    const size_t MAX_CACHED_COLLECTION_SIZE = 1024 * 1024;
+
+    /// *************************************************************************
+    /// <summary> 
+    /// Give the transform batch an object's local transformation, using the
+    /// object's quaternion if it keeps its rotation as one.
+    /// </summary>
+    /// *************************************************************************
+    void SetBatchNode( CTransformBatch & batch, uint index, const iObject * pObject, bool worldSpace )
+    {
+        if( pObject->HasOrientation() )
+            batch.Set( index, pObject->GetPos(), pObject->GetOrientation(), pObject->GetScale(), worldSpace );
+        else
+            batch.Set( index, pObject->GetPos(), pObject->GetRot(), pObject->GetScale(), worldSpace );
+    }
+}
+
+
 /// *************************************************************************
 /// <summary> 
 /// Constructor
@@ -32,6 +60,13 @@ using namespace NDefs;
 /// *************************************************************************
 CSpriteManager::CSpriteManager()
 {
+    // The objects release their slots, memory and pending commands when deleted,
+    // so the store, the pools and the command buffer have to outlive the manager.
+    CTransformStore::Instance();
+    CCommandBuffer::Instance();
+    CSprite3D::GetPool();
+    CSprite2D::GetPool();
+    CTextSprite::GetPool();
 }
 
 
@@ -86,6 +121,9 @@ void CSpriteManager::LoadTextDataFileList( const std::string & path )
 /// *************************************************************************
 void CSpriteManager::LoadCollectionFileList( const string & path )
 {
+    // The files may have changed, so drop the collections parsed from the old list.
+    NDelFunc::DeleteMapPointers( _collectionList );
+
     NGeneralFuncs::AddFilesToMap( path, _collectionFileList );
 }
 
@@ -108,23 +146,12 @@ CSpriteData3D * CSpriteManager::GetSpriteData3D( const std::string & name )
         // If not, load the sprite data.
         const string & filepath = NGeneralFuncs::GetMapValue( name, _spriteDataFileList3d );
 
-        // Load the sprite data file.
-        ifstream ifile( filepath );
-
-        // Parse the content into a json object.
-        json j;
-        ifile >> j;
-
-        auto spriteIter = j.find( "spriteData3d" );
-        if( spriteIter != j.end() )
-        {
-            CSpriteData3D * pData = new CSpriteData3D();
+        // Load the data file, compiled or json.
+        CSpriteData3D * pData = CDataFile( filepath ).Load<CSpriteData3D>( name, EDT_SPRITE_3D, "spriteData3d" );
+        if( pData )
             _spriteDataList3d.emplace( name, pData );
-                
-            pData->LoadFromIter( name, spriteIter );
 
-            return pData;
-        }
+        return pData;
     }
     catch( exception e )
     {
@@ -155,23 +182,12 @@ CSpriteData2D * CSpriteManager::GetSpriteData2D( const std::string & name )
         // If not, load the sprite data.
         const string & filepath = NGeneralFuncs::GetMapValue( name, _spriteDataFileList2d );
 
-        // Load the sprite data file.
-        ifstream ifile( filepath );
-
-        // Parse the content into a json object.
-        json j;
-        ifile >> j;
-
-        auto spriteIter = j.find( "spriteData2d" );
-        if( spriteIter != j.end() )
-        {
-            CSpriteData2D * pData = new CSpriteData2D();
+        // Load the data file, compiled or json.
+        CSpriteData2D * pData = CDataFile( filepath ).Load<CSpriteData2D>( name, EDT_SPRITE_2D, "spriteData2d" );
+        if( pData )
             _spriteDataList2d.emplace( name, pData );
 
-            pData->LoadFromIter( name, spriteIter );
-
-            return pData;
-        }
+        return pData;
     }
     catch( exception e )
     {
@@ -202,23 +218,12 @@ CTextSpriteData * CSpriteManager::GetTextSpriteData( const std::string & name )
         // If not, load the sprite data.
         const string & filepath = NGeneralFuncs::GetMapValue( name, _textSpriteDataFileList );
 
-        // Load the sprite data file.
-        ifstream ifile( filepath );
-
-        // Parse the content into a json object.
-        json j;
-        ifile >> j;
-
-        auto spriteIter = j.find( "textSpriteData" );
-        if( spriteIter != j.end() )
-        {
-            CTextSpriteData * pData = new CTextSpriteData();
+        // Load the data file, compiled or json.
+        CTextSpriteData * pData = CDataFile( filepath ).Load<CTextSpriteData>( name, EDT_TEXT_SPRITE, "textSpriteData" );
+        if( pData )
             _textSpriteDataList.emplace( name, pData );
 
-            pData->LoadFromIter( name, spriteIter );
-
-            return pData;
-        }
+        return pData;
     }
     catch( exception e )
     {
@@ -231,6 +236,44 @@ CTextSpriteData * CSpriteManager::GetTextSpriteData( const std::string & name )
 }
 
 
+/// *************************************************************************
+/// <summary> 
+/// Add jobs to load the sprite, text sprite and collection data that isn't
+/// loaded yet. The data is added to the maps when the preloader publishes it.
+/// </summary>
+/// <param name="preloader"> Preloader to add the jobs to. </param>
+/// *************************************************************************
+void CSpriteManager::Preload( CPreloader & preloader )
+{
+    function<CSpriteData3D *( const string &, const string & )> load3D =
+        []( const string & name, const string & filePath )
+        { return CDataFile( filePath ).Load<CSpriteData3D>( name, EDT_SPRITE_3D, "spriteData3d" ); };
+
+    function<CSpriteData2D *( const string &, const string & )> load2D =
+        []( const string & name, const string & filePath )
+        { return CDataFile( filePath ).Load<CSpriteData2D>( name, EDT_SPRITE_2D, "spriteData2d" ); };
+
+    function<CTextSpriteData *( const string &, const string & )> loadText =
+        []( const string & name, const string & filePath )
+        { return CDataFile( filePath ).Load<CTextSpriteData>( name, EDT_TEXT_SPRITE, "textSpriteData" ); };
+
+    function<vector<CCollectionObject> *( const string &, const string & )> loadCollection =
+        []( const string &, const string & filePath ) -> vector<CCollectionObject> *
+        {
+            CDataFile file( filePath );
+            if( file.GetSize() > MAX_CACHED_COLLECTION_SIZE )
+                return nullptr;
+
+            return LoadCollection( file );
+        };
+
+    preloader.Add( "sprite 3d", _spriteDataFileList3d, _spriteDataList3d, load3D );
+    preloader.Add( "sprite 2d", _spriteDataFileList2d, _spriteDataList2d, load2D );
+    preloader.Add( "text sprite", _textSpriteDataFileList, _textSpriteDataList, loadText );
+    preloader.Add( "collection", _collectionFileList, _collectionList, loadCollection );
+}
+
+
 /// *************************************************************************
 /// <summary> 
 /// Create the 3d sprite.
@@ -246,10 +289,7 @@ CSprite3D * CSpriteManager::CreateSprite3D( const string & name, const string &
         // Create the sprite object and add it to the sprite list.
         CSprite3D * pSprite = new CSprite3D( name );
 
-        if( key.empty() )
-            _objectList[name].push_back( pSprite );
-        else
-            _objectList[key].push_back( pSprite );
+        AddObject( pSprite, key.empty() ? name : key );
 
         return pSprite;
     }
@@ -279,10 +319,7 @@ CSprite2D * CSpriteManager::CreateSprite2D( const std::string & name, const stri
         // Create the sprite object and add it to the sprite list.
         CSprite2D * pSprite = new CSprite2D( name );
 
-        if( key.empty() )
-            _objectList[name].push_back( pSprite );
-        else
-            _objectList[key].push_back( pSprite );
+        AddObject( pSprite, key.empty() ? name : key );
 
         return pSprite;
     }
@@ -313,10 +350,7 @@ CTextSprite * CSpriteManager::CreateTextSprite( const string & name, const strin
         // Create the sprite object and add it to the sprite list.
         CTextSprite * pSprite = new CTextSprite( name, text );
 
-        if( key.empty() )
-            _objectList[name].push_back( pSprite );
-        else
-            _objectList[key].push_back( pSprite );
+        AddObject( pSprite, key.empty() ? name : key );
 
         return pSprite;
     }
@@ -345,59 +379,39 @@ vector<iObject *> CSpriteManager::CreateCollection( const string & name, const s
     vector<iObject *> pObjectList;
     try
     {
-        auto mapIter = _collectionFileList.find( name );
-        if( mapIter != _collectionFileList.end() )
-        {
-            // Load the sprite data file.
-            ifstream ifile( mapIter->second );
+        string mapKey = key.empty() ? name : key;
 
-            // Parse the content into a json object.
-            json j;
-            ifile >> j;
+        ForEachCollectionObject( name, [&]( const CCollectionObject & collectionObject )
+        {
+            iObject * pObject = nullptr;
 
-            auto collectionIter = j.find( "collection" );
-            if( collectionIter != j.end() )
+            switch( collectionObject.type )
             {
-                string mapKey = key.empty() ? name : key;
-
-                auto objectIter = collectionIter->begin();
-                while( objectIter != collectionIter->end() )
-                {
-                    CCollectionObject collectionObject;
-                    NParseHelper::GetCollectionObject( objectIter, collectionObject );
-                    iObject * pObject = nullptr;
-
-                    switch( collectionObject.type )
-                    {
-                    case EOT_SPRITE_3D:
-                        pObject = CreateSprite3D( collectionObject.name, mapKey );
-                        pObjectList.push_back( pObject );
-                        pObject->Set( collectionObject );
-                        break;
-
-                    case EOT_SPRITE_2D:
-                        pObject = CreateSprite2D( collectionObject.name, mapKey );
-                        pObjectList.push_back( pObject );
-                        pObject->Set( collectionObject );
-                        break;
-
-                    case EOT_TEXT_SPRITE:
-                        pObject = CreateTextSprite( collectionObject.name, collectionObject.text, mapKey );
-                        pObjectList.push_back( pObject );
-                        pObject->Set( collectionObject );
-                        break;
-
-                    default:
-                        throw NExcept::CCriticalException( "Error",
-                                                           "CCollectionManager::LoadCollection()",
-                                                           "Invalid type for object in collection '" + name + "'." );
-                        break;
-                    }
-
-                    ++objectIter;
-                }
+            case EOT_SPRITE_3D:
+                pObject = CreateSprite3D( collectionObject.name, mapKey );
+                pObjectList.push_back( pObject );
+                pObject->Set( collectionObject );
+                break;
+
+            case EOT_SPRITE_2D:
+                pObject = CreateSprite2D( collectionObject.name, mapKey );
+                pObjectList.push_back( pObject );
+                pObject->Set( collectionObject );
+                break;
+
+            case EOT_TEXT_SPRITE:
+                pObject = CreateTextSprite( collectionObject.name, collectionObject.text, mapKey );
+                pObjectList.push_back( pObject );
+                pObject->Set( collectionObject );
+                break;
+
+            default:
+                throw NExcept::CCriticalException( "Error",
+                                                   "CCollectionManager::LoadCollection()",
+                                                   "Invalid type for object in collection '" + name + "'." );
+                break;
             }
-        }
+        } );
     }
     catch( exception e )
     {
@@ -412,7 +426,8 @@ vector<iObject *> CSpriteManager::CreateCollection( const string & name, const s
 
 /// *************************************************************************
 /// <summary> 
-/// Free the loaded sprite data and all sprites of the same name.
+/// Free the loaded sprite data, the parsed collection and all sprites of
+/// the same name.
 /// </summary>
 /// <param name="name"> Name of the sprite to free. 
 ///                     Empty string frees everything. </param>
@@ -423,17 +438,43 @@ void CSpriteManager::Clear( const string & name )
     {
         if( name.empty() )
         {
-            NDelFunc::DeleteMapVectorPointers( _objectList );
+            while( !_objectList.IsEmpty() )
+                DeleteObject( _objectList.GetHandleAt( _objectList.GetSize() - 1 ) );
+
+            // Repack the pools now that all of the sprites are gone.
+            CSprite3D::GetPool().Reset();
+            CSprite2D::GetPool().Reset();
+            CTextSprite::GetPool().Reset();
+
+            // The prototypes can go now that none of their clones are left.
+            for( auto & kv : _spriteDataList3d )
+                CSprite3D::DeletePrototype( kv.second );
+
             NDelFunc::DeleteMapPointers( _spriteDataList3d );
             NDelFunc::DeleteMapPointers( _spriteDataList2d );
             NDelFunc::DeleteMapPointers( _textSpriteDataList );
+            NDelFunc::DeleteMapPointers( _collectionList );
         }
         else
         {
-            NDelFunc::DeleteMapVectorPointers( name, _objectList );
+            auto indexIter = _nameIndex.find( name );
+            if( indexIter != _nameIndex.end() )
+            {
+                // Deleting the last object erases the entry, so copy the handles first.
+                // Deleting from the back keeps each removal from the list cheap.
+                vector<uint> handleList( indexIter->second );
+                for( auto iter = handleList.rbegin(); iter != handleList.rend(); ++iter )
+                    DeleteObject( *iter );
+            }
+
+            auto dataIter = _spriteDataList3d.find( name );
+            if( dataIter != _spriteDataList3d.end() )
+                CSprite3D::DeletePrototype( dataIter->second );
+
             NDelFunc::DeleteMapPointer( name, _spriteDataList3d );
             NDelFunc::DeleteMapPointer( name, _spriteDataList2d );
             NDelFunc::DeleteMapPointer( name, _textSpriteDataList );
+            NDelFunc::DeleteMapPointer( name, _collectionList );
         }
     }
     catch( exception e )
@@ -453,9 +494,199 @@ void CSpriteManager::Clear( const string & name )
 /// *************************************************************************
 void CSpriteManager::RepositionAllSprites()
 {
-    for( auto mapIter = _objectList.begin(); mapIter != _objectList.end(); ++mapIter )
-        for( auto pSprite : mapIter->second )
-            pSprite->Reposition();
+    for( auto & entry : _objectList )
+        entry.pObject->Reposition();
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Get the object the handle refers to.
+/// </summary>
+/// <param name="handle"> Handle of the object. </param>
+/// <returns> The object, or null if it has been deleted. </returns>
+/// *************************************************************************
+iObject * CSpriteManager::GetObjectFromHandle( uint handle )
+{
+    CObjectEntry * pEntry = _objectList.Get( handle );
+
+    return pEntry ? pEntry->pObject : nullptr;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Get the objects listed under the key, in the order they were created.
+/// </summary>
+/// <param name="key"> Key the objects were created with. </param>
+/// *************************************************************************
+vector<iObject *> CSpriteManager::GetObjectList( const string & key )
+{
+    vector<iObject *> pObjectList;
+
+    auto indexIter = _nameIndex.find( key );
+    if( indexIter != _nameIndex.end() )
+        for( auto handle : indexIter->second )
+            pObjectList.push_back( GetObjectFromHandle( handle ) );
+
+    return pObjectList;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Add the object to the object list and the name index.
+/// </summary>
+/// <param name="pObject"> The object to add. The manager takes ownership. </param>
+/// <param name="key"> Key to list the object under. </param>
+/// *************************************************************************
+void CSpriteManager::AddObject( iObject * pObject, const string & key )
+{
+    CObjectEntry entry;
+    entry.pObject = pObject;
+    entry.key = key;
+    entry.transformIndex = (uint)_transformList.size();
+
+    uint handle = _objectList.Add( entry );
+    pObject->SetHandle( handle );
+    _nameIndex[key].push_back( handle );
+
+    // New objects go at the end, which is after any parent they can have.
+    _transformList.push_back( pObject );
+    _transformBatch.Add();
+
+    // An object given a parent before it was added is placed once the parent is looked up.
+    if( pObject->GetParent() )
+        _parentChangeList.push_back( handle );
+
+    _objectAdded = true;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Delete the object and remove it from the object list and the name index.
+/// </summary>
+/// <param name="handle"> Handle of the object to delete. </param>
+/// *************************************************************************
+void CSpriteManager::DeleteObject( uint handle )
+{
+    CObjectEntry * pEntry = _objectList.Get( handle );
+    if( !pEntry )
+        return;
+
+    auto indexIter = _nameIndex.find( pEntry->key );
+    if( indexIter != _nameIndex.end() )
+    {
+        // Search from the back, since the newest objects tend to be deleted first.
+        auto & handleList = indexIter->second;
+        handleList.erase( find( handleList.rbegin(), handleList.rend(), handle ).base() - 1 );
+
+        if( handleList.empty() )
+            _nameIndex.erase( indexIter );
+    }
+
+    // Leave a gap in the transform list until it's reordered.
+    _transformList[pEntry->transformIndex] = nullptr;
+    ++_removedCount;
+
+    NDelFunc::Delete( pEntry->pObject );
+    _objectList.Remove( handle );
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Pass each object of the collection to the callback. The file is only
+/// read and parsed the first time, after that every creation of the
+/// collection walks the same list. Files too big to keep are streamed
+/// instead, so only one object's data is held at a time.
+/// </summary>
+/// <param name="name"> Name of the collection. Nothing is passed on if
+/// there's no such collection. </param>
+/// <param name="callback"> Called with each object, in order. </param>
+/// *************************************************************************
+void CSpriteManager::ForEachCollectionObject( const string & name, const function<void( const CCollectionObject & )> & callback )
+{
+    auto loadedIter = _collectionList.find( name );
+    if( loadedIter == _collectionList.end() )
+    {
+        auto mapIter = _collectionFileList.find( name );
+        if( mapIter == _collectionFileList.end() )
+            return;
+
+        CDataFile file( mapIter->second );
+        if( file.GetSize() > MAX_CACHED_COLLECTION_SIZE )
+        {
+            StreamCollection( file, callback );
+            return;
+        }
+
+        loadedIter = _collectionList.emplace( name, LoadCollection( file ) ).first;
+    }
+
+    for( auto & collectionObject : *loadedIter->second )
+        callback( collectionObject );
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Read the collection file into a new list of objects. Only reads the
+/// file, so it's safe to call from a worker thread.
+/// </summary>
+/// <param name="file"> The collection file. </param>
+/// <returns> The new list, which belongs to the caller. </returns>
+/// *************************************************************************
+vector<CCollectionObject> * CSpriteManager::LoadCollection( const CDataFile & file )
+{
+    unique_ptr<vector<CCollectionObject>> pCollection( new vector<CCollectionObject>() );
+
+    StreamCollection( file, [&pCollection]( const CCollectionObject & collectionObject )
+    {
+        pCollection->push_back( collectionObject );
+    } );
+
+    return pCollection.release();
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Read the collection file, passing each object on as soon as it's parsed.
+/// The json tree is never built, so the memory used doesn't grow with the
+/// size of the file.
+/// </summary>
+/// <param name="file"> The collection file. </param>
+/// <param name="callback"> Called with each object, in order. </param>
+/// *************************************************************************
+void CSpriteManager::StreamCollection( const CDataFile & file, const function<void( const CCollectionObject & )> & callback )
+{
+    // Compiled data holds the parsed objects after their count.
+    if( file.IsCompiled() )
+    {
+        CBinaryReader reader = file.GetReader( EDT_COLLECTION );
+
+        uint count;
+        reader.Read( count );
+
+        CCollectionObject collectionObject;
+        for( uint i = 0; i < count; ++i )
+        {
+            reader.Read( collectionObject );
+            callback( collectionObject );
+        }
+    }
+    else
+    {
+        // Otherwise parse the json one object at a time.
+        file.StreamJsonArray( "collection", [&callback]( json::const_iterator iter )
+        {
+            CCollectionObject collectionObject;
+            NParseHelper::GetCollectionObject( iter, collectionObject );
+            callback( collectionObject );
+        } );
+    }
 }
 
 
@@ -466,55 +697,264 @@ void CSpriteManager::RepositionAllSprites()
 /// *************************************************************************
 void CSpriteManager::Update()
 {
+    UpdateTopology();
+
     // If an object's parent has been marked for deletion, it should be marked too.
-    for( auto mapIter = _objectList.begin(); mapIter != _objectList.end(); ++mapIter )
-        for( auto pSprite : mapIter->second )
-            pSprite->UpdateForDeletion();
+    // Parents come first, so the whole branch is marked in one pass.
+    for( size_t i = 0; i < _transformList.size(); ++i )
+    {
+        int parent = _transformBatch.GetParent( (uint)i );
+        if( (parent != CTransformBatch::NO_PARENT) && _transformList[parent]->IsMarkedForDeletion() )
+            _transformList[i]->MarkForDeletion();
+    }
+
+    // Go through each object and either delete or update them. Deleting moves
+    // the last object into the deleted object's place, so it's checked next.
+    size_t i = 0;
+    while( i < _objectList.GetSize() )
+    {
+        iObject * pObject = _objectList.GetAt( i ).pObject;
+
+        // If the object is marked for deletion, delete it.
+        if( pObject->IsMarkedForDeletion() )
+            DeleteObject( _objectList.GetHandleAt( i ) );
+        // Otherwise update it.
+        else
+        {
+            pObject->Update();
+            ++i;
+        }
+    }
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Transform all the sprites in the manager. The objects are visited top
+/// down, so each object is transformed once and hands its changes to its
+/// children before they are transformed. Objects marked for deletion are
+/// skipped, since they're deleted on the next update.
+/// </summary>
+/// *************************************************************************
+void CSpriteManager::Transform()
+{
+    UpdateTopology();
+
+    // Compose the matrices of the objects that have one in a single pass, before
+    // the objects are transformed, so children can use their parents' matrices.
+    for( size_t i = 0; i < _transformList.size(); ++i )
+    {
+        iObject * pObject = _transformList[i];
+        if( pObject->IsMarkedForDeletion() )
+            continue;
+
+        CBitmask<uint> modified = pObject->GetModified();
+
+        if( pObject->GetMatrix() &&
+            (!_transformBatch.IsSet( (uint)i ) || modified.ContainsOne( ETT_POSITION | ETT_ROTATION | ETT_SCALE )) )
+        {
+            // Objects given a parent with the ignore flag are still in world space this frame.
+            SetBatchNode( _transformBatch, (uint)i, pObject, modified.Contains( ETT_IGNORE ) );
+        }
+    }
+
+    _transformBatch.Compose();
+
+    for( size_t i = 0; i < _transformList.size(); ++i )
+    {
+        iObject * pObject = _transformList[i];
+        if( pObject->IsMarkedForDeletion() )
+            continue;
+
+        // The parent has been transformed already, so its changes are final.
+        int parent = _transformBatch.GetParent( (uint)i );
+        if( parent != CTransformBatch::NO_PARENT )
+            pObject->InheritModified( _transformList[parent]->GetModified() );
+
+        if( _transformBatch.IsUpdated( (uint)i ) )
+            pObject->SetWorldMatrix( _transformBatch.GetWorld( (uint)i ) );
+
+        bool ignoreParent = pObject->GetModified().Contains( ETT_IGNORE );
+
+        pObject->Transform();
+
+        // The object has made its transformation relative to its parent, so the batch needs the new values.
+        if( ignoreParent && pObject->GetMatrix() )
+            SetBatchNode( _transformBatch, (uint)i, pObject, false );
+    }
+
+    // Clear the modified bitmask of this manager's sprites only. Objects owned by
+    // other managers share the store and still have their changes to consume.
+    for( auto pObject : _transformList )
+        pObject->ClearModified();
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Bring the transform list up to date with the objects that have been
+/// added, deleted or given a new parent. A new parent that already comes
+/// before the object only needs its index set. The list is only reordered
+/// when objects have been deleted or a parent has ended up after its child.
+/// </summary>
+/// *************************************************************************
+void CSpriteManager::UpdateTopology()
+{
+    CTransformStore::Instance().TakeParentChanges( _parentChangeList );
 
-    // Go through each object and either delete or update them.
-    auto mapIter = _objectList.begin();
-    while( mapIter != _objectList.end() )
+    // The parents that weren't in the manager may have been added since.
+    if( _objectAdded )
     {
-        auto objectIter = mapIter->second.begin();
-        while( objectIter != mapIter->second.end() )
+        _parentChangeList.insert( _parentChangeList.end(), _unresolvedList.begin(), _unresolvedList.end() );
+        _unresolvedList.clear();
+        _objectAdded = false;
+    }
+
+    bool outOfOrder = false;
+
+    for( auto handle : _parentChangeList )
+    {
+        CObjectEntry * pEntry = _objectList.Get( handle );
+        if( !pEntry )
+            continue;
+
+        iObject * pObject = pEntry->pObject;
+        int parentIndex = CTransformBatch::NO_PARENT;
+
+        if( pObject->GetParent() )
         {
-            // If the object is marked for deletion, delete it.
-            if( (*objectIter)->IsMarkedForDeletion() )
+            uint parentHandle = pObject->ResolveParentHandle();
+            CObjectEntry * pParentEntry = _objectList.Get( parentHandle );
+
+            if( pParentEntry )
+                parentIndex = (int)pParentEntry->transformIndex;
+
+            // The parent isn't in the manager, so the object is transformed as a
+            // root until the parent is added.
+            else if( parentHandle == CSlotMap<CObjectEntry>::NULL_HANDLE )
             {
-                NDelFunc::Delete( (*objectIter) );
-                objectIter = mapIter->second.erase( objectIter );
+                if( find( _unresolvedList.begin(), _unresolvedList.end(), handle ) == _unresolvedList.end() )
+                    _unresolvedList.push_back( handle );
             }
-            // Otherwise update it.
+
+            // The parent was deleted without the object being marked. Drop the
+            // dangling parent and delete the object like the rest of the branch.
             else
             {
-                (*objectIter)->Update();
-                ++objectIter;
+                pObject->SetParent( nullptr );
+                pObject->MarkForDeletion();
             }
         }
 
-        // If a deletion happened and a vector is now empty, delete the vector.
-        if( mapIter->second.empty() )
-            mapIter = _objectList.erase( mapIter );
+        _transformBatch.SetParent( pEntry->transformIndex, parentIndex );
+        outOfOrder = outOfOrder || (parentIndex > (int)pEntry->transformIndex);
+    }
+
+    _parentChangeList.clear();
+
+    if( outOfOrder || (_removedCount > 0) )
+        Reorder();
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Drop the deleted objects from the transform list and put every parent
+/// before its children, in one pass. Objects already after their parent
+/// keep their order. An object before its parent waits for the parent and
+/// is put right after it, with its own children following.
+/// </summary>
+/// *************************************************************************
+void CSpriteManager::Reorder()
+{
+    size_t count = _transformList.size();
+
+    _orderList.clear();
+    _newIndexList.assign( count, -1 );
+    _waitingList.assign( count, -1 );
+    _nextWaitingList.assign( count, -1 );
+
+    for( uint i = 0; i < count; ++i )
+    {
+        iObject * pObject = _transformList[i];
+        if( !pObject )
+            continue;
+
+        int parent = _transformBatch.GetParent( i );
+
+        // The parent was deleted without the object being marked. Drop the
+        // dangling parent and delete the object like the rest of the branch.
+        if( (parent != CTransformBatch::NO_PARENT) && !_transformList[parent] )
+        {
+            pObject->SetParent( nullptr );
+            pObject->MarkForDeletion();
+            _transformBatch.SetParent( i, CTransformBatch::NO_PARENT );
+            parent = CTransformBatch::NO_PARENT;
+        }
+
+        if( (parent == CTransformBatch::NO_PARENT) || (_newIndexList[parent] >= 0) )
+            AddToOrder( i );
         else
-            ++mapIter;
+        {
+            _nextWaitingList[i] = _waitingList[parent];
+            _waitingList[parent] = (int)i;
+        }
+    }
+
+    // Anything left hangs off a loop of parents, which can't be ordered. Each
+    // branch is cut off from its parent where it's met.
+    if( _orderList.size() + _removedCount < count )
+    {
+        for( uint i = 0; i < count; ++i )
+        {
+            if( _transformList[i] && (_newIndexList[i] < 0) )
+            {
+                _transformList[i]->SetParent( nullptr );
+                _transformBatch.SetParent( i, CTransformBatch::NO_PARENT );
+                AddToOrder( i );
+            }
+        }
     }
+
+    _transformBatch.Reorder( _orderList );
+
+    _reorderedList.clear();
+    for( uint i = 0; i < _orderList.size(); ++i )
+    {
+        iObject * pObject = _transformList[_orderList[i]];
+        _objectList.Get( pObject->GetHandle() )->transformIndex = i;
+        _reorderedList.push_back( pObject );
+    }
+
+    _transformList.swap( _reorderedList );
+    _removedCount = 0;
 }
 
 
 /// *************************************************************************
 /// <summary> 
-/// Transform all the sprites in the manager.
+/// Add the object to the new order, followed by the children that were
+/// waiting for it, and then by the children waiting for those.
 /// </summary>
+/// <param name="index"> Old index of the object in the transform list. </param>
 /// *************************************************************************
-void CSpriteManager::Transform()
+void CSpriteManager::AddToOrder( uint index )
 {
-    // Transform each of the sprites.
-    for( auto mapIter = _objectList.begin(); mapIter != _objectList.end(); ++mapIter )
-        for( auto pSprite : mapIter->second )
-            pSprite->Transform();
-
-    // Clear the modified bitmask for each of the sprites.
-    for( auto mapIter = _objectList.begin(); mapIter != _objectList.end(); ++mapIter )
-        for( auto pSprite : mapIter->second )
-            pSprite->ClearModified();
+    size_t next = _orderList.size();
+
+    _newIndexList[index] = (int)_orderList.size();
+    _orderList.push_back( index );
+
+    for( ; next < _orderList.size(); ++next )
+    {
+        for( int child = _waitingList[_orderList[next]]; child >= 0; child = _nextWaitingList[child] )
+        {
+            // Children cut off from a loop of parents have been added already.
+            if( _newIndexList[child] < 0 )
+            {
+                _newIndexList[child] = (int)_orderList.size();
+                _orderList.push_back( (uint)child );
+            }
+        }
+    }
 }
\ No newline at end of file
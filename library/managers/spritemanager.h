@@ -3,11 +3,14 @@
 
 // Game lib dependencies
 #include <common\defs.h>
+#include <common\slotmap.h>
+#include <common\transformbatch.h>
 
 // Standard lib dependencies
 #include <string>
 #include <map>
 #include <vector>
+#include <functional>
 
 // Forward declarations
 class CSpriteData3D;
@@ -17,6 +20,9 @@ class CSprite3D;
 class CSprite2D;
 class CTextSprite;
 class iObject;
+class CCollectionObject;
+class CPreloader;
+class CDataFile;
 
 /// *************************************************************************
 /// <summary> 
@@ -49,6 +55,9 @@ public:
     CSpriteData2D * GetSpriteData2D( const std::string & name );
     CTextSpriteData * GetTextSpriteData( const std::string & name );
 
+    // Add jobs to load the sprite and collection data that isn't loaded yet.
+    void Preload( CPreloader & preloader );
+
     // Create the sprite.
     CSprite3D * CreateSprite3D( const std::string & name, const std::string & key = "" );
     CSprite2D * CreateSprite2D( const std::string & name, const std::string & key = "" );
@@ -57,6 +66,12 @@ public:
     // Create the collection of objects.
     std::vector<iObject *> CreateCollection( const std::string & name, const std::string & key = "" );
 
+    // Get the object the handle refers to. Returns null if the object has been deleted.
+    iObject * GetObjectFromHandle( uint handle );
+
+    // Get the objects listed under the key, in the order they were created.
+    std::vector<iObject *> GetObjectList( const std::string & key );
+
     // Reposition all sprites.
     void RepositionAllSprites();
 
@@ -71,8 +86,51 @@ private:
     CSpriteManager();
     virtual ~CSpriteManager();
 
+    // Bring the transform list up to date with the objects added, deleted or given a new parent.
+    void UpdateTopology();
+
+    // Drop the deleted objects from the transform list and put parents before their children.
+    void Reorder();
+
+    // Add the object to the new order, followed by the children waiting for it.
+    void AddToOrder( uint index );
+
+    // Add the object to the object list and the name index.
+    void AddObject( iObject * pObject, const std::string & key );
+
+    // Delete the object and remove it from the object list and the name index.
+    void DeleteObject( uint handle );
+
+    // Pass each object of the collection to the callback.
+    void ForEachCollectionObject( const std::string & name, const std::function<void( const CCollectionObject & )> & callback );
+
+    // Read the collection file into a new list of objects.
+    static std::vector<CCollectionObject> * LoadCollection( const CDataFile & file );
+
+    // Read the collection file, passing each object on as it's parsed.
+    static void StreamCollection( const CDataFile & file, const std::function<void( const CCollectionObject & )> & callback );
+
 private:
 
+    /// *************************************************************************
+    /// <summary> 
+    /// Object held by the manager and the key it's listed under.
+    /// </summary>
+    /// *************************************************************************
+    class CObjectEntry
+    {
+    public:
+
+        // The object. This pointer belongs to the manager.
+        iObject * pObject = nullptr;
+
+        // Key the object is listed under in the name index.
+        std::string key;
+
+        // Index of the object in the transform list.
+        uint transformIndex = 0;
+    };
+
     // Map containing the list of sprite data files.
     std::map<const std::string, const std::string> _spriteDataFileList3d;
     std::map<const std::string, const std::string> _spriteDataFileList2d;
@@ -81,13 +139,50 @@ private:
     // Map containing the list of collection files.
     std::map<const std::string, const std::string> _collectionFileList;
 
+    // Map containing the parsed objects of each collection that's been created.
+    std::map<const std::string, std::vector<CCollectionObject> *> _collectionList;
+
     // Map containing the list of loaded sprite data.
     std::map<const std::string, CSpriteData3D *> _spriteDataList3d;
     std::map<const std::string, CSpriteData2D *> _spriteDataList2d;
     std::map<const std::string, CTextSpriteData *> _textSpriteDataList;
 
-    // Map containing the list of loaded objects.
-    std::map<const std::string, std::vector<iObject *>> _objectList;
+    // Slot map containing the list of loaded objects.
+    CSlotMap<CObjectEntry> _objectList;
+
+    // Map containing the handles of the objects listed under each key, in the
+    // order the objects were created.
+    std::map<const std::string, std::vector<uint>> _nameIndex;
+
+    // Objects ordered so every parent comes before its children. Deleted objects
+    // leave a null until the list is reordered.
+    std::vector<iObject *> _transformList;
+
+    // Holds the index of each object's parent in the transform list, and composes
+    // the matrices of the objects that have one.
+    CTransformBatch _transformBatch;
+
+    // Number of nulls in the transform list.
+    uint _removedCount = 0;
+
+    // Handles of the objects whose parent has changed since the transform list was updated.
+    std::vector<uint> _parentChangeList;
+
+    // Handles of the objects whose parent isn't in the manager. They're checked
+    // again once objects have been added.
+    std::vector<uint> _unresolvedList;
+
+    // Whether objects have been added since the unresolved objects were checked.
+    bool _objectAdded = false;
+
+    // Old index of each object in the new order, the new index of each object,
+    // and the children waiting for each object to be ordered. Kept between
+    // reorders to save allocating them.
+    std::vector<uint> _orderList;
+    std::vector<int> _newIndexList;
+    std::vector<int> _waitingList;
+    std::vector<int> _nextWaitingList;
+    std::vector<iObject *> _reorderedList;
 };
 
 #endif  // __sprite_manager_h__
@@ -4,10 +4,13 @@
 // Game lib dependencies
 #include <angelscript.h>
 #include <common\iobject.h>
+#include <common\quaternion.h>
 #include <script\animationdata.h>
 #include <managers\scriptmanager.h>
+#include <managers\animationmanager.h>
 #include <script\scriptglobals.h>
 #include <utilities\exceptionhandling.h>
+#include <agk.h>
 
 // Boost lib dependencies
 #include <boost\format.hpp>
@@ -32,10 +35,11 @@ CAnimation::CAnimation()
 /// </summary>
 /// <param name="pData"> Data to initialize the animation. </param> 
 /// <param name="pObject"> Object to apply the animation to. </param> 
+/// <param name="pComponent"> Component the animation belongs to. </param> 
 /// *************************************************************************
-CAnimation::CAnimation( const CAnimationData * pData, iObject * pObject, uint conflictIndex )
+CAnimation::CAnimation( const CAnimationData * pData, iObject * pObject, CAnimationComponent * pComponent, uint conflictIndex )
 {
-    Init( pData, pObject, conflictIndex );
+    Init( pData, pObject, pComponent, conflictIndex );
 }
 
 
@@ -56,8 +60,9 @@ CAnimation::~CAnimation()
 /// </summary>
 /// <param name="pData"> Data to initialize the animation. </param> 
 /// <param name="pObject"> Object to apply the animation to. </param> 
+/// <param name="pComponent"> Component the animation belongs to. </param> 
 /// *************************************************************************
-void CAnimation::Init( const CAnimationData * pData, iObject * pObject, uint conflictIndex )
+void CAnimation::Init( const CAnimationData * pData, iObject * pObject, CAnimationComponent * pComponent, uint conflictIndex )
 {
     if( !pData || !pObject )
         return;
@@ -66,6 +71,7 @@ void CAnimation::Init( const CAnimationData * pData, iObject * pObject, uint con
 
     _pData = pData;
     _pObject = pObject;
+    _pComponent = pComponent;
     _conflictIndex = conflictIndex;
 }
 
@@ -81,9 +87,11 @@ void CAnimation::Clear()
 
     _pData = nullptr;
     _pObject = nullptr;
+    _pComponent = nullptr;
     _stopType = EST_NULL;
     _conflictIndex = 0;
     _pContextList.clear();
+    _pFunctionList.clear();
 }
 
 
@@ -100,8 +108,33 @@ void CAnimation::Play()
     // Make sure everything is cleared and recycled before we start a script.
     Recycle();
 
-    for( auto & function : _pData->GetFunctionList() )
-        _pContextList.push_back( CScriptManager::Instance().Prepare( function, { this } ) );
+    // Look the functions up once so playing again doesn't search for them by name.
+    // A rebuilt or discarded module has freed the ones looked up before.
+    uint generation = CScriptManager::Instance().GetModuleGeneration();
+    if( (_pFunctionList.size() != _pData->GetFunctionList().size()) || (_functionGeneration != generation) )
+    {
+        _pFunctionList.clear();
+        _functionGeneration = generation;
+
+        for( auto & function : _pData->GetFunctionList() )
+            _pFunctionList.push_back( CScriptManager::Instance().GetPtrToFunc( function ) );
+    }
+
+    for( auto pFunction : _pFunctionList )
+        Start( CScriptManager::Instance().Prepare( pFunction, this ) );
+
+    // Remember where each track's field started, for relative keyframes and resets.
+    auto & trackList = _pData->GetTrackList();
+    if( !trackList.empty() )
+    {
+        _trackStartList.clear();
+        for( auto & track : trackList )
+            _trackStartList.push_back( GetField( track.GetField() ) );
+
+        _trackState = ETS_PLAYING;
+        _trackTime = 0;
+        _trackLoop = 0;
+    }
 }
 
 
@@ -141,8 +174,10 @@ void CAnimation::Recycle()
         }
 
         _pContextList.clear();
+        _pRunningList.clear();
     }
 
+    _trackState = ETS_NULL;
     _stopType = EST_NULL;
 }
 
@@ -246,6 +281,22 @@ const CVector3<float> & CAnimation::GetRot() const
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Set the object's rotation part of the way between two rotations. The
+/// rotations are blended as quaternions, so the object turns the shortest
+/// way between them.
+/// </summary>
+/// <param name="from"> Rotation at the start, in degrees. </param>
+/// <param name="to"> Rotation at the end, in degrees. </param>
+/// <param name="t"> How far between the rotations, from 0 to 1. </param>
+/// *************************************************************************
+void CAnimation::SlerpRot( const CVector3<float> & from, const CVector3<float> & to, float t )
+{
+    _pObject->SetOrientation( CQuaternion( from ).Slerp( CQuaternion( to ), t ) );
+}
+
+
 /// *************************************************************************
 /// <summary>
 /// Set the object's size.
@@ -367,6 +418,19 @@ bool CAnimation::IsVisible() const
 }
 
 
+/// *************************************************************************
+/// <summary>
+/// Get the handle of the object. Unlike the object, the handle can be kept
+/// by a script and checked later, since a deleted object's handle is never
+/// given to another object.
+/// </summary>
+/// *************************************************************************
+uint CAnimation::GetHandle() const
+{
+    return _pObject->GetHandle();
+}
+
+
 /// *************************************************************************
 /// <summary>
 /// Whether or not the animation is playing.
@@ -374,7 +438,23 @@ bool CAnimation::IsVisible() const
 /// *************************************************************************
 bool CAnimation::IsPlaying() const
 {
-    return _pContextList.size() > 0;
+    return (_pContextList.size() > 0) || (_trackState != ETS_NULL);
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Whether the animation has anything to do when it's updated. A paused
+/// animation, or one whose contexts are all waiting, is still playing but
+/// has nothing to do until it's unpaused or a context wakes up.
+/// </summary>
+/// *************************************************************************
+bool CAnimation::IsAwake() const
+{
+    if( _stopType == EST_PAUSE )
+        return false;
+
+    return (_pRunningList.size() > 0) || (_trackState != ETS_NULL);
 }
 
 
@@ -419,7 +499,9 @@ uint CAnimation::GetConflictIndex() const
 /// *************************************************************************
 void CAnimation::Spawn( const std::string & function )
 {
-    _pContextList.push_back( CScriptManager::Instance().Prepare( function, { this } ) );
+    CScriptManager & scriptManager = CScriptManager::Instance();
+
+    Start( scriptManager.Prepare( scriptManager.GetPtrToFunc( function ), this ) );
 }
 
 
@@ -434,12 +516,18 @@ void CAnimation::Update()
     if( _stopType == EST_PAUSE )
         return;
 
-    vector<asIScriptContext *> pEraseList;
+    if( _trackState != ETS_NULL )
+        UpdateTracks( agk::GetFrameTime() );
+
+    CScriptScheduler & scheduler = CScriptManager::Instance().GetScheduler();
 
-    // Use an indexed loop here just in case a script spawns another context.
-    for( uint i = 0; i < _pContextList.size(); i++ )
+    // Only the running contexts are executed. Waiting ones are handed back by
+    // Wake(). Use an indexed loop here just in case a script spawns or wakes
+    // another context.
+    uint i = 0;
+    while( i < _pRunningList.size() )
     {
-        auto pContext = _pContextList[i];
+        auto pContext = _pRunningList[i];
 
         // See if this context is still being used.
         if( (pContext->GetState() == asEXECUTION_SUSPENDED) ||
@@ -453,16 +541,212 @@ void CAnimation::Update()
                         boost::str( boost::format( "There was an error executing the script.\n\n%s\nLine: %s" )
                                                    % __FUNCTION__ % __LINE__ ) );
             }
-    
-            // Return the context to the pool if it has not been suspended.
-            if( pContext->GetState() != asEXECUTION_SUSPENDED )
-                pEraseList.push_back( pContext );
+
+            // The script may have stopped its own animation, which recycles every context.
+            if( _pRunningList.empty() )
+                return;
+
+            // Keep running the context next frame unless it went to sleep.
+            if( pContext->GetState() == asEXECUTION_SUSPENDED )
+            {
+                if( scheduler.IsWaiting( pContext ) )
+                    _pRunningList.erase( _pRunningList.begin() + i );
+                else
+                    ++i;
+
+                continue;
+            }
+
+            // The context has finished.
+            _pContextList.erase( std::find( _pContextList.begin(), _pContextList.end(), pContext ) );
+        }
+
+        _pRunningList.erase( _pRunningList.begin() + i );
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Start running a prepared context. It's given a wake callback, so that it
+/// can be left out of the running list while it waits.
+/// </summary>
+/// <param name="pContext"> The context to run. </param>
+/// *************************************************************************
+void CAnimation::Start( asIScriptContext * pContext )
+{
+    _pContextList.push_back( pContext );
+    _pRunningList.push_back( pContext );
+
+    CScriptManager::Instance().GetScheduler().SetWakeCallback( pContext,
+        [this]( asIScriptContext * pWokenContext ) { Wake( pWokenContext ); } );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Put a context that woke up back in the running list, and have the
+/// component updated again in case it went idle while the context slept.
+/// </summary>
+/// <param name="pContext"> The context that woke up. </param>
+/// *************************************************************************
+void CAnimation::Wake( asIScriptContext * pContext )
+{
+    _pRunningList.push_back( pContext );
+
+    if( _pComponent )
+        CAnimationManager::Instance().Add( _pComponent );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Advance the tracks and set their fields on the object. The tracks follow
+/// the same rules as the scripts: they loop until the loop count is reached,
+/// breaking ends them right away, finishing ends them after the current loop,
+/// and the end type decides what happens to the fields afterwards.
+/// </summary>
+/// <param name="elapsedTime"> Seconds since the last update. </param>
+/// *************************************************************************
+void CAnimation::UpdateTracks( float elapsedTime )
+{
+    auto & trackList = _pData->GetTrackList();
+
+    if( _trackState == ETS_RESETTING )
+    {
+        _trackTime += elapsedTime;
+        float t = min( _trackTime / TRACK_RESET_TIME, 1.f );
+
+        for( size_t i = 0; i < trackList.size(); ++i )
+            SetField( trackList[i].GetField(), _trackResetList[i] + (_trackStartList[i] - _trackResetList[i]) * t );
+
+        if( t >= 1.f )
+            _trackState = ETS_NULL;
+
+        return;
+    }
+
+    if( _stopType == EST_BREAK )
+    {
+        EndTracks();
+        return;
+    }
+
+    float duration = _pData->GetTrackDuration();
+    _trackTime += elapsedTime;
+
+    // Start another loop for each one the time has passed.
+    bool ended = false;
+    while( (_trackTime >= duration) && !ended )
+    {
+        ++_trackLoop;
+
+        if( ((GetLoopCount() != 0) && (_trackLoop >= GetLoopCount())) ||
+            (_stopType == EST_FINISH) || (duration <= 0) )
+        {
+            _trackTime = duration;
+            ended = true;
         }
+        else
+            _trackTime -= duration;
+    }
+
+    for( size_t i = 0; i < trackList.size(); ++i )
+    {
+        CVector4<float> value = trackList[i].Evaluate( _trackTime );
+
+        if( trackList[i].IsRelative() && (trackList[i].GetField() != ETF_VISIBLE) )
+            value += _trackStartList[i];
+
+        SetField( trackList[i].GetField(), value );
+    }
+
+    if( ended )
+        EndTracks();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// End the tracks according to the end type. A gradual reset keeps them
+/// playing until the fields are back where they started.
+/// </summary>
+/// *************************************************************************
+void CAnimation::EndTracks()
+{
+    auto & trackList = _pData->GetTrackList();
+
+    _trackState = ETS_NULL;
+
+    if( GetEndType() == EET_INSTANT_RESET )
+    {
+        for( size_t i = 0; i < trackList.size(); ++i )
+            SetField( trackList[i].GetField(), _trackStartList[i] );
     }
+    else if( GetEndType() == EET_GRADUAL_RESET )
+    {
+        _trackResetList.clear();
+        for( auto & track : trackList )
+            _trackResetList.push_back( GetField( track.GetField() ) );
+
+        _trackState = ETS_RESETTING;
+        _trackTime = 0;
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Set the field a track changes on the object.
+/// </summary>
+/// <param name="field"> The field to set. </param>
+/// <param name="value"> The field's value, in the track's layout. </param>
+/// *************************************************************************
+void CAnimation::SetField( ETrackField field, const CVector4<float> & value )
+{
+    if( field == ETF_POSITION )
+        _pObject->SetPos( value.x, value.y, value.z );
+
+    else if( field == ETF_ROTATION )
+        _pObject->SetRot( value.x, value.y, value.z );
+
+    else if( field == ETF_SIZE )
+        _pObject->SetSize( value.x, value.y, value.z );
+
+    else if( field == ETF_COLOR )
+        _pObject->SetColor( value );
+
+    else if( field == ETF_ALPHA )
+        _pObject->SetColorA( value.x );
+
+    else if( field == ETF_VISIBLE )
+        _pObject->SetVisible( value.x >= 0.5f );
+}
+
+/// <summary>
+/// Get the field a track changes from the object.
+/// </summary>
+CVector4<float> CAnimation::GetField( ETrackField field ) const
+{
+    if( field == ETF_POSITION )
+        return _pObject->GetPos();
+
+    else if( field == ETF_ROTATION )
+        return _pObject->GetRot();
+
+    else if( field == ETF_SIZE )
+        return _pObject->GetSize();
+
+    else if( field == ETF_COLOR )
+        return _pObject->GetColor();
+
+    else if( field == ETF_ALPHA )
+        return CVector4<float>( _pObject->GetColor().a );
+
+    else if( field == ETF_VISIBLE )
+        return CVector4<float>( _pObject->IsVisible() ? 1.f : 0.f );
 
-    // 
-    for( auto pContext : pEraseList )
-        _pContextList.erase( std::find(_pContextList.begin(), _pContextList.end(), pContext) );
+    return CVector4<float>();
 }
 
 
@@ -488,6 +772,7 @@ void CAnimation::Register( asIScriptEngine * pEngine )
     Throw( pEngine->RegisterObjectMethod( "CAnimation", "void SetColor(const CColor &in)",  asMETHOD( CAnimation, SetColor ), asCALL_THISCALL ) );
     Throw( pEngine->RegisterObjectMethod( "CAnimation", "void SetColorA(int a)",            asMETHOD( CAnimation, SetColorA ), asCALL_THISCALL ) );
     Throw( pEngine->RegisterObjectMethod( "CAnimation", "void SetVisible(bool visible)",    asMETHOD( CAnimation, SetVisible ), asCALL_THISCALL ) );
+    Throw( pEngine->RegisterObjectMethod( "CAnimation", "void SlerpRot(const CVector3 &in, const CVector3 &in, float t)", asMETHOD( CAnimation, SlerpRot ), asCALL_THISCALL ) );
 
     Throw( pEngine->RegisterObjectMethod( "CAnimation", "void IncPos(const CVector3 &in)",  asMETHOD( CAnimation, IncPos ), asCALL_THISCALL ) );
     Throw( pEngine->RegisterObjectMethod( "CAnimation", "void IncRot(const CVector3 &in)",  asMETHOD( CAnimation, IncRot ), asCALL_THISCALL ) );
@@ -501,6 +786,7 @@ void CAnimation::Register( asIScriptEngine * pEngine )
     Throw( pEngine->RegisterObjectMethod( "CAnimation", "const CColor & GetColor()",  asMETHOD( CAnimation, GetColor ), asCALL_THISCALL ) );
     Throw( pEngine->RegisterObjectMethod( "CAnimation", "int GetColorA()",            asMETHOD( CAnimation, GetColorA ), asCALL_THISCALL ) );
     Throw( pEngine->RegisterObjectMethod( "CAnimation", "bool IsVisible()",           asMETHOD( CAnimation, IsVisible ), asCALL_THISCALL ) );
+    Throw( pEngine->RegisterObjectMethod( "CAnimation", "uint GetHandle()",           asMETHOD( CAnimation, GetHandle ), asCALL_THISCALL ) );
 
     Throw( pEngine->RegisterObjectMethod( "CAnimation", "void Spawn(string &in)", asMETHOD( CAnimation, Spawn ), asCALL_THISCALL ) );
 }
\ No newline at end of file
@@ -13,8 +13,10 @@
 // Forward declarations
 class iObject;
 class CAnimationData;
+class CAnimationComponent;
 class asIScriptContext;
 class asIScriptEngine;
+class asIScriptFunction;
 
 /// *************************************************************************
 /// <summary> 
@@ -26,11 +28,11 @@ class CAnimation
 public:
 
     CAnimation();
-    CAnimation( const CAnimationData * pData, iObject * pObject, uint conflictIndex );
+    CAnimation( const CAnimationData * pData, iObject * pObject, CAnimationComponent * pComponent, uint conflictIndex );
     ~CAnimation();
 
     // Initialize the animation.
-    void Init( const CAnimationData * pData, iObject * pObject, uint conflictIndex );
+    void Init( const CAnimationData * pData, iObject * pObject, CAnimationComponent * pComponent, uint conflictIndex );
 
     // Clear the animation.
     void Clear();
@@ -63,6 +65,9 @@ public:
     void IncRot( const CVector3<float> & rot );
     const CVector3<float> & GetRot() const;
 
+    // Set the object's rotation part of the way between two rotations.
+    void SlerpRot( const CVector3<float> & from, const CVector3<float> & to, float t );
+
     // Access functions for the object's size.
     void SetSize( const CVector3<float> & size );
     void IncSize( const CVector3<float> & size );
@@ -82,9 +87,15 @@ public:
     void SetVisible( bool visible );
     bool IsVisible() const;
 
+    // Get the handle of the object, which scripts can hold onto safely.
+    uint GetHandle() const;
+
     // Whether or not the animation is playing.
     bool IsPlaying() const;
 
+    // Whether the animation has anything to do when it's updated.
+    bool IsAwake() const;
+
     // Get the number of times to loop the animation.
     int GetLoopCount() const;
 
@@ -103,6 +114,35 @@ public:
     // Register the class with AngelScript.
     static void Register( asIScriptEngine * pEngine );
 
+private:
+
+    // Seconds a gradual reset of the tracks takes.
+    static constexpr float TRACK_RESET_TIME = 0.25f;
+
+    // Where the tracks are in playing.
+    enum ETrackState
+    {
+        ETS_NULL,         // The tracks aren't playing.
+        ETS_PLAYING,      // The tracks are playing their keyframes.
+        ETS_RESETTING     // The tracks are gradually restoring their fields.
+    };
+
+    // Start running a prepared context.
+    void Start( asIScriptContext * pContext );
+
+    // Put a context that woke up back in the running list.
+    void Wake( asIScriptContext * pContext );
+
+    // Advance the tracks and set their fields on the object.
+    void UpdateTracks( float elapsedTime );
+
+    // End the tracks according to the end type.
+    void EndTracks();
+
+    // Access functions for the field a track changes.
+    void SetField( NDefs::ETrackField field, const CVector4<float> & value );
+    CVector4<float> GetField( NDefs::ETrackField field ) const;
+
 private:
 
     // Default data of the animation.
@@ -111,17 +151,43 @@ private:
     // The object to animate. This is not owned by the animation.
     iObject * _pObject = nullptr;
 
-    // A list of each function that needs to play when this animation is played.
-    std::vector<std::string> _functionList;
+    // The component the animation belongs to. This is not owned by the animation.
+    CAnimationComponent * _pComponent = nullptr;
+
+    // Each function that needs to play when this animation is played. These
+    // are looked up the first time the animation plays, and again once the
+    // scripts have been rebuilt.
+    std::vector<asIScriptFunction *> _pFunctionList;
+
+    // Module generation the functions were looked up in.
+    uint _functionGeneration = 0;
 
     // The context used to animate the object. These are not owned by the animation.
     std::vector<asIScriptContext *> _pContextList;
 
+    // The contexts that aren't waiting. Waiting ones are left out until they wake up.
+    std::vector<asIScriptContext *> _pRunningList;
+
     // This variable is set when the animation needs to stop prematurely.
     NDefs::EStopType _stopType = NDefs::EST_NULL;
 
     // The index into whichever conflict list this animation belongs to. 
     uint _conflictIndex = 0;
+
+    // Where the tracks are in playing.
+    ETrackState _trackState = ETS_NULL;
+
+    // Seconds into the tracks' current loop, or into the reset.
+    float _trackTime = 0;
+
+    // Number of loops of the tracks played.
+    int _trackLoop = 0;
+
+    // Each track's field when the animation started playing.
+    std::vector<CVector4<float>> _trackStartList;
+
+    // Each track's field when a gradual reset started.
+    std::vector<CVector4<float>> _trackResetList;
 };
 
 
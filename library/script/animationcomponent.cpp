@@ -5,9 +5,13 @@
 #include <script\animation.h>
 #include <script\animationdata.h>
 #include <managers\scriptmanager.h>
+#include <managers\animationmanager.h>
 #include <utilities\deletefuncs.h>
 #include <utilities\generalfuncs.h>
 
+// Standard lib dependencies
+#include <algorithm>
+
 using namespace std;
 using namespace NDefs;
 
@@ -60,8 +64,12 @@ void CAnimationComponent::Init( iObject * pObject, const vector<vector<string>>
         for( uint i = 0; i < conflictList.size(); i++ )
         {
             const CAnimationData * pData = CScriptManager::Instance().GetAnimationData( conflictList[i] );
-            _pAnimationList.emplace( pData->GetName(), new CAnimation( pData, pObject, i ) );
+            _pAnimationList.emplace( pData->GetName(), new CAnimation( pData, pObject, this, i ) );
         }
+
+        // Make room for a playing animation in each conflict index.
+        if( conflictList.size() > _pConflictSlotList.size() )
+            _pConflictSlotList.resize( conflictList.size(), nullptr );
     }
 }
 
@@ -73,9 +81,14 @@ void CAnimationComponent::Init( iObject * pObject, const vector<vector<string>>
 /// *************************************************************************
 void CAnimationComponent::Clear()
 {
+    // Checked first, since objects can be cleared after the manager is destroyed.
+    if( _activeIndex >= 0 )
+        CAnimationManager::Instance().Remove( this );
+
     NDelFunc::DeleteMapPointers( _pAnimationList );
     _pAnimationQueue.clear();
     _pPlayingList.clear();
+    _pConflictSlotList.clear();
 }
 
 
@@ -94,8 +107,7 @@ void CAnimationComponent::Play( const string & name, EStopType stopType )
         return;
 
     // If this animation is already queued up, don't queue it again.
-    auto iter = _pAnimationQueue.find( name );
-    if( iter != _pAnimationQueue.end() )
+    if( find( _pAnimationQueue.begin(), _pAnimationQueue.end(), animIter->second ) != _pAnimationQueue.end() )
         return;
 
     // Get any conflicting animation playing.
@@ -121,8 +133,11 @@ void CAnimationComponent::Play( const string & name, EStopType stopType )
             pConflict->Stop( stopType );
 
         // Add this animation to the queue.
-        _pAnimationQueue.emplace( name, animIter->second );
+        _pAnimationQueue.push_back( animIter->second );
     }
+
+    // Have the component updated until the change plays out.
+    CAnimationManager::Instance().Add( this );
 }
 
 
@@ -134,8 +149,11 @@ void CAnimationComponent::Play( const string & name, EStopType stopType )
 /// *************************************************************************
 void CAnimationComponent::Stop( NDefs::EStopType stopType )
 {
-    for( auto animIter : _pPlayingList )
-        animIter.second->Stop( stopType );
+    for( auto pAnimation : _pPlayingList )
+        pAnimation->Stop( stopType );
+
+    if( !_pPlayingList.empty() )
+        CAnimationManager::Instance().Add( this );
 }
 
 /// <summary>
@@ -145,9 +163,12 @@ void CAnimationComponent::Stop( NDefs::EStopType stopType )
 /// <param name="stopType"> How to end the animation. </param>
 void CAnimationComponent::Stop( const std::string & name, NDefs::EStopType stopType )
 {
-    auto iter = _pPlayingList.find( name );
-    if( iter != _pPlayingList.end() )
+    auto iter = _pAnimationList.find( name );
+    if( (iter != _pAnimationList.end()) && IsInPlayingList( iter->second ) )
+    {
         iter->second->Stop( stopType );
+        CAnimationManager::Instance().Add( this );
+    }
 }
 
 
@@ -162,8 +183,8 @@ bool CAnimationComponent::IsPlaying( bool includePaused )
     if( includePaused )
         return _pPlayingList.size() > 0;
 
-    for( auto animIter : _pPlayingList )
-        if( animIter.second->GetStopType() != EST_PAUSE )
+    for( auto pAnimation : _pPlayingList )
+        if( pAnimation->GetStopType() != EST_PAUSE )
             return true;
 
     return false;
@@ -176,8 +197,8 @@ bool CAnimationComponent::IsPlaying( bool includePaused )
 /// <param name="includePaused"> If paused animations should be consider "playing". </param>
 bool CAnimationComponent::IsPlaying( const std::string & name, bool includePaused )
 {
-    auto iter = _pPlayingList.find( name );
-    if( iter != _pPlayingList.end() )
+    auto iter = _pAnimationList.find( name );
+    if( (iter != _pAnimationList.end()) && IsInPlayingList( iter->second ) )
     {
         if( includePaused && iter->second->GetStopType() != EST_PAUSE )
             return false;
@@ -191,7 +212,10 @@ bool CAnimationComponent::IsPlaying( const std::string & name, bool includePause
 
 /// *************************************************************************
 /// <summary>
-/// Update the animation component.
+/// Update the animation component. Called by the animation manager while
+/// the component has animations queued or awake. Playing animations that
+/// are paused or waiting don't keep it on the manager's list; playing,
+/// stopping or waking an animation puts it back.
 /// </summary>
 /// *************************************************************************
 void CAnimationComponent::Update()
@@ -201,11 +225,14 @@ void CAnimationComponent::Update()
     auto queueIter = _pAnimationQueue.begin();
     while( queueIter != _pAnimationQueue.end() )
     {
+        CAnimation * pAnimation = *queueIter;
+
         // If there's no conflicting animation playing, play this animation.
-        if( !GetConflictingAnimation( queueIter->second ) )
+        if( !GetConflictingAnimation( pAnimation ) )
         {
-            queueIter->second->Play();
-            _pPlayingList.emplace( queueIter->first, queueIter->second );
+            pAnimation->Play();
+            _pPlayingList.push_back( pAnimation );
+            _pConflictSlotList[pAnimation->GetConflictIndex()] = pAnimation;
             queueIter = _pAnimationQueue.erase( queueIter );
         }
         else
@@ -213,18 +240,29 @@ void CAnimationComponent::Update()
     }
 
     // Update the playing animations.
-    for( auto animIter : _pPlayingList )
-        animIter.second->Update();
+    for( auto pAnimation : _pPlayingList )
+        pAnimation->Update();
 
     // Remove animations from the playing list if they've finished playing.
+    bool awake = false;
     auto playingIter = _pPlayingList.begin();
     while( playingIter != _pPlayingList.end() )
     {
-        if( playingIter->second->IsPlaying() )
+        if( (*playingIter)->IsPlaying() )
+        {
+            awake = awake || (*playingIter)->IsAwake();
             ++playingIter;
+        }
         else
+        {
+            _pConflictSlotList[(*playingIter)->GetConflictIndex()] = nullptr;
             playingIter = _pPlayingList.erase( playingIter );
+        }
     }
+
+    // Nothing left to do until an animation is played, stopped or woken up.
+    if( _pAnimationQueue.empty() && !awake )
+        CAnimationManager::Instance().Remove( this );
 }
 
 
@@ -232,8 +270,7 @@ void CAnimationComponent::Update()
 /// <summary>
 /// Get any animation currently playing that conflicts with the passed in animation.
 /// </summary>
-/// <param name="pAnimation"> Animation to compare against. </param>
-/// <param name="pConflictList"> List to fill with conflicting animations. </param>
+/// <param name="name"> Name of the animation to compare against. </param>
 /// *************************************************************************
 CAnimation * CAnimationComponent::GetConflictingAnimation( const string & name )
 {
@@ -248,15 +285,24 @@ CAnimation * CAnimationComponent::GetConflictingAnimation( const string & name )
 /// *************************************************************************
 /// <summary>
 /// Get any animation currently playing that conflicts with the passed in animation.
+/// Only one animation of each conflict index plays at a time, so it's whichever
+/// one holds the index's slot.
 /// </summary>
-/// <param name="name"> Name of the animation to compare against. </param>
-/// <param name="pConflictList"> List to fill with conflicting animations. </param>
+/// <param name="pAnimation"> Animation to compare against. </param>
 /// *************************************************************************
 CAnimation * CAnimationComponent::GetConflictingAnimation( const CAnimation * pAnimation )
 {
-    for( auto playingIter : _pPlayingList )
-        if( pAnimation->GetConflictIndex() == playingIter.second->GetConflictIndex() )
-            return playingIter.second;
+    return _pConflictSlotList[pAnimation->GetConflictIndex()];
+}
 
-    return nullptr;
+
+/// *************************************************************************
+/// <summary>
+/// Whether the animation is in the playing list. Stopped animations stay in
+/// it until the next update.
+/// </summary>
+/// *************************************************************************
+bool CAnimationComponent::IsInPlayingList( const CAnimation * pAnimation ) const
+{
+    return _pConflictSlotList[pAnimation->GetConflictIndex()] == pAnimation;
 }
\ No newline at end of file
@@ -4,7 +4,6 @@
 // Game lib dependencies
 #include <common\defs.h>
 #include <common\bitmask.h>
-#include <utilities\jsonparsehelper.h>
 
 // Standard lib dependencies
 #include <string>
@@ -13,6 +12,7 @@
 
 // Forward declarations
 class CAnimation;
+class iObject;
 
 /// *************************************************************************
 /// <summary>
@@ -52,19 +52,30 @@ public:
 
 private:
 
+    friend class CAnimationManager;
+
     // Get any animations currently playing that conflict with the passed in animation.
     CAnimation * GetConflictingAnimation( const CAnimation * pAnimation );
 
+    // Whether the animation is in the playing list.
+    bool IsInPlayingList( const CAnimation * pAnimation ) const;
+
 private:
 
     // List of animations.
     std::map<const std::string, CAnimation *> _pAnimationList;
 
-    // The animations waiting to be played.
-    std::map<const std::string, CAnimation *> _pAnimationQueue;
+    // The animations waiting to be played, in the order they were queued.
+    std::vector<CAnimation *> _pAnimationQueue;
 
     // List of animations currently playing.
-    std::map<const std::string, CAnimation *> _pPlayingList;
+    std::vector<CAnimation *> _pPlayingList;
+
+    // The playing animation of each conflict index, or null if there isn't one.
+    std::vector<CAnimation *> _pConflictSlotList;
+
+    // Index in the animation manager's active list, or -1 if it isn't on it.
+    int _activeIndex = -1;
 };
 
 #endif  // __animation_component_h__
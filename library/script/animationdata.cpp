@@ -1,6 +1,12 @@
 // Physical component dependency
 #include "animationdata.h"
 
+// Game lib dependencies
+#include <utilities\binarydata.h>
+
+// Standard lib dependencies
+#include <algorithm>
+
 using namespace NDefs;
 using namespace std;
 
@@ -47,6 +53,64 @@ void CAnimationData::LoadFromIter( nlohmann::json::const_iterator iter )
     NParseHelper::GetValueList( iter, "functions", _functionList );
     NParseHelper::GetValue( iter, "loop", _loopCount );
     NParseHelper::GetEndType( iter, _endType );
+
+    auto trackListIter = iter->find( "tracks" );
+    if( trackListIter != iter->end() )
+    {
+        for( auto trackIter = trackListIter->begin(); trackIter != trackListIter->end(); ++trackIter )
+        {
+            _trackList.emplace_back();
+            _trackList.back().LoadFromIter( trackIter );
+        }
+    }
+
+    UpdateTrackDuration();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Write the animation data to compiled data, in the order Read() reads it.
+/// </summary>
+/// <param name="writer"> Writer of the compiled data. </param>
+/// *************************************************************************
+void CAnimationData::Write( CBinaryWriter & writer ) const
+{
+    writer.Write( _name );
+    writer.Write( _functionList );
+    writer.Write( _loopCount );
+    writer.Write( _endType );
+
+    writer.Write( (uint)_trackList.size() );
+    for( auto & track : _trackList )
+        track.Write( writer );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Read the animation data from compiled data.
+/// </summary>
+/// <param name="reader"> Reader of the compiled data. </param>
+/// *************************************************************************
+void CAnimationData::Read( CBinaryReader & reader )
+{
+    reader.Read( _name );
+    reader.Read( _functionList );
+    reader.Read( _loopCount );
+    reader.Read( _endType );
+
+    // Tracks were added in version 2 of the compiled data.
+    if( reader.GetVersion() >= 2 )
+    {
+        // Each track has at least its field, relative flag and key count.
+        _trackList.resize( reader.ReadCount( sizeof( ETrackField ) + sizeof( bool ) + sizeof( uint ) ) );
+
+        for( auto & track : _trackList )
+            track.Read( reader );
+    }
+
+    UpdateTrackDuration();
 }
 
 
@@ -91,4 +155,41 @@ EEndType CAnimationData::GetEndType() const
 const vector<string> & CAnimationData::GetFunctionList() const
 {
     return _functionList;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Get the list of native tracks.
+/// </summary>
+/// *************************************************************************
+const vector<CAnimationTrack> & CAnimationData::GetTrackList() const
+{
+    return _trackList;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Get the time of the last keyframe of the tracks, which is how long one
+/// loop of them lasts.
+/// </summary>
+/// *************************************************************************
+float CAnimationData::GetTrackDuration() const
+{
+    return _trackDuration;
+}
+
+
+/// *************************************************************************
+/// <summary> 
+/// Find the time of the last keyframe of the tracks.
+/// </summary>
+/// *************************************************************************
+void CAnimationData::UpdateTrackDuration()
+{
+    _trackDuration = 0;
+
+    for( auto & track : _trackList )
+        _trackDuration = max( _trackDuration, track.GetDuration() );
 }
\ No newline at end of file
@@ -5,11 +5,16 @@
 #include <common\defs.h>
 #include <common\bitmask.h>
 #include <utilities\jsonparsehelper.h>
+#include <script\animationtrack.h>
 
 // Standard lib dependencies
 #include <string>
 #include <vector>
 
+// Forward declarations
+class CBinaryWriter;
+class CBinaryReader;
+
 /// *************************************************************************
 /// <summary>
 /// Class containing the default creation data for an animation.
@@ -26,6 +31,12 @@ public:
     // Load the animation data from the passed in iterator.
     void LoadFromIter( nlohmann::json::const_iterator iter );
 
+    // Write the animation data to compiled data.
+    void Write( CBinaryWriter & writer ) const;
+
+    // Read the animation data from compiled data.
+    void Read( CBinaryReader & reader );
+
     // Get the name of the animation.
     const std::string & GetName() const;
 
@@ -38,6 +49,17 @@ public:
     // Get the list of script functions.
     const std::vector<std::string> & GetFunctionList() const;
 
+    // Get the list of native tracks.
+    const std::vector<CAnimationTrack> & GetTrackList() const;
+
+    // Get the time of the last keyframe of the tracks.
+    float GetTrackDuration() const;
+
+private:
+
+    // Find the time of the last keyframe of the tracks.
+    void UpdateTrackDuration();
+
 private:
 
     // The name of the animation.
@@ -51,6 +73,12 @@ private:
 
     // How the animation should end when it is stopped before it finishes.
     NDefs::EEndType _endType = NDefs::EET_NULL;
+
+    // The tracks played natively alongside the script functions.
+    std::vector<CAnimationTrack> _trackList;
+
+    // Time of the last keyframe of the tracks.
+    float _trackDuration = 0;
 };
 
 #endif  // __animation_data_h__
@@ -0,0 +1,259 @@
+// Physical component dependency
+#include "animationtrack.h"
+
+// Game lib dependencies
+#include <common\vector3.h>
+#include <utilities\binarydata.h>
+
+// Standard lib dependencies
+#include <algorithm>
+#include <cmath>
+
+using namespace NDefs;
+using namespace std;
+
+namespace
+{
+    const float PI = 3.14159265358979f;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Constructor
+/// </summary>
+/// *************************************************************************
+CAnimationTrack::CAnimationTrack()
+{
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Load the track from the passed in iterator. Each keyframe holds the
+/// field's value under the same tag sprites and collections use for it.
+/// </summary>
+/// <param name="iter"> JSON node to parse. </param>
+/// *************************************************************************
+void CAnimationTrack::LoadFromIter( nlohmann::json::const_iterator iter )
+{
+    string field;
+    if( NParseHelper::GetValue( iter, "field", field ) )
+        _field = CDefs::Instance().GetTrackField( field );
+
+    NParseHelper::GetValue( iter, "relative", _relative );
+
+    auto keyListIter = iter->find( "keys" );
+    if( keyListIter == iter->end() )
+        return;
+
+    for( auto keyIter = keyListIter->begin(); keyIter != keyListIter->end(); ++keyIter )
+    {
+        CKey key;
+        NParseHelper::GetValue( keyIter, "time", key.time );
+
+        string easing;
+        if( NParseHelper::GetValue( keyIter, "ease", easing ) )
+            key.easing = CDefs::Instance().GetEasing( easing );
+
+        CVector3<float> value;
+
+        if( _field == ETF_POSITION )
+        {
+            NParseHelper::GetXYZ( keyIter, "position", value );
+            key.value = value;
+        }
+        else if( _field == ETF_ROTATION )
+        {
+            NParseHelper::GetXYZ( keyIter, "rotation", value );
+            key.value = value;
+        }
+        else if( _field == ETF_SIZE )
+        {
+            NParseHelper::GetWHD( keyIter, "size", value );
+            key.value = value;
+        }
+        else if( _field == ETF_COLOR )
+        {
+            NParseHelper::GetColor( keyIter, key.value );
+        }
+        else if( _field == ETF_ALPHA )
+        {
+            NParseHelper::GetValue( keyIter, "alpha", key.value.x );
+        }
+        else if( _field == ETF_VISIBLE )
+        {
+            bool visible = true;
+            NParseHelper::GetValue( keyIter, "visible", visible );
+            key.value.x = visible ? 1.f : 0.f;
+        }
+
+        _keyList.push_back( key );
+    }
+
+    stable_sort( _keyList.begin(), _keyList.end(),
+        []( const CKey & a, const CKey & b ) { return a.time < b.time; } );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Write the track to compiled data, in the order Read() reads it.
+/// </summary>
+/// <param name="writer"> Writer of the compiled data. </param>
+/// *************************************************************************
+void CAnimationTrack::Write( CBinaryWriter & writer ) const
+{
+    writer.Write( _field );
+    writer.Write( _relative );
+    writer.Write( (uint)_keyList.size() );
+
+    for( auto & key : _keyList )
+    {
+        writer.Write( key.time );
+        writer.Write( key.value );
+        writer.Write( key.easing );
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Read the track from compiled data.
+/// </summary>
+/// <param name="reader"> Reader of the compiled data. </param>
+/// *************************************************************************
+void CAnimationTrack::Read( CBinaryReader & reader )
+{
+    reader.Read( _field );
+    reader.Read( _relative );
+
+    // Each key is its time, its four part value and its easing.
+    _keyList.resize( reader.ReadCount( sizeof( float ) * 5 + sizeof( EEasing ) ) );
+
+    for( auto & key : _keyList )
+    {
+        reader.Read( key.time );
+        reader.Read( key.value );
+        reader.Read( key.easing );
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the field the track changes.
+/// </summary>
+/// *************************************************************************
+ETrackField CAnimationTrack::GetField() const
+{
+    return _field;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Whether the keyframes are added to the field's value when the animation
+/// started, instead of replacing it.
+/// </summary>
+/// *************************************************************************
+bool CAnimationTrack::IsRelative() const
+{
+    return _relative;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the time of the last keyframe.
+/// </summary>
+/// *************************************************************************
+float CAnimationTrack::GetDuration() const
+{
+    return _keyList.empty() ? 0.f : _keyList.back().time;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the track's value at a time. Before the first keyframe and after the
+/// last, the value holds at that keyframe. Visibility can't be blended, so
+/// it always steps.
+/// </summary>
+/// <param name="time"> Seconds into the animation. </param>
+/// *************************************************************************
+CVector4<float> CAnimationTrack::Evaluate( float time ) const
+{
+    if( _keyList.empty() )
+        return CVector4<float>();
+
+    auto nextIter = upper_bound( _keyList.begin(), _keyList.end(), time,
+        []( float t, const CKey & key ) { return t < key.time; } );
+
+    if( nextIter == _keyList.begin() )
+        return nextIter->value;
+
+    if( nextIter == _keyList.end() )
+        return _keyList.back().value;
+
+    auto & prev = *(nextIter - 1);
+    auto & next = *nextIter;
+
+    EEasing easing = (_field == ETF_VISIBLE) ? EE_STEP : next.easing;
+    float t = Ease( easing, (time - prev.time) / (next.time - prev.time) );
+
+    return prev.value + (next.value - prev.value) * t;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Ease the fraction of the way between two keyframes.
+/// </summary>
+/// <param name="easing"> The easing curve. </param>
+/// <param name="t"> Fraction of the time between the keyframes, from 0 to 1. </param>
+/// <returns> Fraction of the way between the keyframes' values. </returns>
+/// *************************************************************************
+float CAnimationTrack::Ease( EEasing easing, float t )
+{
+    switch( easing )
+    {
+        case EE_STEP:
+            return (t < 1.f) ? 0.f : 1.f;
+
+        case EE_IN_QUAD:
+            return t * t;
+
+        case EE_OUT_QUAD:
+            return t * (2.f - t);
+
+        case EE_IN_OUT_QUAD:
+            return (t < 0.5f) ? (2.f * t * t) : (-1.f + (4.f - 2.f * t) * t);
+
+        case EE_IN_CUBIC:
+            return t * t * t;
+
+        case EE_OUT_CUBIC:
+            t -= 1.f;
+            return t * t * t + 1.f;
+
+        case EE_IN_OUT_CUBIC:
+            if( t < 0.5f )
+                return 4.f * t * t * t;
+
+            t = 2.f * t - 2.f;
+            return 0.5f * t * t * t + 1.f;
+
+        case EE_IN_SINE:
+            return 1.f - cos( t * PI * 0.5f );
+
+        case EE_OUT_SINE:
+            return sin( t * PI * 0.5f );
+
+        case EE_IN_OUT_SINE:
+            return 0.5f * (1.f - cos( t * PI ));
+
+        default:
+            return t;
+    }
+}
\ No newline at end of file
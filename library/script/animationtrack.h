@@ -0,0 +1,86 @@
+#ifndef __animation_track_h__
+#define __animation_track_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+#include <common\vector4.h>
+#include <utilities\jsonparsehelper.h>
+
+// Standard lib dependencies
+#include <vector>
+
+// Forward declarations
+class CBinaryWriter;
+class CBinaryReader;
+
+/// *************************************************************************
+/// <summary>
+/// Class to hold the keyframes of one field of an animation. Tracks are
+/// evaluated natively, so simple effects like fades and slides don't need
+/// a script. Every field's value is kept in a 4d vector: positions,
+/// rotations and sizes use the first three parts, alpha and visibility use
+/// the first.
+/// </summary>
+/// *************************************************************************
+class CAnimationTrack
+{
+public:
+
+    CAnimationTrack();
+
+    // Load the track from the passed in iterator.
+    void LoadFromIter( nlohmann::json::const_iterator iter );
+
+    // Write the track to compiled data.
+    void Write( CBinaryWriter & writer ) const;
+
+    // Read the track from compiled data.
+    void Read( CBinaryReader & reader );
+
+    // Get the field the track changes.
+    NDefs::ETrackField GetField() const;
+
+    // Whether the keyframes are added to the field's value when the animation started.
+    bool IsRelative() const;
+
+    // Get the time of the last keyframe.
+    float GetDuration() const;
+
+    // Get the track's value at a time.
+    CVector4<float> Evaluate( float time ) const;
+
+    // Ease the fraction of the way between two keyframes.
+    static float Ease( NDefs::EEasing easing, float t );
+
+private:
+
+    /// *************************************************************************
+    /// <summary>
+    /// A keyframe of the track.
+    /// </summary>
+    /// *************************************************************************
+    class CKey
+    {
+    public:
+
+        // Seconds into the animation.
+        float time = 0;
+
+        // Value of the field.
+        CVector4<float> value;
+
+        // How the value eases in from the previous keyframe.
+        NDefs::EEasing easing = NDefs::EE_LINEAR;
+    };
+
+    // The field the track changes.
+    NDefs::ETrackField _field = NDefs::ETF_NULL;
+
+    // Whether the keyframes are added to the field's starting value.
+    bool _relative = false;
+
+    // The keyframes, sorted by time.
+    std::vector<CKey> _keyList;
+};
+
+#endif  // __animation_track_h__
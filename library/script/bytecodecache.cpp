@@ -0,0 +1,292 @@
+// Physical component dependency
+#include "bytecodecache.h"
+
+// Game lib dependencies
+#include <utilities\generalfuncs.h>
+
+// Standard lib dependencies
+#include <fstream>
+#include <iterator>
+#include <cstring>
+
+// AngelScript lib dependencies
+#include <angelscript.h>
+
+using namespace std;
+
+namespace
+{
+    // The cache file starts with the magic bytes and the key.
+    const char CACHE_MAGIC[] = { 'A', 'G', 'K', 'B' };
+
+    // FNV-1a constants.
+    const uint64_t HASH_OFFSET = 14695981039346656037ULL;
+    const uint64_t HASH_PRIME = 1099511628211ULL;
+
+    /// *************************************************************************
+    /// <summary>
+    /// Binary stream the engine reads bytecode from and writes it to.
+    /// </summary>
+    /// *************************************************************************
+    class CByteCodeStream : public asIBinaryStream
+    {
+    public:
+
+        CByteCodeStream( string & data, size_t readPos = 0 )
+            : _data(data), _readPos(readPos)
+        {}
+
+        int Read( void * ptr, asUINT size ) override
+        {
+            if( size > _data.size() - _readPos )
+                return -1;
+
+            memcpy( ptr, _data.data() + _readPos, size );
+            _readPos += size;
+
+            return 0;
+        }
+
+        int Write( const void * ptr, asUINT size ) override
+        {
+            _data.append( (const char *)ptr, size );
+
+            return 0;
+        }
+
+    private:
+
+        string & _data;
+        size_t _readPos;
+    };
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Constructor
+/// </summary>
+/// <param name="path"> Path to the cache file. </param>
+/// *************************************************************************
+CByteCodeCache::CByteCodeCache( const std::string & path )
+    : _path(path), _key(HASH_OFFSET)
+{
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Add the engine's version, options and registered interface to the key.
+/// Anything registered differently, like a changed function signature,
+/// would leave the bytecode pointing at the wrong thing.
+/// </summary>
+/// <param name="pEngine"> The script engine. </param>
+/// *************************************************************************
+void CByteCodeCache::AddInterface( const asIScriptEngine * pEngine )
+{
+    AddString( ANGELSCRIPT_VERSION_STRING );
+    AddString( asGetLibraryOptions() );
+    AddValue( sizeof( void * ) );
+
+    for( int property = 1; property < asEP_LAST_PROPERTY; ++property )
+        AddValue( pEngine->GetEngineProperty( (asEEngineProp)property ) );
+
+    for( asUINT i = 0; i < pEngine->GetGlobalFunctionCount(); ++i )
+        AddFunction( pEngine->GetGlobalFunctionByIndex( i ) );
+
+    for( asUINT i = 0; i < pEngine->GetGlobalPropertyCount(); ++i )
+    {
+        const char * pName = nullptr;
+        const char * pNamespace = nullptr;
+        int typeId = 0;
+        bool isConst = false;
+
+        pEngine->GetGlobalPropertyByIndex( i, &pName, &pNamespace, &typeId, &isConst );
+
+        AddString( pNamespace );
+        AddString( pName );
+        AddString( pEngine->GetTypeDeclaration( typeId, true ) );
+        AddValue( isConst );
+    }
+
+    for( asUINT i = 0; i < pEngine->GetObjectTypeCount(); ++i )
+        AddType( pEngine->GetObjectTypeByIndex( i ) );
+
+    for( asUINT i = 0; i < pEngine->GetEnumCount(); ++i )
+    {
+        const asITypeInfo * pType = pEngine->GetEnumByIndex( i );
+
+        AddString( pType->GetNamespace() );
+        AddString( pType->GetName() );
+
+        for( asUINT j = 0; j < pType->GetEnumValueCount(); ++j )
+        {
+            int value = 0;
+            AddString( pType->GetEnumValueByIndex( j, &value ) );
+            AddValue( value );
+        }
+    }
+
+    for( asUINT i = 0; i < pEngine->GetFuncdefCount(); ++i )
+        AddFunction( pEngine->GetFuncdefByIndex( i )->GetFuncdefSignature() );
+
+    for( asUINT i = 0; i < pEngine->GetTypedefCount(); ++i )
+    {
+        const asITypeInfo * pType = pEngine->GetTypedefByIndex( i );
+
+        AddString( pType->GetNamespace() );
+        AddString( pType->GetName() );
+        AddString( pEngine->GetTypeDeclaration( pType->GetTypedefTypeId(), true ) );
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Add a script section to the key.
+/// </summary>
+/// <param name="name"> Name of the section. </param>
+/// <param name="code"> The section's script. </param>
+/// *************************************************************************
+void CByteCodeCache::AddSection( const std::string & name, const std::string & code )
+{
+    AddString( name.c_str() );
+    AddValue( code.size() );
+    AddBytes( code.data(), code.size() );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Load the module from the cache file if its key matches. If the bytecode
+/// can't be loaded the engine leaves the module empty, so the scripts can
+/// still be added and built as usual.
+/// </summary>
+/// <param name="pModule"> Module to load the bytecode into. </param>
+/// <returns> False if the scripts need to be built. </returns>
+/// *************************************************************************
+bool CByteCodeCache::Load( asIScriptModule * pModule ) const
+{
+    ifstream file( _path, ios::binary );
+    if( !file )
+        return false;
+
+    string data( (istreambuf_iterator<char>( file )), istreambuf_iterator<char>() );
+
+    const size_t headerSize = sizeof( CACHE_MAGIC ) + sizeof( _key );
+    if( (data.size() < headerSize) || (memcmp( data.data(), CACHE_MAGIC, sizeof( CACHE_MAGIC ) ) != 0) )
+        return false;
+
+    uint64_t key;
+    memcpy( &key, data.data() + sizeof( CACHE_MAGIC ), sizeof( key ) );
+    if( key != _key )
+        return false;
+
+    CByteCodeStream stream( data, headerSize );
+    if( pModule->LoadByteCode( &stream ) < 0 )
+    {
+        NGeneralFuncs::PostDebugMsg( "Script bytecode cache '" + _path + "' could not be loaded. Building the scripts." );
+        return false;
+    }
+
+    return true;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Save the built module to the cache file. A cache that can't be written
+/// only means the scripts are built again next time.
+/// </summary>
+/// <param name="pModule"> The built module. </param>
+/// *************************************************************************
+void CByteCodeCache::Save( const asIScriptModule * pModule ) const
+{
+    string data( CACHE_MAGIC, sizeof( CACHE_MAGIC ) );
+    data.append( (const char *)&_key, sizeof( _key ) );
+
+    CByteCodeStream stream( data );
+    if( pModule->SaveByteCode( &stream ) < 0 )
+        return;
+
+    ofstream file( _path, ios::binary | ios::trunc );
+    file.write( data.data(), data.size() );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Add a registered function to the key.
+/// </summary>
+/// *************************************************************************
+void CByteCodeCache::AddFunction( const asIScriptFunction * pFunction )
+{
+    if( pFunction )
+        AddString( pFunction->GetDeclaration( true, true, true ) );
+    else
+        AddString( nullptr );
+}
+
+/// <summary>
+/// Add a registered type, with its members, to the key.
+/// </summary>
+void CByteCodeCache::AddType( const asITypeInfo * pType )
+{
+    AddString( pType->GetNamespace() );
+    AddString( pType->GetName() );
+    AddValue( pType->GetFlags() );
+    AddValue( pType->GetSize() );
+
+    for( asUINT i = 0; i < pType->GetFactoryCount(); ++i )
+        AddFunction( pType->GetFactoryByIndex( i ) );
+
+    for( asUINT i = 0; i < pType->GetBehaviourCount(); ++i )
+    {
+        asEBehaviours behaviour;
+        AddFunction( pType->GetBehaviourByIndex( i, &behaviour ) );
+        AddValue( behaviour );
+    }
+
+    for( asUINT i = 0; i < pType->GetMethodCount(); ++i )
+        AddFunction( pType->GetMethodByIndex( i ) );
+
+    for( asUINT i = 0; i < pType->GetPropertyCount(); ++i )
+        AddString( pType->GetPropertyDeclaration( i, true ) );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Add a string to the key. The length goes in first, so neighbouring
+/// strings can't run together into the same hash.
+/// </summary>
+/// *************************************************************************
+void CByteCodeCache::AddString( const char * pStr )
+{
+    size_t length = pStr ? strlen( pStr ) : 0;
+
+    AddValue( length );
+    AddBytes( pStr, length );
+}
+
+/// <summary>
+/// Add a number to the key.
+/// </summary>
+void CByteCodeCache::AddValue( uint64_t value )
+{
+    AddBytes( &value, sizeof( value ) );
+}
+
+/// <summary>
+/// Add raw bytes to the key.
+/// </summary>
+void CByteCodeCache::AddBytes( const void * pData, size_t size )
+{
+    const unsigned char * pByte = static_cast<const unsigned char *>( pData );
+
+    for( size_t i = 0; i < size; ++i )
+    {
+        _key ^= pByte[i];
+        _key *= HASH_PRIME;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef __byte_code_cache_h__
+#define __byte_code_cache_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+
+// Standard lib dependencies
+#include <string>
+#include <cstdint>
+
+// Forward declaration(s)
+class asIScriptEngine;
+class asIScriptModule;
+class asIScriptFunction;
+class asITypeInfo;
+
+/// *************************************************************************
+/// <summary>
+/// Class to keep a module's compiled bytecode in a file between runs. The
+/// file is keyed by a hash of the engine version and options, everything
+/// the application registered with the engine, and the script sections in
+/// the order they're added. If any of them change, the key won't match and
+/// the scripts are compiled again.
+/// </summary>
+/// *************************************************************************
+class CByteCodeCache
+{
+public:
+
+    // Constructor
+    CByteCodeCache( const std::string & path );
+
+    // Add the engine's version, options and registered interface to the key.
+    void AddInterface( const asIScriptEngine * pEngine );
+
+    // Add a script section to the key.
+    void AddSection( const std::string & name, const std::string & code );
+
+    // Load the module from the cache file if its key matches.
+    bool Load( asIScriptModule * pModule ) const;
+
+    // Save the built module to the cache file.
+    void Save( const asIScriptModule * pModule ) const;
+
+private:
+
+    // Add a registered function or type to the key.
+    void AddFunction( const asIScriptFunction * pFunction );
+    void AddType( const asITypeInfo * pType );
+
+    // Add data to the key.
+    void AddString( const char * pStr );
+    void AddValue( uint64_t value );
+    void AddBytes( const void * pData, size_t size );
+
+private:
+
+    // Path to the cache file.
+    std::string _path;
+
+    // Hash of everything the bytecode was built from.
+    uint64_t _key;
+};
+
+#endif  // __byte_code_cache_h__
\ No newline at end of file
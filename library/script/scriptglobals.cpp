@@ -5,6 +5,8 @@
 #include <agk.h>
 #include <utilities/generalfuncs.h>
 #include <utilities/exceptionhandling.h>
+#include <managers/scriptmanager.h>
+#include <managers/spritemanager.h>
 
 // Boost lib dependencies
 #include <boost\format.hpp>
@@ -43,6 +45,70 @@ namespace NScriptGlobals
     }
 
 
+    /// *************************************************************************
+    /// <summary> 
+    /// Suspend the script for a number of seconds.
+    /// </summary>
+    /// *************************************************************************
+    void Wait( float seconds )
+    {
+        asIScriptContext *ctx = asGetActiveContext();
+
+        if( ctx )
+            CScriptManager::Instance().GetScheduler().Wait( ctx, seconds );
+    }
+
+
+    /// *************************************************************************
+    /// <summary> 
+    /// Suspend the script for a number of frames.
+    /// </summary>
+    /// *************************************************************************
+    void WaitFrames( int frames )
+    {
+        asIScriptContext *ctx = asGetActiveContext();
+
+        if( ctx )
+            CScriptManager::Instance().GetScheduler().WaitFrames( ctx, frames );
+    }
+
+
+    /// *************************************************************************
+    /// <summary> 
+    /// Suspend the script until the signal is sent.
+    /// </summary>
+    /// *************************************************************************
+    void WaitUntil( const std::string & signal )
+    {
+        asIScriptContext *ctx = asGetActiveContext();
+
+        if( ctx )
+            CScriptManager::Instance().GetScheduler().WaitUntil( ctx, signal );
+    }
+
+
+    /// *************************************************************************
+    /// <summary> 
+    /// Wake the scripts waiting for the signal.
+    /// </summary>
+    /// *************************************************************************
+    void Signal( const std::string & signal )
+    {
+        CScriptManager::Instance().GetScheduler().Signal( signal );
+    }
+
+
+    /// *************************************************************************
+    /// <summary> 
+    /// Whether the handle still refers to an object in the sprite manager.
+    /// </summary>
+    /// *************************************************************************
+    bool IsObjectValid( uint handle )
+    {
+        return CSpriteManager::Instance().GetObjectFromHandle( handle ) != nullptr;
+    }
+
+
     /// *************************************************************************
     /// <summary> 
     /// Register the global functions.
@@ -54,6 +120,11 @@ namespace NScriptGlobals
         Throw( pEngine->RegisterGlobalFunction( "float GetElapsedTime()", asFUNCTION( agk::GetFrameTime ), asCALL_CDECL ) );
         Throw( pEngine->RegisterGlobalFunction( "void Print(string &in)", asFUNCTION( NGeneralFuncs::PostDebugMsg ), asCALL_CDECL ) );
         Throw( pEngine->RegisterGlobalFunction( "void Suspend()", asFUNCTION( Suspend ), asCALL_CDECL ) );
+        Throw( pEngine->RegisterGlobalFunction( "void Wait(float seconds)", asFUNCTION( Wait ), asCALL_CDECL ) );
+        Throw( pEngine->RegisterGlobalFunction( "void WaitFrames(int frames)", asFUNCTION( WaitFrames ), asCALL_CDECL ) );
+        Throw( pEngine->RegisterGlobalFunction( "void WaitUntil(string &in)", asFUNCTION( WaitUntil ), asCALL_CDECL ) );
+        Throw( pEngine->RegisterGlobalFunction( "void Signal(string &in)", asFUNCTION( Signal ), asCALL_CDECL ) );
+        Throw( pEngine->RegisterGlobalFunction( "bool IsObjectValid(uint handle)", asFUNCTION( IsObjectValid ), asCALL_CDECL ) );
     }
 
 }
@@ -0,0 +1,300 @@
+// Physical component dependency
+#include "scriptscheduler.h"
+
+// Standard lib dependencies
+#include <cmath>
+#include <algorithm>
+
+// AngelScript lib dependencies
+#include <angelscript.h>
+
+using namespace std;
+
+namespace
+{
+    // Key of the wait in the context's user data.
+    const asPWORD WAIT_USER_DATA = 0x57414954;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Constructor
+/// </summary>
+/// *************************************************************************
+CScriptScheduler::CScriptScheduler()
+{
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Destructor
+/// </summary>
+/// *************************************************************************
+CScriptScheduler::~CScriptScheduler()
+{
+    Clear();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Advance the clocks a frame and wake the contexts that are due. They're
+/// handed back to their owners and resumed the next time they're executed.
+/// </summary>
+/// <param name="elapsedTime"> Seconds since the last frame. </param>
+/// *************************************************************************
+void CScriptScheduler::Update( float elapsedTime )
+{
+    _frameWheel.Advance( 1, _pDueList );
+
+    _timeRemainder += elapsedTime * 1000.f;
+    uint64_t ticks = (uint64_t)_timeRemainder;
+    _timeRemainder -= (float)ticks;
+
+    _timeWheel.Advance( ticks, _pDueList );
+
+    WakeDue();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Suspend the context for a number of seconds.
+/// </summary>
+/// <param name="pContext"> The context to suspend. </param>
+/// <param name="seconds"> Time to wait. Anything under a millisecond waits
+/// until the next frame. </param>
+/// *************************************************************************
+void CScriptScheduler::Wait( asIScriptContext * pContext, float seconds )
+{
+    CWait & wait = GetWait( pContext );
+    Sleep( wait, pContext );
+
+    wait.pWheel = &_timeWheel;
+    _timeWheel.Schedule( wait, (uint64_t)ceil( max( seconds, 0.f ) * 1000.f ) );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Suspend the context for a number of frames.
+/// </summary>
+/// <param name="pContext"> The context to suspend. </param>
+/// <param name="frames"> Frames to wait. At least one. </param>
+/// *************************************************************************
+void CScriptScheduler::WaitFrames( asIScriptContext * pContext, int frames )
+{
+    CWait & wait = GetWait( pContext );
+    Sleep( wait, pContext );
+
+    wait.pWheel = &_frameWheel;
+    _frameWheel.Schedule( wait, (uint64_t)max( frames, 1 ) );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Suspend the context until the signal is sent.
+/// </summary>
+/// <param name="pContext"> The context to suspend. </param>
+/// <param name="signal"> Name of the signal. </param>
+/// *************************************************************************
+void CScriptScheduler::WaitUntil( asIScriptContext * pContext, const string & signal )
+{
+    CWait & wait = GetWait( pContext );
+    Sleep( wait, pContext );
+
+    wait.pSignal = &*_signalList.emplace( signal, vector<CWait *>() ).first;
+    wait.pSignal->second.push_back( &wait );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Wake the contexts waiting for the signal. Nothing happens if none are.
+/// </summary>
+/// <param name="signal"> Name of the signal. </param>
+/// *************************************************************************
+void CScriptScheduler::Signal( const string & signal )
+{
+    auto iter = _signalList.find( signal );
+    if( iter == _signalList.end() )
+        return;
+
+    // Take the list first, since it can change while the wake callbacks run.
+    vector<CWait *> pWaitList;
+    pWaitList.swap( iter->second );
+    _signalList.erase( iter );
+
+    for( auto pWait : pWaitList )
+    {
+        pWait->pSignal = nullptr;
+        Wake( *pWait );
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Set the function to call when the context wakes up. It's called from
+/// Update() or Signal(), so it should only hand the context back to its
+/// owner rather than execute it. The callback is kept until the context
+/// is cancelled.
+/// </summary>
+/// <param name="pContext"> The context to watch. </param>
+/// <param name="callback"> Function to call with the context. </param>
+/// *************************************************************************
+void CScriptScheduler::SetWakeCallback( asIScriptContext * pContext, const TWakeCallback & callback )
+{
+    GetWait( pContext ).wakeCallback = callback;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Whether the context is asleep.
+/// </summary>
+/// *************************************************************************
+bool CScriptScheduler::IsWaiting( asIScriptContext * pContext ) const
+{
+    CWait * pWait = static_cast<CWait *>( pContext->GetUserData( WAIT_USER_DATA ) );
+
+    return pWait && pWait->waiting;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Stop the context from waiting, like when it's aborted. Its wake
+/// callback is forgotten too, since the context is going back to the pool.
+/// </summary>
+/// *************************************************************************
+void CScriptScheduler::Cancel( asIScriptContext * pContext )
+{
+    CWait * pWait = static_cast<CWait *>( pContext->GetUserData( WAIT_USER_DATA ) );
+
+    if( pWait )
+    {
+        Cancel( *pWait );
+        pWait->wakeCallback = nullptr;
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Stop all of the contexts from waiting and forget their waits, like when
+/// the contexts are about to be released. Must be called while the contexts
+/// still exist, since their user data is cleared so none of them point at a
+/// freed wait.
+/// </summary>
+/// *************************************************************************
+void CScriptScheduler::Clear()
+{
+    for( auto & pWait : _pWaitList )
+    {
+        Cancel( *pWait );
+        pWait->pContext->SetUserData( nullptr, WAIT_USER_DATA );
+    }
+
+    _pWaitList.clear();
+    _signalList.clear();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the context's wait, creating it the first time. The waits belong to
+/// the scheduler rather than the context, so a context released by the
+/// engine can't leave a freed timer on a wheel.
+/// </summary>
+/// *************************************************************************
+CScriptScheduler::CWait & CScriptScheduler::GetWait( asIScriptContext * pContext )
+{
+    CWait * pWait = static_cast<CWait *>( pContext->GetUserData( WAIT_USER_DATA ) );
+
+    if( !pWait )
+    {
+        _pWaitList.emplace_back( new CWait() );
+        pWait = _pWaitList.back().get();
+        pWait->pContext = pContext;
+
+        pContext->SetUserData( pWait, WAIT_USER_DATA );
+    }
+
+    return *pWait;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Stop anything the context was already waiting on and suspend it.
+/// </summary>
+/// *************************************************************************
+void CScriptScheduler::Sleep( CWait & wait, asIScriptContext * pContext )
+{
+    Cancel( wait );
+
+    wait.waiting = true;
+    pContext->Suspend();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Take the wait off whatever it's waiting on.
+/// </summary>
+/// *************************************************************************
+void CScriptScheduler::Cancel( CWait & wait )
+{
+    if( wait.pWheel )
+        wait.pWheel->Cancel( wait );
+
+    if( wait.pSignal )
+    {
+        auto & pSignalList = wait.pSignal->second;
+        pSignalList.erase( find( pSignalList.begin(), pSignalList.end(), &wait ) );
+
+        if( pSignalList.empty() )
+            _signalList.erase( _signalList.find( wait.pSignal->first ) );
+    }
+
+    wait.waiting = false;
+    wait.pWheel = nullptr;
+    wait.pSignal = nullptr;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Wake the context up and let its owner know. The wait must already be
+/// off whatever it was waiting on.
+/// </summary>
+/// *************************************************************************
+void CScriptScheduler::Wake( CWait & wait )
+{
+    wait.waiting = false;
+
+    if( wait.wakeCallback )
+        wait.wakeCallback( wait.pContext );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Wake the contexts of the timers that came due.
+/// </summary>
+/// *************************************************************************
+void CScriptScheduler::WakeDue()
+{
+    for( auto pTimer : _pDueList )
+    {
+        CWait * pWait = static_cast<CWait *>( pTimer );
+        pWait->pWheel = nullptr;
+        Wake( *pWait );
+    }
+
+    _pDueList.clear();
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#ifndef __script_scheduler_h__
+#define __script_scheduler_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+#include <utilities\timerwheel.h>
+
+// Standard lib dependencies
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
+
+// Forward declaration(s)
+class asIScriptContext;
+
+/// *************************************************************************
+/// <summary>
+/// Class to keep suspended script contexts asleep until they're due. A
+/// context can wait a number of seconds or frames, which go on timer
+/// wheels, or until a named signal is sent. Whoever executes a context can
+/// give it a wake callback and set it aside while it sleeps, so a sleeping
+/// script costs nothing until the callback hands it back.
+/// </summary>
+/// *************************************************************************
+class CScriptScheduler
+{
+public:
+
+    // Called when a waiting context wakes up.
+    typedef std::function<void( asIScriptContext * pContext )> TWakeCallback;
+
+    // Constructor
+    CScriptScheduler();
+
+    // Destructor
+    ~CScriptScheduler();
+
+    // Advance the clocks a frame and wake the contexts that are due.
+    void Update( float elapsedTime );
+
+    // Suspend the context for a number of seconds.
+    void Wait( asIScriptContext * pContext, float seconds );
+
+    // Suspend the context for a number of frames.
+    void WaitFrames( asIScriptContext * pContext, int frames );
+
+    // Suspend the context until the signal is sent.
+    void WaitUntil( asIScriptContext * pContext, const std::string & signal );
+
+    // Wake the contexts waiting for the signal.
+    void Signal( const std::string & signal );
+
+    // Set the function to call when the context wakes up.
+    void SetWakeCallback( asIScriptContext * pContext, const TWakeCallback & callback );
+
+    // Whether the context is asleep.
+    bool IsWaiting( asIScriptContext * pContext ) const;
+
+    // Stop the context from waiting and forget its wake callback.
+    void Cancel( asIScriptContext * pContext );
+
+    // Stop all of the contexts from waiting and forget their waits.
+    void Clear();
+
+private:
+
+    class CWait;
+
+    // Contexts waiting for each signal, by the name of the signal.
+    typedef std::map<const std::string, std::vector<CWait *>> TSignalMap;
+
+    /// *************************************************************************
+    /// <summary>
+    /// What a context is waiting on. Each context that waits gets one, kept
+    /// in the context's user data and reused every time it waits.
+    /// </summary>
+    /// *************************************************************************
+    class CWait : public CTimerWheel::CTimer
+    {
+    public:
+
+        // Whether the context is asleep.
+        bool waiting = false;
+
+        // The wheel the timer is on, if the context is waiting on one.
+        CTimerWheel * pWheel = nullptr;
+
+        // The signal the context is waiting for and its list, if it is.
+        TSignalMap::value_type * pSignal = nullptr;
+
+        // The context the wait belongs to.
+        asIScriptContext * pContext = nullptr;
+
+        // Function to call when the context wakes up.
+        TWakeCallback wakeCallback;
+    };
+
+    // Get the context's wait, creating it the first time.
+    CWait & GetWait( asIScriptContext * pContext );
+
+    // Stop the wait and put the context to sleep.
+    void Sleep( CWait & wait, asIScriptContext * pContext );
+
+    // Take the wait off whatever it's waiting on.
+    void Cancel( CWait & wait );
+
+    // Wake the context up and let its owner know.
+    void Wake( CWait & wait );
+
+    // Wake the contexts of the timers that came due.
+    void WakeDue();
+
+private:
+
+    // Clock in frames.
+    CTimerWheel _frameWheel;
+
+    // Clock in milliseconds.
+    CTimerWheel _timeWheel;
+
+    // Fraction of a millisecond the time wheel hasn't advanced yet.
+    float _timeRemainder = 0.f;
+
+    // Contexts waiting for each signal. Signals no context waits for are removed.
+    TSignalMap _signalList;
+
+    // Every wait that's been created.
+    std::vector<std::unique_ptr<CWait>> _pWaitList;
+
+    // Timers that came due this frame. Kept to reuse its memory.
+    std::vector<CTimerWheel::CTimer *> _pDueList;
+};
+
+#endif  // __script_scheduler_h__
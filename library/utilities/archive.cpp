@@ -0,0 +1,505 @@
+#if defined(_WINDOWS)
+#define STRICT
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define ARCHIVE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Physical component dependency
+#include "archive.h"
+
+// Game lib dependencies
+#include <agk.h>
+#include <utilities\exceptionhandling.h>
+
+// Standard lib dependencies
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace
+{
+    // The archive starts with the magic bytes, the version, the file count and
+    // a reserved field. It's followed by the table of contents, sorted by path,
+    // where each entry is the offset and length of the path and the offset and
+    // size of the data. Then come the paths and the data. All values are 32 bit
+    // little endian, measured from the start of the archive.
+    const char ARCHIVE_MAGIC[] = { 'A', 'G', 'K', 'A' };
+    const uint ARCHIVE_VERSION = 1;
+    const uint HEADER_SIZE = 16;
+    const uint ENTRY_SIZE = 16;
+
+    // The data of each file starts on this boundary.
+    const uint DATA_ALIGNMENT = 16;
+
+    // Extensions of the files the managers read through the archive. Images,
+    // meshes and fonts are loaded by AGK from a path, so they stay in folders.
+    const char * PACKED_EXTENSION_LIST[] = { "json", "bin", "as" };
+
+    /// *************************************************************************
+    /// <summary>
+    /// Read a value out of the archive.
+    /// </summary>
+    /// *************************************************************************
+    inline uint ReadUint( const char * pData )
+    {
+        uint value;
+        memcpy( &value, pData, sizeof( value ) );
+        return value;
+    }
+
+    /// *************************************************************************
+    /// <summary>
+    /// Write a value to the archive.
+    /// </summary>
+    /// *************************************************************************
+    inline void WriteUint( ofstream & file, uint value )
+    {
+        file.write( (const char *)&value, sizeof( value ) );
+    }
+
+    /// *************************************************************************
+    /// <summary>
+    /// Use forward slashes and end the folder path with one, the way the paths
+    /// are stored in the archive.
+    /// </summary>
+    /// *************************************************************************
+    string GetFolderPath( const string & folderPath )
+    {
+        string path( folderPath );
+        replace( path.begin(), path.end(), '\\', '/' );
+
+        if( !path.empty() && (path.back() != '/') )
+            path += '/';
+
+        return path;
+    }
+
+    /// *************************************************************************
+    /// <summary>
+    /// Whether the file is one the managers read through the archive.
+    /// </summary>
+    /// *************************************************************************
+    bool IsPackedFile( const string & file )
+    {
+        size_t pos = file.rfind( '.' );
+        if( pos == string::npos )
+            return false;
+
+        string ext = file.substr( pos + 1 );
+        for( auto pExt : PACKED_EXTENSION_LIST )
+            if( ext == pExt )
+                return true;
+
+        return false;
+    }
+
+    /// *************************************************************************
+    /// <summary>
+    /// Add the paths of the data files in the folder and its sub folders to
+    /// the list.
+    /// </summary>
+    /// <param name="folderPath"> Path to the folder, ending with a slash. </param>
+    /// <param name="pathList"> List to add the paths to. </param>
+    /// *************************************************************************
+    void GetPackedFiles( const string & folderPath, vector<string> & pathList )
+    {
+        agk::SetFolder( "" );
+        agk::SetFolder( folderPath.c_str() );
+
+        string file = agk::GetFirstFile();
+        while( !file.empty() )
+        {
+            if( IsPackedFile( file ) )
+                pathList.push_back( folderPath + file );
+
+            file = agk::GetNextFile();
+        }
+
+        // Gather the sub folders before going into them, since that changes the current folder.
+        vector<string> folderList;
+        string folder = agk::GetFirstFolder();
+        while( !folder.empty() )
+        {
+            folderList.push_back( folderPath + folder + "/" );
+            folder = agk::GetNextFolder();
+        }
+
+        for( auto & subFolderPath : folderList )
+            GetPackedFiles( subFolderPath, pathList );
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Constructor
+/// </summary>
+/// *************************************************************************
+CArchive::CArchive()
+{
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Destructor
+/// </summary>
+/// *************************************************************************
+CArchive::~CArchive()
+{
+    Close();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Pack the data files in the folder and its sub folders into an archive.
+/// Meant to be run as a build step. The paths are stored the way the game
+/// loads them, so the folder path should be the one the game uses.
+/// </summary>
+/// <param name="folderPath"> Path to the data folder. </param>
+/// <param name="archivePath"> Path of the archive to write. </param>
+/// <returns> Number of files packed. </returns>
+/// *************************************************************************
+uint CArchive::Pack( const std::string & folderPath, const std::string & archivePath )
+{
+    vector<string> pathList;
+
+    try
+    {
+        GetPackedFiles( GetFolderPath( folderPath ), pathList );
+        agk::SetFolder( "" );
+
+        sort( pathList.begin(), pathList.end() );
+
+        // Read the files in and lay out the archive.
+        vector<string> dataList( pathList.size() );
+        uint nameOffset = HEADER_SIZE + ENTRY_SIZE * (uint)pathList.size();
+        uint dataOffset = nameOffset;
+
+        for( size_t i = 0; i < pathList.size(); ++i )
+        {
+            ifstream file( pathList[i], ios::binary );
+            if( !file )
+                throw NExcept::CCriticalException( "Error",
+                                                   "CArchive::Pack()",
+                                                   "Failed to read file '" + pathList[i] + "'." );
+
+            dataList[i].assign( istreambuf_iterator<char>( file ), istreambuf_iterator<char>() );
+            dataOffset += (uint)pathList[i].size();
+        }
+
+        dataOffset = (dataOffset + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
+
+        ofstream archive( archivePath, ios::binary | ios::trunc );
+        if( !archive )
+            throw NExcept::CCriticalException( "Error",
+                                               "CArchive::Pack()",
+                                               "Failed to create archive '" + archivePath + "'." );
+
+        archive.write( ARCHIVE_MAGIC, sizeof( ARCHIVE_MAGIC ) );
+        WriteUint( archive, ARCHIVE_VERSION );
+        WriteUint( archive, (uint)pathList.size() );
+        WriteUint( archive, 0 );
+
+        // Write the table of contents.
+        for( size_t i = 0; i < pathList.size(); ++i )
+        {
+            WriteUint( archive, nameOffset );
+            WriteUint( archive, (uint)pathList[i].size() );
+            WriteUint( archive, dataOffset );
+            WriteUint( archive, (uint)dataList[i].size() );
+
+            nameOffset += (uint)pathList[i].size();
+            dataOffset = (dataOffset + (uint)dataList[i].size() + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
+        }
+
+        for( auto & path : pathList )
+            archive.write( path.data(), path.size() );
+
+        // Write the data, padding each file out to the alignment.
+        const char padding[DATA_ALIGNMENT] = {};
+
+        for( auto & data : dataList )
+        {
+            archive.write( padding, (DATA_ALIGNMENT - (uint)archive.tellp() % DATA_ALIGNMENT) % DATA_ALIGNMENT );
+            archive.write( data.data(), data.size() );
+        }
+
+        if( !archive )
+            throw NExcept::CCriticalException( "Error",
+                                               "CArchive::Pack()",
+                                               "Failed to write archive '" + archivePath + "'." );
+    }
+    catch( exception e )
+    {
+        throw NExcept::CCriticalException( "Error",
+                                           "CArchive::Pack()",
+                                           "Failed to pack '" + folderPath + "'.", e );
+    }
+
+    return (uint)pathList.size();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Map the archive. Where it can't be mapped, it's read into memory instead.
+/// </summary>
+/// <param name="archivePath"> Path to the archive. </param>
+/// <returns> False if the archive doesn't exist. </returns>
+/// *************************************************************************
+bool CArchive::Open( const std::string & archivePath )
+{
+    Close();
+
+#if defined(_WINDOWS)
+    HANDLE hFile = CreateFileA( archivePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+    if( hFile != INVALID_HANDLE_VALUE )
+    {
+        LARGE_INTEGER size;
+        if( GetFileSizeEx( hFile, &size ) && (size.QuadPart > 0) )
+        {
+            // The view keeps the mapping open, so the handles can be closed right away.
+            HANDLE hMapping = CreateFileMappingA( hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+            if( hMapping )
+            {
+                _pData = (const char *)MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+                _size = _pData ? (size_t)size.QuadPart : 0;
+                CloseHandle( hMapping );
+            }
+        }
+
+        CloseHandle( hFile );
+    }
+#elif defined(ARCHIVE_MMAP)
+    int fileId = open( archivePath.c_str(), O_RDONLY );
+    if( fileId >= 0 )
+    {
+        struct stat info;
+        if( (fstat( fileId, &info ) == 0) && (info.st_size > 0) )
+        {
+            void * pData = mmap( nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fileId, 0 );
+            if( pData != MAP_FAILED )
+            {
+                _pData = (const char *)pData;
+                _size = (size_t)info.st_size;
+            }
+        }
+
+        close( fileId );
+    }
+#endif
+
+    // Read the archive in if it couldn't be mapped.
+    if( !_pData )
+    {
+        ifstream file( archivePath, ios::binary );
+        if( !file )
+            return false;
+
+        _buffer.assign( istreambuf_iterator<char>( file ), istreambuf_iterator<char>() );
+        _pData = _buffer.data();
+        _size = _buffer.size();
+    }
+
+    // Check the header and that the table of contents points inside the archive.
+    bool valid = (_size >= HEADER_SIZE) &&
+                 (memcmp( _pData, ARCHIVE_MAGIC, sizeof( ARCHIVE_MAGIC ) ) == 0) &&
+                 (ReadUint( _pData + 4 ) == ARCHIVE_VERSION);
+
+    if( valid )
+    {
+        _fileCount = ReadUint( _pData + 8 );
+        valid = (_size - HEADER_SIZE) / ENTRY_SIZE >= _fileCount;
+
+        for( uint i = 0; valid && (i < _fileCount); ++i )
+        {
+            const char * pEntry = _pData + HEADER_SIZE + i * ENTRY_SIZE;
+
+            valid = ((size_t)ReadUint( pEntry ) + ReadUint( pEntry + 4 ) <= _size) &&
+                    ((size_t)ReadUint( pEntry + 8 ) + ReadUint( pEntry + 12 ) <= _size);
+        }
+    }
+
+    if( !valid )
+    {
+        Close();
+
+        throw NExcept::CCriticalException( "Error",
+                                           "CArchive::Open()",
+                                           "Archive '" + archivePath + "' is not valid." );
+    }
+
+    return true;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Unmap the archive. Any slices taken from it become invalid.
+/// </summary>
+/// *************************************************************************
+void CArchive::Close()
+{
+    // Only unmap if the archive wasn't read into the buffer.
+    if( _pData && _buffer.empty() )
+    {
+#if defined(_WINDOWS)
+        UnmapViewOfFile( _pData );
+#elif defined(ARCHIVE_MMAP)
+        munmap( (void *)_pData, _size );
+#endif
+    }
+
+    _buffer.clear();
+    _buffer.shrink_to_fit();
+
+    _pData = nullptr;
+    _size = 0;
+    _fileCount = 0;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Whether an archive is open.
+/// </summary>
+/// *************************************************************************
+bool CArchive::IsOpen() const
+{
+    return _pData != nullptr;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Find a file in the archive.
+/// </summary>
+/// <param name="filePath"> Path the file was packed with. </param>
+/// <param name="slice"> Set to the file's data. </param>
+/// <returns> False if the file isn't in the archive. </returns>
+/// *************************************************************************
+bool CArchive::Find( const std::string & filePath, CArchiveSlice & slice ) const
+{
+    string path( filePath );
+    replace( path.begin(), path.end(), '\\', '/' );
+
+    uint index = LowerBound( path );
+    if( index == _fileCount )
+        return false;
+
+    uint length;
+    const char * pPath = GetEntryPath( index, length );
+    if( (length != path.size()) || (memcmp( pPath, path.data(), length ) != 0) )
+        return false;
+
+    const char * pEntry = _pData + HEADER_SIZE + index * ENTRY_SIZE;
+    slice.pData = _pData + ReadUint( pEntry + 8 );
+    slice.size = ReadUint( pEntry + 12 );
+
+    return true;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the paths of the files directly in the folder, not in its sub
+/// folders. The paths are sorted, so they're all next to each other.
+/// </summary>
+/// <param name="folderPath"> Path to the folder. </param>
+/// <param name="pathList"> List to add the file paths to. </param>
+/// <returns> False if the folder has no files in the archive. </returns>
+/// *************************************************************************
+bool CArchive::GetFileList( const std::string & folderPath, std::vector<std::string> & pathList ) const
+{
+    string folder = GetFolderPath( folderPath );
+    size_t startSize = pathList.size();
+
+    for( uint i = LowerBound( folder ); i < _fileCount; ++i )
+    {
+        uint length;
+        const char * pPath = GetEntryPath( i, length );
+
+        if( (length < folder.size()) || (memcmp( pPath, folder.data(), folder.size() ) != 0) )
+            break;
+
+        const char * pEnd = pPath + length;
+
+        if( find( pPath + folder.size(), pEnd, '/' ) == pEnd )
+            pathList.emplace_back( pPath, pEnd );
+    }
+
+    return pathList.size() > startSize;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the number of files in the archive.
+/// </summary>
+/// *************************************************************************
+uint CArchive::GetFileCount() const
+{
+    return _fileCount;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the path of the entry in the table of contents.
+/// </summary>
+/// <param name="index"> Index of the entry. </param>
+/// <param name="length"> Set to the length of the path. </param>
+/// *************************************************************************
+const char * CArchive::GetEntryPath( uint index, uint & length ) const
+{
+    const char * pEntry = _pData + HEADER_SIZE + index * ENTRY_SIZE;
+    length = ReadUint( pEntry + 4 );
+
+    return _pData + ReadUint( pEntry );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Binary search the table of contents for the first entry whose path isn't
+/// less than the passed in path.
+/// </summary>
+/// <param name="path"> Path to search for. </param>
+/// <returns> Index of the entry, or the file count if there isn't one. </returns>
+/// *************************************************************************
+uint CArchive::LowerBound( const std::string & path ) const
+{
+    uint first = 0;
+    uint count = _fileCount;
+
+    while( count > 0 )
+    {
+        uint step = count / 2;
+        uint index = first + step;
+
+        uint length;
+        const char * pPath = GetEntryPath( index, length );
+
+        // Compare the way std::string does, so the order matches the packer's sort.
+        int result = memcmp( pPath, path.data(), min<size_t>( length, path.size() ) );
+        if( (result < 0) || ((result == 0) && (length < path.size())) )
+        {
+            first = index + 1;
+            count -= step + 1;
+        }
+        else
+            count = step;
+    }
+
+    return first;
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#ifndef __archive_h__
+#define __archive_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+
+// Standard lib dependencies
+#include <string>
+#include <vector>
+
+/// *************************************************************************
+/// <summary>
+/// A file's data inside the archive. It points into the mapped archive and
+/// is valid until the archive is closed.
+/// </summary>
+/// *************************************************************************
+class CArchiveSlice
+{
+public:
+    // Start of the file's data. Not null terminated.
+    const char * pData = nullptr;
+
+    // Size of the data in bytes.
+    size_t size = 0;
+};
+
+/// *************************************************************************
+/// <summary>
+/// Singleton class to read the game's data files out of a single packed
+/// archive. The archive is memory mapped and has a table of contents sorted
+/// by path, so files are found with a binary search and read without being
+/// copied. Paths are the same ones used to load the files from the folders,
+/// so the managers check the archive first and fall back to the filesystem.
+/// </summary>
+/// *************************************************************************
+class CArchive
+{
+public:
+    // Get the instance of the singleton class
+    static CArchive & Instance()
+    {
+        static CArchive archive;
+        return archive;
+    }
+
+    // Pack the data files in the folder and its sub folders into an archive.
+    static uint Pack( const std::string & folderPath, const std::string & archivePath );
+
+    // Map the archive. Returns false if the archive doesn't exist.
+    bool Open( const std::string & archivePath );
+
+    // Unmap the archive. Any slices taken from it become invalid.
+    void Close();
+
+    // Whether an archive is open.
+    bool IsOpen() const;
+
+    // Find a file in the archive.
+    bool Find( const std::string & filePath, CArchiveSlice & slice ) const;
+
+    // Get the paths of the files directly in the folder.
+    bool GetFileList( const std::string & folderPath, std::vector<std::string> & pathList ) const;
+
+    // Get the number of files in the archive.
+    uint GetFileCount() const;
+
+private:
+
+    // Constructor
+    CArchive();
+
+    // Destructor
+    virtual ~CArchive();
+
+    // Get the path of the entry in the table of contents.
+    const char * GetEntryPath( uint index, uint & length ) const;
+
+    // Find the first entry whose path isn't less than the passed in path.
+    uint LowerBound( const std::string & path ) const;
+
+private:
+
+    // Start of the mapped archive.
+    const char * _pData = nullptr;
+
+    // Size of the mapped archive in bytes.
+    size_t _size = 0;
+
+    // Number of files in the archive.
+    uint _fileCount = 0;
+
+    // Copy of the archive, for platforms where it couldn't be mapped.
+    std::vector<char> _buffer;
+};
+
+#endif  // __archive_h__
\ No newline at end of file
@@ -0,0 +1,186 @@
+// Physical component dependency
+#include "arena.h"
+
+// Standard lib dependencies
+#include <algorithm>
+
+using namespace std;
+
+namespace
+{
+    // The arena each thread allocates from.
+    thread_local CArena * pCurrentArena = nullptr;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Constructor
+/// </summary>
+/// *************************************************************************
+CArena::CArena()
+{
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Destructor
+/// </summary>
+/// *************************************************************************
+CArena::~CArena()
+{
+    for( auto & block : _blockList )
+        ::operator delete( block.pData );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Allocate memory from the current block, adding a block if it's full.
+/// </summary>
+/// <param name="size"> Number of bytes to allocate. </param>
+/// <param name="alignment"> Alignment of the memory. Must be a power of two. </param>
+/// *************************************************************************
+void * CArena::Allocate( size_t size, size_t alignment )
+{
+    size_t padding = (alignment - ((size_t)_pNext & (alignment - 1))) & (alignment - 1);
+
+    if( !_pNext || (size + padding > (size_t)(_pEnd - _pNext)) )
+    {
+        AddBlock( size + alignment );
+        padding = (alignment - ((size_t)_pNext & (alignment - 1))) & (alignment - 1);
+    }
+
+    char * ptr = _pNext + padding;
+    _pNext = ptr + size;
+    ++_allocationCount;
+
+    return ptr;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Whether the memory was allocated from this arena. The newest blocks are
+/// the biggest, so they're checked first.
+/// </summary>
+/// *************************************************************************
+bool CArena::Owns( const void * ptr ) const
+{
+    const char * pByte = static_cast<const char *>( ptr );
+
+    for( auto iter = _blockList.rbegin(); iter != _blockList.rend(); ++iter )
+        if( (pByte >= iter->pData) && (pByte < iter->pData + iter->size) )
+            return true;
+
+    return false;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the number of allocations made.
+/// </summary>
+/// *************************************************************************
+uint CArena::GetAllocationCount() const
+{
+    return _allocationCount;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the number of blocks allocated from the heap.
+/// </summary>
+/// *************************************************************************
+uint CArena::GetBlockCount() const
+{
+    return (uint)_blockList.size();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the arena the calling thread allocates from.
+/// </summary>
+/// <returns> The current arena, or null if there isn't one. </returns>
+/// *************************************************************************
+CArena * CArena::GetCurrent()
+{
+    return pCurrentArena;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Find the arena that owns the memory, checking the calling thread's
+/// current arena and then the ones it's nested in.
+/// </summary>
+/// <returns> The arena, or null if the memory came from the heap. </returns>
+/// *************************************************************************
+CArena * CArena::Find( const void * ptr )
+{
+    for( CArena * pArena = pCurrentArena; pArena; pArena = pArena->_pPrevious )
+        if( pArena->Owns( ptr ) )
+            return pArena;
+
+    return nullptr;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Allocate a block big enough for the size. Blocks double in size, so a
+/// large file only needs a few of them.
+/// </summary>
+/// <param name="size"> Smallest size the block can be. </param>
+/// *************************************************************************
+void CArena::AddBlock( size_t size )
+{
+    size_t blockSize = _blockList.empty() ? FIRST_BLOCK_SIZE : _blockList.back().size * 2;
+    blockSize = max( blockSize, size );
+
+    CBlock block;
+    block.pData = static_cast<char *>( ::operator new( blockSize ) );
+    block.size = blockSize;
+    _blockList.push_back( block );
+
+    _pNext = block.pData;
+    _pEnd = block.pData + block.size;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Constructor. Makes the scope's arena the one the calling thread
+/// allocates from.
+/// </summary>
+/// *************************************************************************
+CArenaScope::CArenaScope()
+{
+    _arena._pPrevious = pCurrentArena;
+    pCurrentArena = &_arena;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Destructor. Makes the previous arena the current one again.
+/// </summary>
+/// *************************************************************************
+CArenaScope::~CArenaScope()
+{
+    pCurrentArena = _arena._pPrevious;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the scope's arena.
+/// </summary>
+/// *************************************************************************
+const CArena & CArenaScope::GetArena() const
+{
+    return _arena;
+}
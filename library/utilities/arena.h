@@ -0,0 +1,207 @@
+#ifndef __arena_h__
+#define __arena_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+
+// Standard lib dependencies
+#include <vector>
+#include <new>
+#include <utility>
+
+/// *************************************************************************
+/// <summary>
+/// Class to hand out memory from large blocks by bumping a pointer. Nothing
+/// is freed on its own, the blocks are all freed together when the arena is
+/// destroyed. Meant for short lived trees, like a parsed json file, that are
+/// built and thrown away in one go.
+/// </summary>
+/// *************************************************************************
+class CArena
+{
+public:
+
+    // Size of the first block. Each block after it is twice the size of the last.
+    static const size_t FIRST_BLOCK_SIZE = 16 * 1024;
+
+    // Constructor
+    CArena();
+
+    // Destructor. Frees all of the blocks.
+    ~CArena();
+
+    // Allocate memory from the current block, adding a block if it's full.
+    void * Allocate( size_t size, size_t alignment );
+
+    // Whether the memory was allocated from this arena.
+    bool Owns( const void * ptr ) const;
+
+    // Get the number of allocations made.
+    uint GetAllocationCount() const;
+
+    // Get the number of blocks allocated from the heap.
+    uint GetBlockCount() const;
+
+    // Get the arena the calling thread allocates from, or null if there isn't one.
+    static CArena * GetCurrent();
+
+    // Find the calling thread's arena, or one it's nested in, that owns the memory.
+    static CArena * Find( const void * ptr );
+
+private:
+
+    friend class CArenaScope;
+
+    // Allocate a block big enough for the size.
+    void AddBlock( size_t size );
+
+    // Copying would free the blocks twice.
+    CArena( const CArena & ) = delete;
+    CArena & operator = ( const CArena & ) = delete;
+
+private:
+
+    /// *************************************************************************
+    /// <summary>
+    /// A block of memory from the heap.
+    /// </summary>
+    /// *************************************************************************
+    class CBlock
+    {
+    public:
+
+        char * pData;
+        size_t size;
+    };
+
+    // Blocks allocated from the heap. The last one is allocated from.
+    std::vector<CBlock> _blockList;
+
+    // Next free byte and the end of the last block.
+    char * _pNext = nullptr;
+    char * _pEnd = nullptr;
+
+    // Number of allocations made.
+    uint _allocationCount = 0;
+
+    // The arena that was current when this one was made current.
+    CArena * _pPrevious = nullptr;
+};
+
+/// *************************************************************************
+/// <summary>
+/// Class to make the calling thread allocate from an arena while it's in
+/// scope. The arena, and everything allocated from it, is freed when the
+/// scope ends, so anything allocated from it has to be destroyed first.
+/// Scopes can be nested, the previous arena is used again when one ends.
+/// </summary>
+/// *************************************************************************
+class CArenaScope
+{
+public:
+
+    // Constructor. Makes the scope's arena the current one.
+    CArenaScope();
+
+    // Destructor. Makes the previous arena the current one again.
+    ~CArenaScope();
+
+    // Get the scope's arena.
+    const CArena & GetArena() const;
+
+private:
+
+    // Copying would end the scope twice.
+    CArenaScope( const CArenaScope & ) = delete;
+    CArenaScope & operator = ( const CArenaScope & ) = delete;
+
+private:
+
+    // The scope's arena.
+    CArena _arena;
+};
+
+/// *************************************************************************
+/// <summary>
+/// Allocator that takes memory from the calling thread's current arena, or
+/// from the heap if there isn't one. Memory from an arena is freed with the
+/// arena. The allocator has no state, so it can be used where the allocator
+/// is default constructed, like in the json library.
+/// </summary>
+/// *************************************************************************
+template <class T>
+class CArenaAllocator
+{
+public:
+
+    typedef T value_type;
+
+    CArenaAllocator()
+    {}
+
+    template <class U>
+    CArenaAllocator( const CArenaAllocator<U> & )
+    {}
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Allocate memory for a number of objects.
+    /// </summary>
+    /// *************************************************************************
+    T * allocate( size_t count )
+    {
+        CArena * pArena = CArena::GetCurrent();
+        if( pArena )
+            return static_cast<T *>( pArena->Allocate( count * sizeof( T ), alignof( T ) ) );
+
+        return static_cast<T *>( ::operator new( count * sizeof( T ) ) );
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Free the memory, unless it came from an arena.
+    /// </summary>
+    /// *************************************************************************
+    void deallocate( T * ptr, size_t )
+    {
+        if( CArena::Find( ptr ) )
+            return;
+
+        ::operator delete( ptr );
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Construct and destroy an object in place. The json library calls these
+    /// directly instead of going through allocator_traits.
+    /// </summary>
+    /// *************************************************************************
+    template <class U, class... Args>
+    void construct( U * ptr, Args && ... args )
+    {
+        ::new( (void *)ptr ) U( std::forward<Args>( args )... );
+    }
+
+    template <class U>
+    void destroy( U * ptr )
+    {
+        ptr->~U();
+    }
+};
+
+template <class T, class U>
+bool operator == ( const CArenaAllocator<T> &, const CArenaAllocator<U> & )
+{
+    return true;
+}
+
+template <class T, class U>
+bool operator != ( const CArenaAllocator<T> &, const CArenaAllocator<U> & )
+{
+    return false;
+}
+
+#endif  // __arena_h__
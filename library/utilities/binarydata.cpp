@@ -0,0 +1,280 @@
+// Physical component dependency
+#include "binarydata.h"
+
+// Game lib dependencies
+#include <common\vector2.h>
+#include <common\vector3.h>
+#include <common\vector4.h>
+#include <common\collectionobject.h>
+#include <utilities\exceptionhandling.h>
+
+using namespace std;
+
+
+/// *************************************************************************
+/// <summary>
+/// Write a string as its length followed by its characters.
+/// </summary>
+/// *************************************************************************
+void CBinaryWriter::Write( const std::string & value )
+{
+    Write( (uint)value.size() );
+    _data.append( value );
+}
+
+/// <summary>
+/// Write a list of strings.
+/// </summary>
+void CBinaryWriter::Write( const std::vector<std::string> & valueList )
+{
+    Write( (uint)valueList.size() );
+    for( auto & value : valueList )
+        Write( value );
+}
+
+/// <summary>
+/// Write a list of string lists.
+/// </summary>
+void CBinaryWriter::Write( const std::vector<std::vector<std::string>> & valueList )
+{
+    Write( (uint)valueList.size() );
+    for( auto & value : valueList )
+        Write( value );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Write a vector.
+/// </summary>
+/// *************************************************************************
+void CBinaryWriter::Write( const CVector2<float> & value )
+{
+    Write( value.x );
+    Write( value.y );
+}
+
+void CBinaryWriter::Write( const CVector3<float> & value )
+{
+    Write( value.x );
+    Write( value.y );
+    Write( value.z );
+}
+
+void CBinaryWriter::Write( const CVector4<float> & value )
+{
+    Write( value.x );
+    Write( value.y );
+    Write( value.z );
+    Write( value.w );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Write a collection object.
+/// </summary>
+/// *************************************************************************
+void CBinaryWriter::Write( const CCollectionObject & object )
+{
+    Write( object.type );
+    Write( object.name );
+    Write( object.position );
+    Write( object.rotation );
+    Write( object.size );
+    Write( object.color );
+    Write( object.visible );
+    Write( (uint)object.alignment );
+    Write( object.text );
+    Write( object.textAlignment );
+    Write( (uint)object.fields );
+}
+
+/// <summary>
+/// Write a list of collection objects. The count comes first, so the
+/// objects can be read back one at a time.
+/// </summary>
+void CBinaryWriter::Write( const std::vector<CCollectionObject> & objectList )
+{
+    Write( (uint)objectList.size() );
+
+    for( auto & object : objectList )
+        Write( object );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the written data.
+/// </summary>
+/// *************************************************************************
+const string & CBinaryWriter::GetData() const
+{
+    return _data;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Constructor
+/// </summary>
+/// <param name="pData"> Start of the data to read. </param>
+/// <param name="size"> Size of the data. </param>
+/// <param name="version"> Version of the format the data was compiled with. </param>
+/// *************************************************************************
+CBinaryReader::CBinaryReader( const char * pData, size_t size, uint version )
+    : _pData(pData), _size(size), _version(version)
+{
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Read a string.
+/// </summary>
+/// *************************************************************************
+void CBinaryReader::Read( std::string & value )
+{
+    uint length;
+    Read( length );
+
+    value.assign( Advance( length ), length );
+}
+
+/// <summary>
+/// Read a list of strings.
+/// </summary>
+void CBinaryReader::Read( std::vector<std::string> & valueList )
+{
+    valueList.resize( ReadCount( sizeof( uint ) ) );
+    for( auto & value : valueList )
+        Read( value );
+}
+
+/// <summary>
+/// Read a list of string lists.
+/// </summary>
+void CBinaryReader::Read( std::vector<std::vector<std::string>> & valueList )
+{
+    valueList.resize( ReadCount( sizeof( uint ) ) );
+    for( auto & value : valueList )
+        Read( value );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Read a vector.
+/// </summary>
+/// *************************************************************************
+void CBinaryReader::Read( CVector2<float> & value )
+{
+    Read( value.x );
+    Read( value.y );
+}
+
+void CBinaryReader::Read( CVector3<float> & value )
+{
+    Read( value.x );
+    Read( value.y );
+    Read( value.z );
+}
+
+void CBinaryReader::Read( CVector4<float> & value )
+{
+    Read( value.x );
+    Read( value.y );
+    Read( value.z );
+    Read( value.w );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Read a collection object.
+/// </summary>
+/// *************************************************************************
+void CBinaryReader::Read( CCollectionObject & object )
+{
+    uint alignment, fields;
+
+    Read( object.type );
+    Read( object.name );
+    Read( object.position );
+    Read( object.rotation );
+    Read( object.size );
+    Read( object.color );
+    Read( object.visible );
+    Read( alignment );
+    Read( object.text );
+    Read( object.textAlignment );
+    Read( fields );
+
+    object.alignment = alignment;
+    object.fields = fields;
+}
+
+/// <summary>
+/// Read a list of collection objects.
+/// </summary>
+void CBinaryReader::Read( std::vector<CCollectionObject> & objectList )
+{
+    objectList.resize( ReadCount( sizeof( NDefs::EObjectType ) ) );
+    for( auto & object : objectList )
+        Read( object );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Read the number of elements in a list and check the data left has room
+/// for that many before anything is allocated for them, so a corrupt count
+/// fails like any other read past the end instead of asking for gigabytes.
+/// </summary>
+/// <param name="elementSize"> Fewest bytes an element takes in the data. </param>
+/// *************************************************************************
+uint CBinaryReader::ReadCount( size_t elementSize )
+{
+    uint count;
+    Read( count );
+
+    if( count > _size / elementSize )
+        throw NExcept::CCriticalException( "Error",
+                                           "CBinaryReader::ReadCount()",
+                                           "Read past the end of the compiled data." );
+
+    return count;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the version of the format the data was compiled with. Loaders check
+/// this to read data compiled with an older format.
+/// </summary>
+/// *************************************************************************
+uint CBinaryReader::GetVersion() const
+{
+    return _version;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Move past the number of bytes and return where they start.
+/// </summary>
+/// <param name="size"> Number of bytes to move past. </param>
+/// *************************************************************************
+const char * CBinaryReader::Advance( size_t size )
+{
+    if( size > _size )
+        throw NExcept::CCriticalException( "Error",
+                                           "CBinaryReader::Advance()",
+                                           "Read past the end of the compiled data." );
+
+    const char * pData = _pData;
+    _pData += size;
+    _size -= size;
+
+    return pData;
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#ifndef __binary_data_h__
+#define __binary_data_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+
+// Standard lib dependencies
+#include <string>
+#include <vector>
+#include <cstring>
+#include <type_traits>
+
+// Forward declarations
+class CCollectionObject;
+
+template <class T>
+class CVector2;
+
+template <class T>
+class CVector3;
+
+template <class T>
+class CVector4;
+
+/// *************************************************************************
+/// <summary>
+/// Class to write values into a compiled data buffer. Numbers are written as
+/// they are in memory, so the data is read back on the same kind of platform
+/// it was compiled for.
+/// </summary>
+/// *************************************************************************
+class CBinaryWriter
+{
+public:
+
+    /// *************************************************************************
+    /// <summary>
+    /// Write a number, bool or enum.
+    /// </summary>
+    /// *************************************************************************
+    template <class T>
+    void Write( T value )
+    {
+        static_assert( std::is_arithmetic<T>::value || std::is_enum<T>::value, "Only plain values can be written directly." );
+        _data.append( (const char *)&value, sizeof( value ) );
+    }
+
+    // Write a string or a list of them.
+    void Write( const std::string & value );
+    void Write( const std::vector<std::string> & valueList );
+    void Write( const std::vector<std::vector<std::string>> & valueList );
+
+    // Write a vector.
+    void Write( const CVector2<float> & value );
+    void Write( const CVector3<float> & value );
+    void Write( const CVector4<float> & value );
+
+    // Write a collection object or a list of them.
+    void Write( const CCollectionObject & object );
+    void Write( const std::vector<CCollectionObject> & objectList );
+
+    // Get the written data.
+    const std::string & GetData() const;
+
+private:
+
+    // The written data.
+    std::string _data;
+};
+
+/// *************************************************************************
+/// <summary>
+/// Class to read values out of a compiled data buffer, in the order they
+/// were written. The reader doesn't own the buffer.
+/// </summary>
+/// *************************************************************************
+class CBinaryReader
+{
+public:
+
+    // Constructor
+    CBinaryReader( const char * pData, size_t size, uint version );
+
+    /// *************************************************************************
+    /// <summary>
+    /// Read a number, bool or enum.
+    /// </summary>
+    /// *************************************************************************
+    template <class T>
+    void Read( T & value )
+    {
+        static_assert( std::is_arithmetic<T>::value || std::is_enum<T>::value, "Only plain values can be read directly." );
+        memcpy( &value, Advance( sizeof( value ) ), sizeof( value ) );
+    }
+
+    // Read a string or a list of them.
+    void Read( std::string & value );
+    void Read( std::vector<std::string> & valueList );
+    void Read( std::vector<std::vector<std::string>> & valueList );
+
+    // Read a vector.
+    void Read( CVector2<float> & value );
+    void Read( CVector3<float> & value );
+    void Read( CVector4<float> & value );
+
+    // Read a collection object or a list of them.
+    void Read( CCollectionObject & object );
+    void Read( std::vector<CCollectionObject> & objectList );
+
+    // Read the number of elements in a list, checking the data has room for them.
+    uint ReadCount( size_t elementSize );
+
+    // Get the version of the format the data was compiled with.
+    uint GetVersion() const;
+
+private:
+
+    // Move past the number of bytes and return where they start.
+    const char * Advance( size_t size );
+
+private:
+
+    // The next byte to read.
+    const char * _pData;
+
+    // Number of bytes left to read.
+    size_t _size;
+
+    // Version of the format the data was compiled with.
+    uint _version;
+};
+
+#endif  // __binary_data_h__
\ No newline at end of file
@@ -0,0 +1,183 @@
+// Physical component dependency
+#include "datacompiler.h"
+
+// Game lib dependencies
+#include <utilities\datafile.h>
+#include <utilities\binarydata.h>
+#include <utilities\generalfuncs.h>
+#include <utilities\jsonparsehelper.h>
+#include <utilities\exceptionhandling.h>
+#include <common\collectionobject.h>
+#include <3d\spritedata3d.h>
+#include <2d\spritedata2d.h>
+#include <2d\textspritedata.h>
+#include <controls\menudata.h>
+#include <controls\controldata.h>
+#include <script\animationdata.h>
+
+// Standard lib dependencies
+#include <fstream>
+#include <map>
+
+using namespace std;
+using namespace nlohmann;
+using namespace NDefs;
+
+namespace
+{
+    /// *************************************************************************
+    /// <summary>
+    /// Load named data from the json node and write it out.
+    /// </summary>
+    /// *************************************************************************
+    template <class T>
+    void WriteData( const string & name, json::const_iterator iter, CBinaryWriter & writer )
+    {
+        T data;
+        data.LoadFromIter( name, iter );
+        data.Write( writer );
+    }
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get the tag the data's json node is found under.
+    /// </summary>
+    /// *************************************************************************
+    const char * GetTag( EDataType type )
+    {
+        switch( type )
+        {
+        case EDT_SPRITE_3D:     return "spriteData3d";
+        case EDT_SPRITE_2D:     return "spriteData2d";
+        case EDT_TEXT_SPRITE:   return "textSpriteData";
+        case EDT_COLLECTION:    return "collection";
+        case EDT_MENU:          return "menu";
+        case EDT_CONTROL:       return "menu";
+        case EDT_ANIMATION:     return "animation";
+        default:                return nullptr;
+        }
+    }
+}
+
+namespace NDataCompiler
+{
+    /// *************************************************************************
+    /// <summary>
+    /// Compile a json data file into the binary format CDataFile reads. The
+    /// data is loaded through the same LoadFromIter() functions the managers
+    /// use, so the compiled file holds exactly what parsing the json would.
+    /// </summary>
+    /// <param name="type"> Type of data in the file. </param>
+    /// <param name="jsonPath"> Path to the json file. </param>
+    /// <param name="binaryPath"> Path to write the compiled file to. </param>
+    /// *************************************************************************
+    void Compile( EDataType type, const string & jsonPath, const string & binaryPath )
+    {
+        try
+        {
+            const char * pTag = GetTag( type );
+            if( pTag == nullptr )
+                throw NExcept::CCriticalException( "Error",
+                                                   "NDataCompiler::Compile()",
+                                                   "Invalid data type." );
+
+            json j;
+            CDataFile( jsonPath ).GetJson( j );
+
+            auto iter = j.find( pTag );
+            if( iter == j.end() )
+                throw NExcept::CCriticalException( "Error",
+                                                   "NDataCompiler::Compile()",
+                                                   "Tag '" + string( pTag ) + "' not found." );
+
+            // The data is named after the file, the same as in the file lists.
+            string name = jsonPath.substr( jsonPath.find_last_of( "/\\" ) + 1 );
+            name = name.substr( 0, name.rfind( '.' ) );
+
+            CBinaryWriter writer;
+
+            switch( type )
+            {
+            case EDT_SPRITE_3D:     WriteData<CSpriteData3D>( name, iter, writer );    break;
+            case EDT_SPRITE_2D:     WriteData<CSpriteData2D>( name, iter, writer );    break;
+            case EDT_TEXT_SPRITE:   WriteData<CTextSpriteData>( name, iter, writer );  break;
+            case EDT_MENU:          WriteData<CMenuData>( name, iter, writer );        break;
+            case EDT_CONTROL:       WriteData<CControlData>( name, iter, writer );     break;
+
+            case EDT_COLLECTION:
+            {
+                vector<CCollectionObject> objectList;
+                for( auto objectIter = iter->begin(); objectIter != iter->end(); ++objectIter )
+                {
+                    objectList.emplace_back();
+                    NParseHelper::GetCollectionObject( objectIter, objectList.back() );
+                }
+
+                writer.Write( objectList );
+                break;
+            }
+
+            case EDT_ANIMATION:
+            {
+                CAnimationData data;
+                data.LoadFromIter( iter );
+                data.Write( writer );
+                break;
+            }
+
+            default:
+                break;
+            }
+
+            ofstream file( binaryPath, ios::binary | ios::trunc );
+            file << CDataFile::GetHeader( type ) << writer.GetData();
+
+            if( !file )
+                throw NExcept::CCriticalException( "Error",
+                                                   "NDataCompiler::Compile()",
+                                                   "Failed to write '" + binaryPath + "'." );
+        }
+        catch( exception e )
+        {
+            throw NExcept::CCriticalException( "Error",
+                                               "NDataCompiler::Compile()",
+                                               "Failed to compile '" + jsonPath + "'.", e );
+        }
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Compile every json data file in the folder into the output folder. Each
+    /// file keeps its name with a .bin extension, so pointing the manager at
+    /// the output folder, or packing it, loads the compiled data instead.
+    /// </summary>
+    /// <param name="type"> Type of data in the folder. </param>
+    /// <param name="folderPath"> Path to the folder of json files. </param>
+    /// <param name="outputPath"> Path to the folder to write to. Must exist. </param>
+    /// <returns> Number of files compiled. </returns>
+    /// *************************************************************************
+    uint CompileFolder( EDataType type, const string & folderPath, const string & outputPath )
+    {
+        map<const string, const string> fileList;
+        NGeneralFuncs::AddFilesToMap( folderPath, fileList );
+
+        string folder( outputPath );
+        if( !folder.empty() && (folder.back() != '/') && (folder.back() != '\\') )
+            folder += '/';
+
+        uint count = 0;
+
+        for( auto & kv : fileList )
+        {
+            // Only compile the json. Anything already compiled is skipped.
+            if( (kv.second.size() < 5) || (kv.second.compare( kv.second.size() - 5, 5, ".json" ) != 0) )
+                continue;
+
+            Compile( type, kv.second, folder + kv.first + ".bin" );
+            ++count;
+        }
+
+        return count;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef __data_compiler_h__
+#define __data_compiler_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+
+// Standard lib dependencies
+#include <string>
+
+namespace NDataCompiler
+{
+    // Compile a json data file into the binary format CDataFile reads.
+    void Compile( NDefs::EDataType type, const std::string & jsonPath, const std::string & binaryPath );
+
+    // Compile every json data file in the folder into the output folder.
+    uint CompileFolder( NDefs::EDataType type, const std::string & folderPath, const std::string & outputPath );
+}
+
+#endif  // __data_compiler_h__
\ No newline at end of file
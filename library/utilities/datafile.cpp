@@ -0,0 +1,175 @@
+// Physical component dependency
+#include "datafile.h"
+
+// Game lib dependencies
+#include <utilities\archive.h>
+#include <utilities\exceptionhandling.h>
+
+// Standard lib dependencies
+#include <fstream>
+#include <iterator>
+
+using namespace std;
+
+namespace
+{
+    // Compiled data starts with the magic bytes, the format version and the data type.
+    const char DATA_MAGIC[] = { 'A', 'G', 'K', 'D' };
+    const size_t HEADER_SIZE = sizeof( DATA_MAGIC ) + sizeof( uint ) + sizeof( NDefs::EDataType );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Constructor. Takes a slice of the file if it's in the archive, otherwise
+/// reads it from the filesystem.
+/// </summary>
+/// <param name="filePath"> Path to the file. </param>
+/// *************************************************************************
+CDataFile::CDataFile( const std::string & filePath )
+    : _path(filePath)
+{
+    CArchiveSlice slice;
+    if( CArchive::Instance().Find( filePath, slice ) )
+    {
+        _pData = slice.pData;
+        _size = slice.size;
+    }
+    else
+    {
+        ifstream file( filePath, ios::binary );
+        _buffer.assign( istreambuf_iterator<char>( file ), istreambuf_iterator<char>() );
+
+        _pData = _buffer.data();
+        _size = _buffer.size();
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Whether the file holds compiled data.
+/// </summary>
+/// *************************************************************************
+bool CDataFile::IsCompiled() const
+{
+    return (_size >= HEADER_SIZE) && (memcmp( _pData, DATA_MAGIC, sizeof( DATA_MAGIC ) ) == 0);
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get a reader for the compiled data. The data must be of the type asked
+/// for and compiled with this version of the format or an older one.
+/// </summary>
+/// <param name="type"> Type of data expected. </param>
+/// *************************************************************************
+CBinaryReader CDataFile::GetReader( NDefs::EDataType type ) const
+{
+    if( !IsCompiled() )
+        throw NExcept::CCriticalException( "Error",
+                                           "CDataFile::GetReader()",
+                                           "File '" + _path + "' isn't compiled." );
+
+    uint version;
+    NDefs::EDataType dataType;
+    memcpy( &version, _pData + sizeof( DATA_MAGIC ), sizeof( version ) );
+    memcpy( &dataType, _pData + sizeof( DATA_MAGIC ) + sizeof( version ), sizeof( dataType ) );
+
+    if( (version == 0) || (version > VERSION) )
+        throw NExcept::CCriticalException( "Error",
+                                           "CDataFile::GetReader()",
+                                           "File '" + _path + "' wasn't compiled with a supported version." );
+
+    if( dataType != type )
+        throw NExcept::CCriticalException( "Error",
+                                           "CDataFile::GetReader()",
+                                           "File '" + _path + "' doesn't hold the expected type of data." );
+
+    return CBinaryReader( _pData + HEADER_SIZE, _size - HEADER_SIZE, version );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Parse the file into a json object.
+/// </summary>
+/// <param name="j"> Json object to parse into. </param>
+/// *************************************************************************
+void CDataFile::GetJson( nlohmann::json & j ) const
+{
+    j = nlohmann::json::parse( _pData, _pData + _size );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Parse the json array under the top level tag one element at a time. Each
+/// element is passed to the callback as soon as it's been read and is then
+/// thrown away, so only one element is ever held in memory instead of the
+/// whole tree.
+/// </summary>
+/// <param name="tag"> Top level tag of the array. </param>
+/// <param name="callback"> Called with each element of the array. </param>
+/// *************************************************************************
+void CDataFile::StreamJsonArray( const std::string & tag, TElementCallback callback ) const
+{
+    // The parse helpers take an iterator, so the element is passed in a list
+    // of one.
+    nlohmann::json elementList = nlohmann::json::array();
+    bool inTag = false;
+
+    auto parserCallback = [&]( int depth, nlohmann::json::parse_event_t event, nlohmann::json & parsed )
+    {
+        typedef nlohmann::json::parse_event_t EEvent;
+
+        // The keys of the top level object are at a depth of one.
+        if( (depth == 1) && (event == EEvent::key) )
+            inTag = (parsed == tag);
+
+        // The elements of the array end at a depth of two.
+        else if( inTag && (depth == 2) &&
+                 ((event == EEvent::object_end) || (event == EEvent::array_end) || (event == EEvent::value)) )
+        {
+            elementList.push_back( std::move( parsed ) );
+            callback( elementList.cbegin() );
+            elementList.clear();
+
+            // Leave the element out of the tree.
+            return false;
+        }
+
+        return true;
+    };
+
+    nlohmann::json::parse( _pData, _pData + _size, parserCallback );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the size of the file in bytes.
+/// </summary>
+/// *************************************************************************
+size_t CDataFile::GetSize() const
+{
+    return _size;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the header compiled data of the type starts with.
+/// </summary>
+/// <param name="type"> Type of data. </param>
+/// *************************************************************************
+string CDataFile::GetHeader( NDefs::EDataType type )
+{
+    uint version = VERSION;
+
+    string header( DATA_MAGIC, sizeof( DATA_MAGIC ) );
+    header.append( (const char *)&version, sizeof( version ) );
+    header.append( (const char *)&type, sizeof( type ) );
+
+    return header;
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#ifndef __data_file_h__
+#define __data_file_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+#include <utilities\binarydata.h>
+#include <utilities\arena.h>
+#include <utilities\json.hpp>
+
+// Standard lib dependencies
+#include <string>
+#include <memory>
+#include <functional>
+
+/// *************************************************************************
+/// <summary>
+/// Class to load a data file, from the archive if it's packed or from the
+/// filesystem if not. The file is either json, or data compiled by
+/// NDataCompiler, which starts with a header giving the format version and
+/// the type of data.
+/// </summary>
+/// *************************************************************************
+class CDataFile
+{
+public:
+
+    // Called with each element of a streamed json array. The element is
+    // freed once the call returns.
+    typedef std::function<void( nlohmann::json::const_iterator iter )> TElementCallback;
+
+    // Version of the compiled data format. Loaders can check the reader's
+    // version to handle data compiled with an older format.
+    static const uint VERSION = 2;
+
+    // Constructor
+    CDataFile( const std::string & filePath );
+
+    // Whether the file holds compiled data.
+    bool IsCompiled() const;
+
+    // Get a reader for the compiled data after checking its header.
+    CBinaryReader GetReader( NDefs::EDataType type ) const;
+
+    // Parse the file into a json object.
+    void GetJson( nlohmann::json & j ) const;
+
+    // Parse the json array under the tag one element at a time.
+    void StreamJsonArray( const std::string & tag, TElementCallback callback ) const;
+
+    // Get the size of the file in bytes.
+    size_t GetSize() const;
+
+    // Load named data out of the file into a new object.
+    template <class T>
+    T * Load( const std::string & name, NDefs::EDataType type, const char * pTag ) const;
+
+    // Get the header compiled data of the type starts with.
+    static std::string GetHeader( NDefs::EDataType type );
+
+private:
+
+    // Path to the file, for error messages.
+    std::string _path;
+
+    // Start of the file's data.
+    const char * _pData = nullptr;
+
+    // Size of the file's data.
+    size_t _size = 0;
+
+    // The file's data when it was read from the filesystem.
+    std::string _buffer;
+};
+
+
+/// *************************************************************************
+/// <summary>
+/// Load named data out of the file into a new object, from the compiled data
+/// if the file is compiled, otherwise from the json node under the tag. Only
+/// reads the file, so it's safe to call from a worker thread.
+/// </summary>
+/// <param name="name"> Name of the data. </param>
+/// <param name="type"> Type of data expected in compiled data. </param>
+/// <param name="pTag"> Tag the data is under in json. </param>
+/// <returns> The new object, which belongs to the caller. Null if the tag
+/// doesn't exist. </returns>
+/// *************************************************************************
+template <class T>
+T * CDataFile::Load( const std::string & name, NDefs::EDataType type, const char * pTag ) const
+{
+    std::unique_ptr<T> pData( new T() );
+
+    if( IsCompiled() )
+    {
+        CBinaryReader reader = GetReader( type );
+        pData->Read( name, reader );
+    }
+    else
+    {
+        // The tree is built in an arena and freed with it in one go.
+        CArenaScope arenaScope;
+
+        nlohmann::json j;
+        GetJson( j );
+
+        auto iter = j.find( pTag );
+        if( iter == j.end() )
+            return nullptr;
+
+        pData->LoadFromIter( name, iter );
+    }
+
+    return pData.release();
+}
+
+#endif  // __data_file_h__
\ No newline at end of file
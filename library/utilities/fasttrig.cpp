@@ -0,0 +1,264 @@
+// Physical component dependency
+#include "fasttrig.h"
+
+// Standard lib dependencies
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// Use the SSE kernel for lists of angles on targets that have SSE2. Define FASTTRIG_NO_SIMD to force the scalar code.
+#if !defined(FASTTRIG_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define FASTTRIG_SSE
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // Radians in a degree, as a float.
+    const float DEG_TO_RAD = (float)defs_DEG_TO_RAD;
+
+    // Pi / 2 split in two, so the range reduction keeps the bits lost by a float.
+    const float HALF_PI_HI = 1.5707963705062866f;
+    const float HALF_PI_LO = -4.3711388286737929e-08f;
+    const float TWO_OVER_PI = 0.63661977236758134f;
+
+    // Adding 1.5 * 2^23 to a float rounds it to a whole number, which is then
+    // held in the low bits of the result.
+    const float ROUND_MAGIC = 12582912.f;
+
+    // Number of table entries for a full circle.
+    const int TABLE_SIZE = 360 * NFastTrig::TABLE_STEPS_PER_DEGREE;
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get the sine and cosine of an angle between -pi/4 and pi/4 using
+    /// minimax polynomials.
+    /// </summary>
+    /// *************************************************************************
+    inline void SinCosPoly( float x, float & s, float & c )
+    {
+        float x2 = x * x;
+
+        s = x + x * x2 * (-1.6666654611e-1f + x2 * (8.3321608736e-3f + x2 * -1.9515295891e-4f));
+        c = 1 - 0.5f * x2 + x2 * x2 * (4.166664568298827e-2f + x2 * (-1.388731625493765e-3f + x2 * 2.443315711809948e-5f));
+    }
+
+    /// *************************************************************************
+    /// <summary>
+    /// Turn the sine and cosine of the reduced angle into the sine and cosine
+    /// of the angle, using the quarter turn it was reduced by. Written without
+    /// branches so the loops over lists of angles can be vectorized.
+    /// </summary>
+    /// *************************************************************************
+    inline void Unreduce( int quadrant, float rs, float rc, float & s, float & c )
+    {
+        // Odd quarter turns swap the sine and cosine. Multiplying by 0 or 1
+        // picks one of them exactly without a branch.
+        float swap = (float)(quadrant & 1);
+        float keep = 1 - swap;
+        float sinSign = (float)(1 - (quadrant & 2));
+        float cosSign = (float)(1 - ((quadrant + 1) & 2));
+
+        s = (rs * keep + rc * swap) * sinSign;
+        c = (rc * keep + rs * swap) * cosSign;
+    }
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get the sine and cosine of an angle in degrees using the polynomials.
+    /// The angle is reduced to within 45 degrees of a quarter turn while it's
+    /// still in degrees, which is exact for whole quarter turns.
+    /// </summary>
+    /// *************************************************************************
+    inline void SinCosDegInline( float degrees, float & s, float & c )
+    {
+        float shifted = degrees * (1.f / 90.f) + ROUND_MAGIC;
+        int quarter;
+        memcpy( &quarter, &shifted, sizeof( quarter ) );
+
+        float reduced = (degrees - (shifted - ROUND_MAGIC) * 90.f) * DEG_TO_RAD;
+
+        float rs, rc;
+        SinCosPoly( reduced, rs, rc );
+        Unreduce( quarter, rs, rc, s, c );
+    }
+
+#if defined(FASTTRIG_SSE)
+    /// *************************************************************************
+    /// <summary>
+    /// Get the sine and cosine of four angles in degrees. The same steps as
+    /// SinCosDegInline(), with the quarter turn picked by masks.
+    /// </summary>
+    /// *************************************************************************
+    inline void SinCosDeg4( const float * pDegrees, float * pSin, float * pCos )
+    {
+        __m128 degrees = _mm_loadu_ps( pDegrees );
+
+        // Round to the nearest quarter turn.
+        __m128 shifted = _mm_add_ps( _mm_mul_ps( degrees, _mm_set1_ps( 1.f / 90.f ) ), _mm_set1_ps( ROUND_MAGIC ) );
+        __m128i quarter = _mm_castps_si128( shifted );
+        __m128 whole = _mm_sub_ps( shifted, _mm_set1_ps( ROUND_MAGIC ) );
+
+        __m128 x = _mm_mul_ps( _mm_sub_ps( degrees, _mm_mul_ps( whole, _mm_set1_ps( 90.f ) ) ), _mm_set1_ps( DEG_TO_RAD ) );
+        __m128 x2 = _mm_mul_ps( x, x );
+
+        __m128 s = _mm_add_ps( _mm_mul_ps( x2, _mm_set1_ps( -1.9515295891e-4f ) ), _mm_set1_ps( 8.3321608736e-3f ) );
+        s = _mm_add_ps( _mm_mul_ps( x2, s ), _mm_set1_ps( -1.6666654611e-1f ) );
+        s = _mm_add_ps( x, _mm_mul_ps( _mm_mul_ps( x, x2 ), s ) );
+
+        __m128 c = _mm_add_ps( _mm_mul_ps( x2, _mm_set1_ps( 2.443315711809948e-5f ) ), _mm_set1_ps( -1.388731625493765e-3f ) );
+        c = _mm_add_ps( _mm_mul_ps( x2, c ), _mm_set1_ps( 4.166664568298827e-2f ) );
+        c = _mm_add_ps( _mm_sub_ps( _mm_set1_ps( 1 ), _mm_mul_ps( _mm_set1_ps( 0.5f ), x2 ) ), _mm_mul_ps( _mm_mul_ps( x2, x2 ), c ) );
+
+        // Odd quarter turns swap the sine and cosine.
+        __m128i one = _mm_set1_epi32( 1 );
+        __m128 swap = _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128( quarter, one ), one ) );
+        __m128 sinValue = _mm_or_ps( _mm_and_ps( swap, c ), _mm_andnot_ps( swap, s ) );
+        __m128 cosValue = _mm_or_ps( _mm_and_ps( swap, s ), _mm_andnot_ps( swap, c ) );
+
+        // Flip the signs by moving bit 1 of the quarter turn into the sign bit.
+        __m128i two = _mm_set1_epi32( 2 );
+        __m128 sinSign = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( quarter, two ), 30 ) );
+        __m128 cosSign = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( _mm_add_epi32( quarter, one ), two ), 30 ) );
+
+        _mm_storeu_ps( pSin, _mm_xor_ps( sinValue, sinSign ) );
+        _mm_storeu_ps( pCos, _mm_xor_ps( cosValue, cosSign ) );
+    }
+#endif
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get the table of sines, building it the first time it's needed. There
+    /// is one extra entry so an angle can be blended with the next entry
+    /// without wrapping.
+    /// </summary>
+    /// *************************************************************************
+    const std::vector<float> & GetSinTable()
+    {
+        static std::vector<float> table = []()
+        {
+            std::vector<float> values( TABLE_SIZE + 1 );
+            for( int i = 0; i <= TABLE_SIZE; ++i )
+                values[i] = (float)sin( i * defs_DEG_TO_RAD / NFastTrig::TABLE_STEPS_PER_DEGREE );
+
+            return values;
+        }();
+
+        return table;
+    }
+}
+
+namespace NFastTrig
+{
+    /// *************************************************************************
+    /// <summary>
+    /// Get the sine and cosine of an angle in radians.
+    /// </summary>
+    /// <param name="radians"> The angle. </param>
+    /// <param name="s"> Set to the sine. </param>
+    /// <param name="c"> Set to the cosine. </param>
+    /// *************************************************************************
+    void SinCos( float radians, float & s, float & c )
+    {
+        float shifted = radians * TWO_OVER_PI + ROUND_MAGIC;
+        int quarter;
+        memcpy( &quarter, &shifted, sizeof( quarter ) );
+
+        float whole = shifted - ROUND_MAGIC;
+        float reduced = (radians - whole * HALF_PI_HI) - whole * HALF_PI_LO;
+
+        float rs, rc;
+        SinCosPoly( reduced, rs, rc );
+        Unreduce( quarter, rs, rc, s, c );
+    }
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get the sine and cosine of an angle in degrees. Uses the table if
+    /// FASTTRIG_TABLE is defined, otherwise the polynomials.
+    /// </summary>
+    /// <param name="degrees"> The angle. </param>
+    /// <param name="s"> Set to the sine. </param>
+    /// <param name="c"> Set to the cosine. </param>
+    /// *************************************************************************
+    void SinCosDeg( float degrees, float & s, float & c )
+    {
+#if defined(FASTTRIG_TABLE)
+        SinCosDegTable( degrees, s, c );
+#else
+        SinCosDegInline( degrees, s, c );
+#endif
+    }
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get the sine and cosine of a list of angles in degrees. Always uses the
+    /// polynomials, four angles at a time where SSE2 is available.
+    /// </summary>
+    /// <param name="pDegrees"> The angles. </param>
+    /// <param name="pSin"> Set to the sines. </param>
+    /// <param name="pCos"> Set to the cosines. </param>
+    /// <param name="count"> Number of angles. </param>
+    /// *************************************************************************
+    void SinCosDeg( const float * pDegrees, float * pSin, float * pCos, uint count )
+    {
+        uint i = 0;
+
+#if defined(FASTTRIG_SSE)
+        for( ; i + 4 <= count; i += 4 )
+            SinCosDeg4( pDegrees + i, pSin + i, pCos + i );
+#endif
+
+        for( ; i < count; ++i )
+            SinCosDegInline( pDegrees[i], pSin[i], pCos[i] );
+    }
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get the sine and cosine of an angle in degrees using the polynomials.
+    /// </summary>
+    /// <param name="degrees"> The angle. </param>
+    /// <param name="s"> Set to the sine. </param>
+    /// <param name="c"> Set to the cosine. </param>
+    /// *************************************************************************
+    void SinCosDegPoly( float degrees, float & s, float & c )
+    {
+        SinCosDegInline( degrees, s, c );
+    }
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get the sine and cosine of an angle in degrees using the table. The
+    /// values between entries are blended linearly. Negative angles are
+    /// looked up as positive ones and the sine flipped, since wrapping them
+    /// up into the circle would round away the bits of small angles.
+    /// </summary>
+    /// <param name="degrees"> The angle. </param>
+    /// <param name="s"> Set to the sine. </param>
+    /// <param name="c"> Set to the cosine. </param>
+    /// *************************************************************************
+    void SinCosDegTable( float degrees, float & s, float & c )
+    {
+        const std::vector<float> & table = GetSinTable();
+
+        // Wrap the angle to a full circle and find the entries on either side of
+        // it. The remainder of a float is exact, and so is scaling it by the steps.
+        float steps = fmod( fabs( degrees ), 360.f ) * TABLE_STEPS_PER_DEGREE;
+        int index = (int)steps;
+        float blend = steps - (float)index;
+
+        if( index >= TABLE_SIZE )
+            index -= TABLE_SIZE;
+
+        // The cosine is the sine a quarter turn ahead.
+        int cosIndex = index + 90 * TABLE_STEPS_PER_DEGREE;
+        if( cosIndex >= TABLE_SIZE )
+            cosIndex -= TABLE_SIZE;
+
+        s = table[index] + (table[index + 1] - table[index]) * blend;
+        c = table[cosIndex] + (table[cosIndex + 1] - table[cosIndex]) * blend;
+
+        if( degrees < 0 )
+            s = -s;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef __fast_trig_h__
+#define __fast_trig_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+
+/// <summary>
+/// Namespace for the single precision sine and cosine functions used by the
+/// transform code. Lists of angles are done four at a time with SSE2. Define
+/// FASTTRIG_TABLE to have the single angle SinCosDeg() look the values up in
+/// a table instead of using the polynomials.
+/// </summary>
+namespace NFastTrig
+{
+    // Largest absolute error of the polynomials against double precision sin and
+    // cos, for angles in degrees. Whole quarter turns are exact. Measured at
+    // 9.7e-8 over -720 to 720 degrees in 0.0001 degree steps.
+    const float POLY_MAX_ERROR = 1e-7f;
+
+    // Largest absolute error of the table against double precision sin and cos.
+    // Measured at 2.05e-7 the same way, and over every float in the range.
+    const float TABLE_MAX_ERROR = 2.1e-7f;
+
+    // Number of table entries for each degree.
+    const int TABLE_STEPS_PER_DEGREE = 16;
+
+    // Get the sine and cosine of an angle in radians.
+    void SinCos( float radians, float & s, float & c );
+
+    // Get the sine and cosine of an angle in degrees.
+    void SinCosDeg( float degrees, float & s, float & c );
+    void SinCosDeg( const float * pDegrees, float * pSin, float * pCos, uint count );
+
+    // Get the sine and cosine of an angle in degrees using the polynomials.
+    void SinCosDegPoly( float degrees, float & s, float & c );
+
+    // Get the sine and cosine of an angle in degrees using the table.
+    void SinCosDegTable( float degrees, float & s, float & c );
+}
+
+#endif  // __fast_trig_h__
\ No newline at end of file
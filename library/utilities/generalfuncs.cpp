@@ -16,9 +16,46 @@
 #include <common\resourcefile.h>
 #include <utilities\exceptionhandling.h>
 #include <utilities\txtparsehelper.h>
+#include <utilities\archive.h>
+#include <utilities\manifestcache.h>
+
+// Standard lib dependencies
+#include <vector>
 
 using namespace std;
 
+namespace
+{
+    /// *************************************************************************
+    /// <summary>
+    /// Populate the map with the names and paths of the files the archive has
+    /// in the folder. This saves asking the filesystem for them one by one.
+    /// </summary>
+    /// <param name="folderPath"> Path to the folder. </param>
+    /// <param name="obj"> Map to populate. </param>
+    /// <returns> False if the folder isn't in the archive. </returns>
+    /// *************************************************************************
+    template <class value>
+    bool AddArchiveFilesToMap( const string & folderPath, map<const string, value> & obj )
+    {
+        vector<string> pathList;
+        if( !CArchive::Instance().GetFileList( folderPath, pathList ) )
+            return false;
+
+        for( auto & path : pathList )
+        {
+            string file = path.substr( path.rfind( '/' ) + 1 );
+            size_t pos = file.rfind( '.' );
+
+            // If a dot was found, parse out the name.
+            if( pos < file.size() )
+                obj.emplace( file.substr( 0, pos ), path );
+        }
+
+        return true;
+    }
+}
+
 namespace NGeneralFuncs
 {
     /// *************************************************************************
@@ -35,6 +72,14 @@ namespace NGeneralFuncs
         {
             obj.clear();
 
+            // If the folder is packed, the archive already has its files.
+            if( AddArchiveFilesToMap( folderPath, obj ) )
+                return;
+
+            // If the folder hasn't changed since the last run, the manifest already has its files.
+            if( CManifestCache::Instance().Restore( folderPath, obj ) )
+                return;
+
             // Set the folder we want to read from.
             // If we pass in a folder path without the ending '/', getting it here will add it.
             agk::SetFolder( folderPath.c_str() );
@@ -45,7 +90,7 @@ namespace NGeneralFuncs
             // Loop through the folder and grab all of the file paths and names.
             while( !file.empty() )
             {
-                size_t pos = file.find( '.' );
+                size_t pos = file.rfind( '.' );
 
                 // If a dot was found, parse out the name.
                 if( pos < file.size() )
@@ -60,6 +105,8 @@ namespace NGeneralFuncs
 
             // Set the folder back to its original location. Not sure if this is actually necessary.
             agk::SetFolder( "" );
+
+            CManifestCache::Instance().Store( folderPath, obj );
         }
         catch( exception e )
         {
@@ -81,6 +128,14 @@ namespace NGeneralFuncs
         {
             obj.clear();
 
+            // If the folder is packed, the archive already has its files.
+            if( AddArchiveFilesToMap( folderPath, obj ) )
+                return;
+
+            // If the folder hasn't changed since the last run, the manifest already has its files.
+            if( CManifestCache::Instance().Restore( folderPath, obj ) )
+                return;
+
             // Set the folder we want to read from.
             // If we pass in a folder path without the ending '/', getting it here will add it.
             agk::SetFolder( folderPath.c_str() );
@@ -91,7 +146,7 @@ namespace NGeneralFuncs
             // Loop through the folder and grab all of the file paths and names.
             while( !file.empty() )
             {
-                size_t pos = file.find( '.' );
+                size_t pos = file.rfind( '.' );
 
                 // If a dot was found, parse out the name.
                 if( pos < file.size() )
@@ -106,6 +161,8 @@ namespace NGeneralFuncs
 
             // Set the folder back to its original location. Not sure if this is actually necessary.
             agk::SetFolder( "" );
+
+            CManifestCache::Instance().Store( folderPath, obj );
         }
         catch( exception e )
         {
@@ -130,6 +187,10 @@ namespace NGeneralFuncs
         {
             obj.clear();
 
+            // If the folder and its sub image files haven't changed since the last run, the manifest already has its files.
+            if( CManifestCache::Instance().Restore( folderPath, obj ) )
+                return;
+
             // Set the folder we want to read from.
             // If we pass in a folder path without the ending '/', getting it here will add it.
             agk::SetFolder( folderPath.c_str() );
@@ -137,10 +198,13 @@ namespace NGeneralFuncs
             string file = agk::GetFirstFile();
             string name, ext;
 
+            // The sub image files parsed, so the manifest can tell when they change.
+            vector<string> subImageFileList;
+
             // Loop through the folder and grab all of the file paths and names.
             while( !file.empty() )
             {
-                size_t pos = file.find( '.' );
+                size_t pos = file.rfind( '.' );
 
                 // If a dot was found, parse out the name.
                 if( pos < file.size() )
@@ -149,7 +213,10 @@ namespace NGeneralFuncs
 
                     // If a text file was found, it has subimage info. So we need to parse that.
                     if( ext == "txt" )
+                    {
                         NParseHelper::LoadSubImageFile( folder, file, obj );
+                        subImageFileList.push_back( folder + file );
+                    }
                     else
                     {
                         name = file.substr( 0, pos );
@@ -169,6 +236,8 @@ namespace NGeneralFuncs
 
             // Set the folder back to its original location. Not sure if this is actually necessary.
             agk::SetFolder( "" );
+
+            CManifestCache::Instance().Store( folderPath, obj, subImageFileList );
         }
         catch( exception e )
         {
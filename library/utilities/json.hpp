@@ -57,6 +57,8 @@ SOFTWARE.
 #include <utility> // declval, forward, make_pair, move, pair, swap
 #include <vector> // vector
 
+#include <utilities\arena.h> // CArenaAllocator
+
 // exclude unsupported compilers
 #if defined(__clang__)
     #if (__clang_major__ * 10000 + __clang_minor__ * 100 + __clang_patchlevel__) < 30400
@@ -12909,11 +12911,13 @@ basic_json_parser_74:
 @brief default JSON class
 
 This type is the default specialization of the @ref basic_json class which
-uses the standard template types.
+uses the standard template types, except that values are allocated with
+CArenaAllocator. While a CArenaScope is open the tree is built in its arena
+and freed with it, otherwise values come from the heap as usual.
 
 @since version 1.0.0
 */
-using json = basic_json<>;
+using json = basic_json<std::map, std::vector, std::string, bool, std::int64_t, std::uint64_t, double, CArenaAllocator>;
 } // namespace nlohmann
 
 
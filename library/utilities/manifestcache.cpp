@@ -0,0 +1,329 @@
+// Physical component dependency
+#include "manifestcache.h"
+
+// Game lib dependencies
+#include <common\resourcefile.h>
+
+// Standard lib dependencies
+#include <fstream>
+#include <sstream>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace
+{
+    // First line of the manifest file. Changing the format means changing the version.
+    const string MANIFEST_HEADER = "manifest 2";
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get when the file or folder was last modified.
+    /// </summary>
+    /// <param name="path"> Path to the file or folder. </param>
+    /// <returns> The modification time, or zero if it can't be found. </returns>
+    /// *************************************************************************
+    time_t GetModifiedTime( const string & path )
+    {
+        // Folders can't be found with a slash on the end on every platform.
+        string statPath( path );
+        while( (statPath.size() > 1) && ((statPath.back() == '/') || (statPath.back() == '\\')) )
+            statPath.pop_back();
+
+        struct stat info;
+        if( stat( statPath.c_str(), &info ) == 0 )
+            return info.st_mtime;
+
+        return 0;
+    }
+
+    /// *************************************************************************
+    /// <summary>
+    /// Split a line of the manifest into its tab separated fields.
+    /// </summary>
+    /// *************************************************************************
+    vector<string> Split( const string & line )
+    {
+        vector<string> fieldList;
+        stringstream stream( line );
+        string field;
+
+        while( getline( stream, field, '\t' ) )
+            fieldList.push_back( field );
+
+        // A line ending in a tab has an empty last field.
+        if( !line.empty() && (line.back() == '\t') )
+            fieldList.push_back( "" );
+
+        return fieldList;
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Constructor
+/// </summary>
+/// *************************************************************************
+CManifestCache::CManifestCache()
+{
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Destructor
+/// </summary>
+/// *************************************************************************
+CManifestCache::~CManifestCache()
+{
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Read the manifest file. A missing or unreadable manifest just means every
+/// folder gets scanned.
+/// </summary>
+/// <param name="path"> Path to the manifest file. </param>
+/// *************************************************************************
+void CManifestCache::Load( const std::string & path )
+{
+    _path = path;
+    _folderList.clear();
+    _modified = false;
+
+    ifstream file( _path );
+    string line;
+
+    if( !getline( file, line ) || (line != MANIFEST_HEADER) )
+        return;
+
+    try
+    {
+        while( getline( file, line ) )
+        {
+            // folder, path, modified time, entry count, dependency count
+            vector<string> fieldList = Split( line );
+            if( (fieldList.size() != 5) || (fieldList[0] != "folder") )
+                throw runtime_error( "Bad folder line." );
+
+            CFolder & folder = _folderList[fieldList[1]];
+            folder.modifiedTime = (time_t)stoll( fieldList[2] );
+
+            // name, path, sub image
+            folder.entryList.resize( stoul( fieldList[3] ) );
+            for( auto & entry : folder.entryList )
+            {
+                vector<string> entryFieldList;
+                if( getline( file, line ) )
+                    entryFieldList = Split( line );
+
+                if( entryFieldList.size() != 3 )
+                    throw runtime_error( "Bad entry line." );
+
+                entry.name = entryFieldList[0];
+                entry.path = entryFieldList[1];
+                entry.subImage = (entryFieldList[2] == "1");
+            }
+
+            // path, modified time
+            folder.dependencyList.resize( stoul( fieldList[4] ) );
+            for( auto & dependency : folder.dependencyList )
+            {
+                vector<string> dependencyFieldList;
+                if( getline( file, line ) )
+                    dependencyFieldList = Split( line );
+
+                if( dependencyFieldList.size() != 2 )
+                    throw runtime_error( "Bad dependency line." );
+
+                dependency.first = dependencyFieldList[0];
+                dependency.second = (time_t)stoll( dependencyFieldList[1] );
+            }
+        }
+    }
+    catch( exception & )
+    {
+        // The manifest is only a cache, so a damaged one is thrown out and rebuilt.
+        _folderList.clear();
+        _modified = true;
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Write the manifest file if any folder listings were stored.
+/// </summary>
+/// *************************************************************************
+void CManifestCache::Save()
+{
+    if( !_modified || _path.empty() )
+        return;
+
+    ofstream file( _path, ios::trunc );
+    file << MANIFEST_HEADER << "\n";
+
+    for( auto & kv : _folderList )
+    {
+        const CFolder & folder = kv.second;
+
+        file << "folder\t" << kv.first << "\t" << (long long)folder.modifiedTime << "\t"
+             << folder.entryList.size() << "\t" << folder.dependencyList.size() << "\n";
+
+        for( auto & entry : folder.entryList )
+            file << entry.name << "\t" << entry.path << "\t" << (entry.subImage ? 1 : 0) << "\n";
+
+        for( auto & dependency : folder.dependencyList )
+            file << dependency.first << "\t" << (long long)dependency.second << "\n";
+    }
+
+    _modified = false;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Restore the folder's listing if nothing has changed since it was stored.
+/// </summary>
+/// <param name="folderPath"> Path to the folder. </param>
+/// <param name="obj"> Map to populate. </param>
+/// <returns> False if the folder needs to be scanned. </returns>
+/// *************************************************************************
+bool CManifestCache::Restore( const std::string & folderPath, std::map<const std::string, const std::string> & obj ) const
+{
+    const CFolder * pFolder = GetFolder( folderPath );
+    if( !pFolder )
+        return false;
+
+    for( auto & entry : pFolder->entryList )
+        obj.emplace( entry.name, entry.path );
+
+    return true;
+}
+
+/// <summary>
+/// Restore the folder's listing if nothing has changed since it was stored.
+/// </summary>
+/// <param name="folderPath"> Path to the folder. </param>
+/// <param name="obj"> Map to populate. </param>
+/// <returns> False if the folder needs to be scanned. </returns>
+bool CManifestCache::Restore( const std::string & folderPath, std::map<const std::string, CResourceFile> & obj ) const
+{
+    const CFolder * pFolder = GetFolder( folderPath );
+    if( !pFolder )
+        return false;
+
+    for( auto & entry : pFolder->entryList )
+    {
+        CResourceFile resource( entry.subImage ? UNLOADED_SUBIMAGE_ID : UNLOADED_ID, entry.path );
+        resource.subImage = entry.subImage;
+        obj.emplace( entry.name, resource );
+    }
+
+    return true;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Store the folder's listing.
+/// </summary>
+/// <param name="folderPath"> Path to the folder. </param>
+/// <param name="obj"> Map the folder was scanned into. </param>
+/// *************************************************************************
+void CManifestCache::Store( const std::string & folderPath, const std::map<const std::string, const std::string> & obj )
+{
+    CFolder folder;
+
+    for( auto & kv : obj )
+    {
+        CEntry entry;
+        entry.name = kv.first;
+        entry.path = kv.second;
+        folder.entryList.push_back( entry );
+    }
+
+    Store( folderPath, folder, vector<string>() );
+}
+
+/// <summary>
+/// Store the folder's listing, along with the files parsed to build it.
+/// </summary>
+/// <param name="folderPath"> Path to the folder. </param>
+/// <param name="obj"> Map the folder was scanned into. </param>
+/// <param name="dependencyList"> Files parsed to build the listing. </param>
+void CManifestCache::Store( const std::string & folderPath, const std::map<const std::string, CResourceFile> & obj,
+                            const std::vector<std::string> & dependencyList )
+{
+    CFolder folder;
+
+    for( auto & kv : obj )
+    {
+        CEntry entry;
+        entry.name = kv.first;
+        entry.path = kv.second.path;
+        entry.subImage = kv.second.subImage;
+        folder.entryList.push_back( entry );
+    }
+
+    Store( folderPath, folder, dependencyList );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the folder's listing if the folder and the files parsed to build the
+/// listing haven't been modified since it was stored.
+/// </summary>
+/// <param name="folderPath"> Path to the folder. </param>
+/// *************************************************************************
+const CManifestCache::CFolder * CManifestCache::GetFolder( const std::string & folderPath ) const
+{
+    auto iter = _folderList.find( folderPath );
+    if( iter == _folderList.end() )
+        return nullptr;
+
+    const CFolder & folder = iter->second;
+
+    if( folder.modifiedTime != GetModifiedTime( folderPath ) )
+        return nullptr;
+
+    for( auto & dependency : folder.dependencyList )
+        if( dependency.second != GetModifiedTime( dependency.first ) )
+            return nullptr;
+
+    return &folder;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Store the folder's listing with the modification times it was built
+/// from. Folders whose times can't be found aren't stored, since there
+/// would be no way to tell if they changed.
+/// </summary>
+/// <param name="folderPath"> Path to the folder. </param>
+/// <param name="folder"> The listing. </param>
+/// <param name="dependencyList"> Files parsed to build the listing. </param>
+/// *************************************************************************
+void CManifestCache::Store( const std::string & folderPath, CFolder & folder, const std::vector<std::string> & dependencyList )
+{
+    folder.modifiedTime = GetModifiedTime( folderPath );
+    if( folder.modifiedTime == 0 )
+        return;
+
+    for( auto & path : dependencyList )
+    {
+        time_t modifiedTime = GetModifiedTime( path );
+        if( modifiedTime == 0 )
+            return;
+
+        folder.dependencyList.emplace_back( path, modifiedTime );
+    }
+
+    _folderList[folderPath] = folder;
+    _modified = true;
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#ifndef __manifest_cache_h__
+#define __manifest_cache_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+
+// Standard lib dependencies
+#include <string>
+#include <vector>
+#include <map>
+#include <ctime>
+
+// Forward declarations
+class CResourceFile;
+
+/// *************************************************************************
+/// <summary>
+/// Singleton class to remember the files found in each data folder between
+/// runs. A folder's listing is kept with the folder's modification time, and
+/// the times of any files parsed to build it, like the sub image files. If
+/// none of them have changed, the listing is restored without walking the
+/// folder. Folders that changed are scanned as usual and stored again.
+/// </summary>
+/// *************************************************************************
+class CManifestCache
+{
+public:
+    // Get the instance of the singleton class
+    static CManifestCache & Instance()
+    {
+        static CManifestCache manifestCache;
+        return manifestCache;
+    }
+
+    // Read the manifest file.
+    void Load( const std::string & path );
+
+    // Write the manifest file if any folder listings were stored.
+    void Save();
+
+    // Restore the folder's listing if nothing has changed since it was stored.
+    bool Restore( const std::string & folderPath, std::map<const std::string, const std::string> & obj ) const;
+    bool Restore( const std::string & folderPath, std::map<const std::string, CResourceFile> & obj ) const;
+
+    // Store the folder's listing, along with the files parsed to build it.
+    void Store( const std::string & folderPath, const std::map<const std::string, const std::string> & obj );
+    void Store( const std::string & folderPath, const std::map<const std::string, CResourceFile> & obj,
+                const std::vector<std::string> & dependencyList = std::vector<std::string>() );
+
+private:
+
+    /// *************************************************************************
+    /// <summary>
+    /// A file in a folder's listing.
+    /// </summary>
+    /// *************************************************************************
+    class CEntry
+    {
+    public:
+
+        std::string name;
+        std::string path;
+        bool subImage = false;
+    };
+
+    /// *************************************************************************
+    /// <summary>
+    /// A folder's listing and the modification times it was built from.
+    /// </summary>
+    /// *************************************************************************
+    class CFolder
+    {
+    public:
+
+        time_t modifiedTime = 0;
+        std::vector<CEntry> entryList;
+
+        // Files parsed to build the listing, with their modification times.
+        std::vector<std::pair<std::string, time_t>> dependencyList;
+    };
+
+private:
+
+    // Constructor
+    CManifestCache();
+
+    // Destructor
+    virtual ~CManifestCache();
+
+    // Get the folder's listing if nothing has changed since it was stored.
+    const CFolder * GetFolder( const std::string & folderPath ) const;
+
+    // Store the folder's listing.
+    void Store( const std::string & folderPath, CFolder & folder, const std::vector<std::string> & dependencyList );
+
+private:
+
+    // Path to the manifest file.
+    std::string _path;
+
+    // Listing of each folder, by the folder's path.
+    std::map<const std::string, CFolder> _folderList;
+
+    // Whether a listing was stored since the manifest was read.
+    bool _modified = false;
+};
+
+#endif  // __manifest_cache_h__
\ No newline at end of file
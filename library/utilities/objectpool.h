@@ -0,0 +1,210 @@
+#ifndef __object_pool_h__
+#define __object_pool_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+
+// Standard lib dependencies
+#include <vector>
+#include <new>
+
+
+/// *************************************************************************
+/// <summary>
+/// Class to hand out memory for objects of one type from fixed-size blocks.
+/// Freed memory goes on a free list and is reused by the next allocation,
+/// so creating and deleting objects doesn't go to the heap once the pool
+/// has grown to fit. Meant to back a class's operator new and delete.
+/// </summary>
+/// *************************************************************************
+template <typename type>
+class CObjectPool
+{
+public:
+
+    // Number of objects allocated at once when the pool runs out.
+    static const uint BLOCK_SIZE = 256;
+
+    // Constructor
+    CObjectPool()
+    {}
+
+    // Destructor
+    ~CObjectPool()
+    {
+        for( auto pBlock : _pBlockList )
+            ::operator delete( pBlock );
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Allocate memory for an object. Sizes other than the pool's type, such
+    /// as derived classes, are passed on to the heap and counted as misses.
+    /// </summary>
+    /// *************************************************************************
+    void * Allocate( size_t size )
+    {
+        if( size != sizeof( type ) )
+        {
+            ++_missCount;
+            return ::operator new( size );
+        }
+
+        if( _pFreeList )
+            ++_hitCount;
+        else
+        {
+            ++_missCount;
+            AddBlock();
+        }
+
+        CNode * pNode = _pFreeList;
+        _pFreeList = pNode->pNext;
+        ++_count;
+
+        return pNode;
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Return the memory of an object to the pool.
+    /// </summary>
+    /// *************************************************************************
+    void Free( void * ptr, size_t size )
+    {
+        if( !ptr )
+            return;
+
+        if( size != sizeof( type ) )
+        {
+            ::operator delete( ptr );
+            return;
+        }
+
+        CNode * pNode = static_cast<CNode *>( ptr );
+        pNode->pNext = _pFreeList;
+        _pFreeList = pNode;
+        --_count;
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Rebuild the free list in memory order, so new objects are packed
+    /// together again. Only done when no objects are allocated.
+    /// </summary>
+    /// *************************************************************************
+    bool Reset()
+    {
+        if( _count > 0 )
+            return false;
+
+        _pFreeList = nullptr;
+        for( auto iter = _pBlockList.rbegin(); iter != _pBlockList.rend(); ++iter )
+            LinkBlock( *iter );
+
+        return true;
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get the number of allocations served from the free list.
+    /// </summary>
+    /// *************************************************************************
+    uint GetHitCount() const
+    {
+        return _hitCount;
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get the number of allocations that had to grow the pool or use the heap.
+    /// </summary>
+    /// *************************************************************************
+    uint GetMissCount() const
+    {
+        return _missCount;
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get the number of objects currently allocated from the pool.
+    /// </summary>
+    /// *************************************************************************
+    uint GetCount() const
+    {
+        return _count;
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Get the number of objects the pool can hold without growing.
+    /// </summary>
+    /// *************************************************************************
+    uint GetCapacity() const
+    {
+        return (uint)_pBlockList.size() * BLOCK_SIZE;
+    }
+
+private:
+
+    // Free slots hold the link to the next free slot.
+    union CNode
+    {
+        CNode * pNext;
+        alignas( type ) char storage[sizeof( type )];
+    };
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Allocate a new block and add its slots to the free list.
+    /// </summary>
+    /// *************************************************************************
+    void AddBlock()
+    {
+        CNode * pBlock = static_cast<CNode *>( ::operator new( sizeof( CNode ) * BLOCK_SIZE ) );
+        _pBlockList.push_back( pBlock );
+
+        LinkBlock( pBlock );
+    }
+
+
+    /// *************************************************************************
+    /// <summary>
+    /// Push all of the block's slots onto the free list, lowest address first.
+    /// </summary>
+    /// *************************************************************************
+    void LinkBlock( CNode * pBlock )
+    {
+        for( uint i = BLOCK_SIZE; i > 0; --i )
+        {
+            pBlock[i - 1].pNext = _pFreeList;
+            _pFreeList = &pBlock[i - 1];
+        }
+    }
+
+private:
+
+    // Blocks of slots owned by the pool.
+    std::vector<CNode *> _pBlockList;
+
+    // First free slot.
+    CNode * _pFreeList = nullptr;
+
+    // Number of objects currently allocated.
+    uint _count = 0;
+
+    // Allocation counters.
+    uint _hitCount = 0;
+    uint _missCount = 0;
+
+};
+
+#endif  // __object_pool_h__
\ No newline at end of file
@@ -0,0 +1,182 @@
+// Physical component dependency
+#include "preloader.h"
+
+// Game lib dependencies
+#include <utilities\threadpool.h>
+#include <utilities\generalfuncs.h>
+#include <managers\spritemanager.h>
+#include <managers\menumanager.h>
+#include <managers\scriptmanager.h>
+
+using namespace std;
+
+namespace
+{
+    // Longest the progress callback goes without being called, so a loading
+    // screen keeps drawing while a large file is read.
+    const chrono::milliseconds PROGRESS_INTERVAL( 16 );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Preload the sprite, text sprite, collection, menu, control and animation
+/// data files that haven't been loaded yet. The file lists need to be
+/// loaded first. The time each category took is posted as a debug message.
+/// </summary>
+/// <param name="callback"> Called with the number of files done and the
+/// total, for a loading screen. </param>
+/// <returns> How long each category took. </returns>
+/// *************************************************************************
+vector<CPreloadTiming> CPreloader::PreloadAll( TProgressCallback callback )
+{
+    CPreloader preloader;
+
+    CSpriteManager::Instance().Preload( preloader );
+    CMenuManager::Instance().Preload( preloader );
+    CScriptManager::Instance().Preload( preloader );
+
+    vector<CPreloadTiming> timingList = preloader.Run( callback );
+
+    for( auto & timing : timingList )
+        NGeneralFuncs::PostDebugMsg( boost::str( boost::format( "Preloaded %d %s files in %.3f seconds." )
+                                                 % timing.count % timing.category % timing.seconds ) );
+
+    return timingList;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Add a job to load a file.
+/// </summary>
+/// <param name="category"> Category the file is timed under. </param>
+/// <param name="job"> Loads the file and returns the step that publishes it. </param>
+/// *************************************************************************
+void CPreloader::Add( const std::string & category, TLoadJob job )
+{
+    CJob newJob;
+    newJob.category = category;
+    newJob.load = job;
+
+    _jobList.push_back( newJob );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Run the jobs on a thread pool, then publish the data they loaded. The
+/// maps are only touched after every file has been read, so nothing sees
+/// part of the data. If a job failed, everything else is still published
+/// before the first error is thrown again.
+/// </summary>
+/// <param name="callback"> Called with the number of files done and the
+/// total, for a loading screen. </param>
+/// <returns> How long each category took, in the order they were added. </returns>
+/// *************************************************************************
+vector<CPreloadTiming> CPreloader::Run( TProgressCallback callback )
+{
+    const uint totalCount = (uint)_jobList.size();
+    _doneCount = 0;
+    _pError = nullptr;
+
+    {
+        CThreadPool threadPool;
+
+        for( auto & job : _jobList )
+        {
+            CJob * pJob = &job;
+            threadPool.Add( [this, pJob]() { Work( *pJob ); } );
+        }
+
+        // Report the progress on this thread while the workers load.
+        unique_lock<mutex> lock( _mutex );
+        uint doneCount = 0;
+
+        while( doneCount < totalCount )
+        {
+            _doneCondition.wait_for( lock, PROGRESS_INTERVAL );
+            doneCount = _doneCount;
+
+            if( callback )
+            {
+                lock.unlock();
+                callback( doneCount, totalCount );
+                lock.lock();
+            }
+        }
+    }
+
+    // Publish everything in one step, in the order the jobs were added.
+    vector<CPreloadTiming> timingList;
+    vector<pair<TClock::time_point, TClock::time_point>> rangeList;
+    map<string, size_t> categoryList;
+
+    for( auto & job : _jobList )
+    {
+        if( job.publish )
+            job.publish();
+
+        auto result = categoryList.emplace( job.category, timingList.size() );
+        if( result.second )
+        {
+            CPreloadTiming timing;
+            timing.category = job.category;
+
+            timingList.push_back( timing );
+            rangeList.emplace_back( job.start, job.end );
+        }
+
+        size_t index = result.first->second;
+        ++timingList[index].count;
+        rangeList[index].first = min( rangeList[index].first, job.start );
+        rangeList[index].second = max( rangeList[index].second, job.end );
+    }
+
+    for( size_t i = 0; i < timingList.size(); ++i )
+        timingList[i].seconds = chrono::duration<float>( rangeList[i].second - rangeList[i].first ).count();
+
+    _jobList.clear();
+
+    if( _pError )
+        rethrow_exception( _pError );
+
+    return timingList;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Run the job on a worker. Errors are kept for the calling thread, since
+/// they can't be thrown across threads.
+/// </summary>
+/// <param name="job"> The job to run. </param>
+/// *************************************************************************
+void CPreloader::Work( CJob & job )
+{
+    job.start = TClock::now();
+
+    try
+    {
+        job.publish = job.load();
+    }
+    catch( ... )
+    {
+        lock_guard<mutex> lock( _mutex );
+        if( !_pError )
+            _pError = current_exception();
+    }
+
+    job.end = TClock::now();
+
+    // The progress loop wakes on its own interval, so it's only woken early
+    // for the last job.
+    bool allDone = false;
+    {
+        lock_guard<mutex> lock( _mutex );
+        allDone = (++_doneCount == _jobList.size());
+    }
+
+    if( allDone )
+        _doneCondition.notify_one();
+}
\ No newline at end of file
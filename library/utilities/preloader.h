@@ -0,0 +1,156 @@
+#ifndef __preloader_h__
+#define __preloader_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+
+// Standard lib dependencies
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+/// *************************************************************************
+/// <summary>
+/// How long a category of data took to preload.
+/// </summary>
+/// *************************************************************************
+class CPreloadTiming
+{
+public:
+
+    // Category of data.
+    std::string category;
+
+    // Number of files loaded.
+    uint count = 0;
+
+    // Wall clock time in seconds from the first file starting to the last
+    // one finishing.
+    float seconds = 0;
+};
+
+/// *************************************************************************
+/// <summary>
+/// Class to load the data files of the managers up front, instead of on
+/// first use. The managers add a job for each file they haven't loaded.
+/// The jobs parse the files on a thread pool into new data objects, and
+/// the objects are published into the managers' maps in one step on the
+/// calling thread once every file has been read.
+/// </summary>
+/// *************************************************************************
+class CPreloader
+{
+public:
+
+    // Called on the calling thread as files finish loading.
+    typedef std::function<void( uint doneCount, uint totalCount )> TProgressCallback;
+
+    // Run on a worker to load a file. Returns the step that publishes the
+    // loaded data, which is run on the calling thread.
+    typedef std::function<std::function<void()>()> TLoadJob;
+
+    // Preload the data files of every manager.
+    static std::vector<CPreloadTiming> PreloadAll( TProgressCallback callback = nullptr );
+
+    // Add a job to load a file.
+    void Add( const std::string & category, TLoadJob job );
+
+    // Add a job for each file in the list that isn't loaded yet.
+    template <class T>
+    void Add( const std::string & category,
+              const std::map<const std::string, const std::string> & fileList,
+              std::map<const std::string, T *> & loadedList,
+              std::function<T *( const std::string & name, const std::string & filePath )> load );
+
+    // Run the jobs and publish the data they loaded.
+    std::vector<CPreloadTiming> Run( TProgressCallback callback = nullptr );
+
+private:
+
+    typedef std::chrono::steady_clock TClock;
+
+    /// *************************************************************************
+    /// <summary>
+    /// A file to load and what became of it.
+    /// </summary>
+    /// *************************************************************************
+    class CJob
+    {
+    public:
+
+        std::string category;
+        TLoadJob load;
+
+        // Set by the worker.
+        std::function<void()> publish;
+        TClock::time_point start, end;
+    };
+
+    // Run the job on a worker.
+    void Work( CJob & job );
+
+private:
+
+    // Jobs in the order they were added.
+    std::vector<CJob> _jobList;
+
+    // Number of jobs the workers have finished.
+    uint _doneCount = 0;
+
+    // The first error a job threw. Thrown again once the rest are published.
+    std::exception_ptr _pError;
+
+    // Guards the done count and the error.
+    std::mutex _mutex;
+
+    // Signalled when the last job finishes.
+    std::condition_variable _doneCondition;
+};
+
+
+/// *************************************************************************
+/// <summary>
+/// Add a job for each file in the list that isn't loaded yet. The job loads
+/// the file with the passed in function, and the data is added to the
+/// loaded list unless something loaded it first.
+/// </summary>
+/// <param name="category"> Category the files are timed under. </param>
+/// <param name="fileList"> Names and paths of the files. </param>
+/// <param name="loadedList"> Map the data is published into. </param>
+/// <param name="load"> Function to load a file into a new object. Must be
+/// safe to call from a worker thread. </param>
+/// *************************************************************************
+template <class T>
+void CPreloader::Add( const std::string & category,
+                      const std::map<const std::string, const std::string> & fileList,
+                      std::map<const std::string, T *> & loadedList,
+                      std::function<T *( const std::string & name, const std::string & filePath )> load )
+{
+    for( auto & kv : fileList )
+    {
+        if( loadedList.find( kv.first ) != loadedList.end() )
+            continue;
+
+        std::string name = kv.first;
+        std::string filePath = kv.second;
+        std::map<const std::string, T *> * pLoadedList = &loadedList;
+
+        Add( category, [name, filePath, pLoadedList, load]() -> std::function<void()>
+        {
+            T * pData = load( name, filePath );
+
+            return [name, pData, pLoadedList]()
+            {
+                if( pData && !pLoadedList->emplace( name, pData ).second )
+                    delete pData;
+            };
+        } );
+    }
+}
+
+#endif  // __preloader_h__
@@ -5,10 +5,9 @@
 #include <agk.h>
 #include <utilities\jsonparsehelper.h>
 #include <utilities\exceptionhandling.h>
+#include <utilities\arena.h>
 #include <managers\spritemanager.h>
-
-// Standard lib dependencies
-#include <fstream>
+#include <utilities\datafile.h>
 
 using namespace nlohmann;
 using namespace std;
@@ -57,12 +56,13 @@ void CSettings::LoadSettings()
 {
     try
     {
-        // Load the settings file.
-        ifstream ifile( _path );
+        // Parse the settings file into a json object, built in an arena and
+        // freed with it in one go. The file is read out of the archive if
+        // it's packed.
+        CArenaScope arenaScope;
 
-        // Parse the content into a json object.
         json j;
-        ifile >> j;
+        CDataFile( _path ).GetJson( j );
 
         auto settingsIter = j.find( "settings" );
         if( settingsIter != j.end() )
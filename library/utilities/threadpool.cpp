@@ -0,0 +1,119 @@
+// Physical component dependency
+#include "threadpool.h"
+
+using namespace std;
+
+/// *************************************************************************
+/// <summary>
+/// Constructor
+/// </summary>
+/// <param name="threadCount"> Number of workers. Zero uses one less than the
+/// number of cores, leaving one for the main thread. </param>
+/// *************************************************************************
+CThreadPool::CThreadPool( uint threadCount )
+{
+    if( threadCount == 0 )
+    {
+        uint cores = thread::hardware_concurrency();
+        threadCount = (cores > 1) ? cores - 1 : 1;
+    }
+
+    _threadList.reserve( threadCount );
+    for( uint i = 0; i < threadCount; ++i )
+        _threadList.emplace_back( &CThreadPool::Work, this );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Destructor
+/// </summary>
+/// *************************************************************************
+CThreadPool::~CThreadPool()
+{
+    {
+        lock_guard<mutex> lock( _mutex );
+        _stop = true;
+    }
+
+    _jobCondition.notify_all();
+
+    for( auto & worker : _threadList )
+        worker.join();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Queue a job to be run by the next free worker.
+/// </summary>
+/// <param name="job"> The job to run. </param>
+/// *************************************************************************
+void CThreadPool::Add( TJob job )
+{
+    {
+        lock_guard<mutex> lock( _mutex );
+        _jobList.push_back( move( job ) );
+    }
+
+    _jobCondition.notify_one();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Block until all of the queued jobs have finished.
+/// </summary>
+/// *************************************************************************
+void CThreadPool::WaitAll()
+{
+    unique_lock<mutex> lock( _mutex );
+    _doneCondition.wait( lock, [this]{ return _jobList.empty() && (_activeCount == 0); } );
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the number of worker threads.
+/// </summary>
+/// *************************************************************************
+uint CThreadPool::GetThreadCount() const
+{
+    return (uint)_threadList.size();
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// The loop each worker runs. Takes the next job off the queue and runs it
+/// until the pool is stopped and the queue is empty.
+/// </summary>
+/// *************************************************************************
+void CThreadPool::Work()
+{
+    while( true )
+    {
+        TJob job;
+
+        {
+            unique_lock<mutex> lock( _mutex );
+            _jobCondition.wait( lock, [this]{ return _stop || !_jobList.empty(); } );
+
+            if( _jobList.empty() )
+                return;
+
+            job = move( _jobList.front() );
+            _jobList.pop_front();
+            ++_activeCount;
+        }
+
+        job();
+
+        {
+            lock_guard<mutex> lock( _mutex );
+            --_activeCount;
+        }
+
+        _doneCondition.notify_all();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef __thread_pool_h__
+#define __thread_pool_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+
+// Standard lib dependencies
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/// *************************************************************************
+/// <summary>
+/// Class to run jobs on a fixed set of worker threads. Jobs are started in
+/// the order they're added. The jobs must not call into AGK, which is only
+/// safe to use from the main thread.
+/// </summary>
+/// *************************************************************************
+class CThreadPool
+{
+public:
+
+    // Function run by a worker.
+    typedef std::function<void()> TJob;
+
+    // Constructor. Zero threads uses one less than the number of cores.
+    CThreadPool( uint threadCount = 0 );
+
+    // Destructor. Finishes the queued jobs before the workers are stopped.
+    ~CThreadPool();
+
+    // Queue a job to be run by the next free worker.
+    void Add( TJob job );
+
+    // Block until all of the queued jobs have finished.
+    void WaitAll();
+
+    // Get the number of worker threads.
+    uint GetThreadCount() const;
+
+private:
+
+    // The loop each worker runs.
+    void Work();
+
+private:
+
+    // The worker threads.
+    std::vector<std::thread> _threadList;
+
+    // Jobs waiting for a worker.
+    std::deque<TJob> _jobList;
+
+    // Number of jobs the workers are running.
+    uint _activeCount = 0;
+
+    // Whether the workers should stop once the queue is empty.
+    bool _stop = false;
+
+    // Guards the job list, active count and stop flag.
+    std::mutex _mutex;
+
+    // Signalled when a job is added or the workers should stop.
+    std::condition_variable _jobCondition;
+
+    // Signalled when a worker finishes a job.
+    std::condition_variable _doneCondition;
+};
+
+#endif  // __thread_pool_h__
\ No newline at end of file
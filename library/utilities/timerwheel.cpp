@@ -0,0 +1,205 @@
+// Physical component dependency
+#include "timerwheel.h"
+
+using namespace std;
+
+namespace
+{
+    // Number of ticks each level of the wheel covers.
+    uint64_t GetLevelRange( uint level )
+    {
+        return uint64_t( 1 ) << (CTimerWheel::SLOT_BITS * level);
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Constructor
+/// </summary>
+/// *************************************************************************
+CTimerWheel::CTimerWheel()
+{
+    for( auto & level : _pSlotList )
+        for( auto & pSlot : level )
+            pSlot = nullptr;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Schedule the timer to be due in a number of ticks. A timer that's
+/// already scheduled is moved.
+/// </summary>
+/// <param name="timer"> The timer to schedule. </param>
+/// <param name="delay"> Number of ticks until the timer is due. At least one,
+/// since the current tick has already been handled. </param>
+/// *************************************************************************
+void CTimerWheel::Schedule( CTimer & timer, uint64_t delay )
+{
+    Cancel( timer );
+
+    timer._due = _time + (delay ? delay : 1);
+    Insert( timer );
+    ++_count;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Take the timer off the wheel. Does nothing if it isn't scheduled.
+/// </summary>
+/// *************************************************************************
+void CTimerWheel::Cancel( CTimer & timer )
+{
+    if( !timer.IsScheduled() )
+        return;
+
+    Unlink( timer );
+    --_count;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Advance the wheel a tick at a time. The timers of the higher levels are
+/// moved down whenever the level below comes around, then everything in
+/// the lowest level's slot is due.
+/// </summary>
+/// <param name="ticks"> Number of ticks to advance. </param>
+/// <param name="pDueList"> List to add the timers that came due to. They're
+/// off the wheel, so they can be scheduled again. </param>
+/// *************************************************************************
+void CTimerWheel::Advance( uint64_t ticks, vector<CTimer *> & pDueList )
+{
+    // Timers are placed relative to the current tick, so an empty wheel can skip ahead.
+    if( _count == 0 )
+    {
+        _time += ticks;
+        return;
+    }
+
+    for( uint64_t i = 0; (i < ticks) && (_count > 0); ++i )
+    {
+        ++_time;
+
+        for( uint level = 1; level < LEVEL_COUNT; ++level )
+        {
+            if( (_time & (GetLevelRange( level ) - 1)) != 0 )
+                break;
+
+            Cascade( level );
+        }
+
+        CTimer *& pSlot = _pSlotList[0][_time & (SLOT_COUNT - 1)];
+        while( pSlot )
+        {
+            CTimer * pTimer = pSlot;
+            Unlink( *pTimer );
+            --_count;
+
+            pDueList.push_back( pTimer );
+        }
+
+        // The rest of the ticks can be skipped once the wheel is empty.
+        if( _count == 0 )
+            _time += ticks - i - 1;
+    }
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the current tick.
+/// </summary>
+/// *************************************************************************
+uint64_t CTimerWheel::GetTime() const
+{
+    return _time;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Get the number of timers on the wheel.
+/// </summary>
+/// *************************************************************************
+uint CTimerWheel::GetCount() const
+{
+    return _count;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Link the timer into the slot for its due tick, on the lowest level that
+/// reaches that far. Timers past the top level go in its furthest slot and
+/// are placed again when it comes around.
+/// </summary>
+/// *************************************************************************
+void CTimerWheel::Insert( CTimer & timer )
+{
+    uint64_t delay = timer._due - _time;
+
+    uint level = 0;
+    while( (level < LEVEL_COUNT - 1) && (delay >= GetLevelRange( level + 1 )) )
+        ++level;
+
+    uint64_t due = timer._due;
+    if( delay >= GetLevelRange( LEVEL_COUNT ) )
+        due = _time + GetLevelRange( LEVEL_COUNT ) - 1;
+
+    CTimer *& pSlot = _pSlotList[level][(due >> (SLOT_BITS * level)) & (SLOT_COUNT - 1)];
+
+    timer._pPrev = nullptr;
+    timer._pNext = pSlot;
+    timer._ppSlot = &pSlot;
+
+    if( pSlot )
+        pSlot->_pPrev = &timer;
+
+    pSlot = &timer;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Unlink the timer from its slot.
+/// </summary>
+/// *************************************************************************
+void CTimerWheel::Unlink( CTimer & timer )
+{
+    if( timer._pPrev )
+        timer._pPrev->_pNext = timer._pNext;
+    else
+        *timer._ppSlot = timer._pNext;
+
+    if( timer._pNext )
+        timer._pNext->_pPrev = timer._pPrev;
+
+    timer._pNext = nullptr;
+    timer._pPrev = nullptr;
+    timer._ppSlot = nullptr;
+}
+
+
+/// *************************************************************************
+/// <summary>
+/// Move the timers in a level's current slot down to the levels below.
+/// </summary>
+/// <param name="level"> The level to cascade. </param>
+/// *************************************************************************
+void CTimerWheel::Cascade( uint level )
+{
+    CTimer *& pSlot = _pSlotList[level][(_time >> (SLOT_BITS * level)) & (SLOT_COUNT - 1)];
+
+    CTimer * pTimer = pSlot;
+    pSlot = nullptr;
+
+    while( pTimer )
+    {
+        CTimer * pNext = pTimer->_pNext;
+        Insert( *pTimer );
+        pTimer = pNext;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#ifndef __timer_wheel_h__
+#define __timer_wheel_h__
+
+// Game lib dependencies
+#include <common\defs.h>
+
+// Standard lib dependencies
+#include <vector>
+#include <cstdint>
+
+/// *************************************************************************
+/// <summary>
+/// Class to keep timers in a hierarchical wheel. The lowest level has a slot
+/// for each of the next few ticks, and each level above covers a slot's
+/// worth of the level below it. Timers are moved down a level as their time
+/// gets close, so scheduling, cancelling and advancing don't depend on how
+/// many timers are waiting. Timers belong to the caller, the wheel only
+/// links them together.
+/// </summary>
+/// *************************************************************************
+class CTimerWheel
+{
+public:
+
+    // Each level has 2^SLOT_BITS slots.
+    static const uint SLOT_BITS = 6;
+    static const uint SLOT_COUNT = 1 << SLOT_BITS;
+    static const uint LEVEL_COUNT = 4;
+
+    /// *************************************************************************
+    /// <summary>
+    /// A timer to schedule on the wheel. Derive from it to carry data.
+    /// </summary>
+    /// *************************************************************************
+    class CTimer
+    {
+    public:
+
+        // Whether the timer is on a wheel.
+        bool IsScheduled() const
+        {
+            return _ppSlot != nullptr;
+        }
+
+    private:
+
+        friend class CTimerWheel;
+
+        // Neighbours in the slot's list.
+        CTimer * _pNext = nullptr;
+        CTimer * _pPrev = nullptr;
+
+        // Head of the slot's list the timer is in.
+        CTimer ** _ppSlot = nullptr;
+
+        // Tick the timer is due on.
+        uint64_t _due = 0;
+    };
+
+    // Constructor
+    CTimerWheel();
+
+    // Schedule the timer to be due in a number of ticks.
+    void Schedule( CTimer & timer, uint64_t delay );
+
+    // Take the timer off the wheel.
+    void Cancel( CTimer & timer );
+
+    // Advance the wheel, adding the timers that come due to the list.
+    void Advance( uint64_t ticks, std::vector<CTimer *> & pDueList );
+
+    // Get the current tick.
+    uint64_t GetTime() const;
+
+    // Get the number of timers on the wheel.
+    uint GetCount() const;
+
+private:
+
+    // Link the timer into the slot for its due tick.
+    void Insert( CTimer & timer );
+
+    // Unlink the timer from its slot.
+    void Unlink( CTimer & timer );
+
+    // Move the timers in a level's current slot down to the levels below.
+    void Cascade( uint level );
+
+private:
+
+    // Head of each slot's list of timers.
+    CTimer * _pSlotList[LEVEL_COUNT][SLOT_COUNT];
+
+    // The current tick.
+    uint64_t _time = 0;
+
+    // Number of timers on the wheel.
+    uint _count = 0;
+};
+
+#endif  // __timer_wheel_h__
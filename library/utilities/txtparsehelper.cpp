@@ -43,6 +43,7 @@ namespace NParseHelper
                                                            "A file using the name '" + name + "' already exists." );
 
                     CResourceFile resource( UNLOADED_SUBIMAGE_ID, parentName );
+                    resource.subImage = true;
                     imageList.emplace( name, resource );
                 }
             }
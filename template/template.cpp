@@ -3,10 +3,14 @@
 
 // Game lib dependencies
 #include <utilities\settings.h>
+#include <utilities\archive.h>
+#include <utilities\manifestcache.h>
+#include <utilities\preloader.h>
 #include <managers\inputmanager.h>
 #include <managers\spritemanager.h>
 #include <managers\resourcemanager.h>
 #include <managers\scriptmanager.h>
+#include <managers\animationmanager.h>
 #include <script\scriptglobals.h>
 #include <script\scriptcolor.h>
 #include <script\scriptvector3.h>
@@ -14,6 +18,7 @@
 #include <3d\sprite3d.h>
 #include <2d\sprite2d.h>
 #include <2d\textsprite.h>
+#include <common\commandbuffer.h>
 
 // AngelScript lib dependencies
 #include <scriptstdstring/scriptstdstring.h>
@@ -34,6 +39,10 @@ vector<iObject *> pObjectList;
 
 void app::Init()
 {
+    // Read the data files out of the packed archive, if the game ships with one.
+    // Opened first so the settings and inputs can be packed too.
+    CArchive::Instance().Open( "data.pak" );
+
     // Load and apply the settings.
     CSettings::Instance().SetPath( "data/settings.json" );
     CSettings::Instance().LoadSettings();
@@ -43,6 +52,9 @@ void app::Init()
     CInputManager::Instance().SetPath( "data/inputs.json" );
     CInputManager::Instance().LoadInputMap();
 
+    // Restore the folder listings that haven't changed since the last run.
+    CManifestCache::Instance().Load( "manifest.cache" );
+
     // Load all of our lists.
     CResourceManager::Instance().LoadImageList( "data/images/" );
     CResourceManager::Instance().LoadFontList( "data/fonts/" );
@@ -53,6 +65,12 @@ void app::Init()
     CScriptManager::Instance().LoadScriptList( "data/scripts" );
     CScriptManager::Instance().LoadAnimationDataFileList( "data/animations" );
 
+    // Remember the folders that had to be scanned for the next run.
+    CManifestCache::Instance().Save();
+
+    // Parse all of the data files up front on a thread pool.
+    CPreloader::PreloadAll();
+
     RegisterStdString( CScriptManager::Instance().GetEnginePtr() );
     RegisterScriptArray( CScriptManager::Instance().GetEnginePtr(), false );
     NScriptGlobals::Register( CScriptManager::Instance().GetEnginePtr() );
@@ -61,6 +79,9 @@ void app::Init()
 
     CAnimation::Register( CScriptManager::Instance().GetEnginePtr() );
 
+    // Skip compiling the scripts if nothing changed since the last run.
+    CScriptManager::Instance().SetByteCodeCachePath( "scripts" );
+
     CScriptManager::Instance().LoadScript( "defs" );
     CScriptManager::Instance().LoadScript( "general" );
     CScriptManager::Instance().LoadScript( "controls" );
@@ -109,10 +130,20 @@ int app::Loop()
             pPawPrint->Play( "color", NDefs::EST_BREAK );
     }
 
+    // Finish the background loads that are ready, within the frame's budget.
+    CResourceManager::Instance().Update();
+
+    // Wake the scripts that are done waiting before the animations run them.
+    CScriptManager::Instance().Update();
+
     CSpriteManager::Instance().Update();
+    CAnimationManager::Instance().Update();
     CSpriteManager::Instance().Transform();
 
 	agk::Print( agk::ScreenFPS() );
+
+    // Send the frame's transformations to AGK before drawing.
+    CCommandBuffer::Instance().Flush();
 	agk::Sync();
 
 	return 0; // return 1 to close app